@@ -0,0 +1,534 @@
+#include "AABBTree.h"
+#include <algorithm>
+
+namespace Engine
+{
+	AABBTree::AABBTree(float margin)
+		:m_Root(NullNode)
+		, m_FreeList(NullNode)
+		, m_Margin(margin)
+	{
+	}
+
+	int AABBTree::CreateProxy(const AABB& box, void* userData)
+	{
+		int proxyId = AllocateNode();
+
+		// Fatten the box so small movements don't need a reinsertion
+		Vector3 margin(m_Margin, m_Margin, m_Margin);
+		m_Nodes[proxyId].m_Box = AABB(box.m_Min - margin, box.m_Max + margin);
+		m_Nodes[proxyId].m_UserData = userData;
+
+		InsertLeaf(proxyId);
+		return proxyId;
+	}
+
+	void AABBTree::DestroyProxy(int proxyId)
+	{
+		RemoveLeaf(proxyId);
+		FreeNode(proxyId);
+	}
+
+	bool AABBTree::MoveProxy(int proxyId, const AABB& box)
+	{
+		// Still inside the fat box, and the fat box isn't way too big
+		// (e.g. the object shrank, or it was created before it had a real box)
+		const AABB& fatBox = m_Nodes[proxyId].m_Box;
+		Vector3 maxMargin(4.0f * m_Margin, 4.0f * m_Margin, 4.0f * m_Margin);
+		AABB hugeBox(box.m_Min - maxMargin, box.m_Max + maxMargin);
+		if (BoxContains(fatBox, box) && BoxContains(hugeBox, fatBox))
+		{
+			return false;
+		}
+
+		RemoveLeaf(proxyId);
+
+		Vector3 margin(m_Margin, m_Margin, m_Margin);
+		m_Nodes[proxyId].m_Box = AABB(box.m_Min - margin, box.m_Max + margin);
+
+		InsertLeaf(proxyId);
+		return true;
+	}
+
+	void AABBTree::Rebuild()
+	{
+		// Keep the leaves, free everything else
+		m_Leaves.clear();
+		for (size_t i = 0; i < m_Nodes.size(); i++)
+		{
+			if (m_Nodes[i].m_Height == 0)
+			{
+				m_Leaves.emplace_back(static_cast<int>(i));
+			}
+			else if (m_Nodes[i].m_Height > 0)
+			{
+				FreeNode(static_cast<int>(i));
+			}
+		}
+
+		if (m_Leaves.empty())
+		{
+			m_Root = NullNode;
+			return;
+		}
+
+		m_Root = BuildSAH(m_Leaves, 0, m_Leaves.size());
+		m_Nodes[m_Root].m_Parent = NullNode;
+	}
+
+	int AABBTree::AllocateNode()
+	{
+		int node;
+		if (m_FreeList != NullNode)
+		{
+			node = m_FreeList;
+			m_FreeList = m_Nodes[node].m_Parent;
+			m_Nodes[node] = Node();
+		}
+		else
+		{
+			node = static_cast<int>(m_Nodes.size());
+			m_Nodes.emplace_back();
+		}
+		return node;
+	}
+
+	void AABBTree::FreeNode(int node)
+	{
+		m_Nodes[node].m_Parent = m_FreeList;
+		m_Nodes[node].m_Height = -1;
+		m_FreeList = node;
+	}
+
+	void AABBTree::InsertLeaf(int leaf)
+	{
+		if (m_Root == NullNode)
+		{
+			m_Root = leaf;
+			m_Nodes[leaf].m_Parent = NullNode;
+			return;
+		}
+
+		// Find the best sibling by walking down the cheaper side,
+		// where cost is the surface area the insertion adds to the tree
+		AABB leafBox = m_Nodes[leaf].m_Box;
+		int index = m_Root;
+		while (!m_Nodes[index].IsLeaf())
+		{
+			const Node& node = m_Nodes[index];
+			float area = SurfaceArea(node.m_Box);
+			float combinedArea = SurfaceArea(Combine(node.m_Box, leafBox));
+
+			// Cost of making a new parent for this node and the leaf
+			float cost = 2.0f * combinedArea;
+			// Minimum cost of pushing the leaf further down the tree
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			float childCost[2];
+			int children[2] = { node.m_Child1, node.m_Child2 };
+			for (int i = 0; i < 2; i++)
+			{
+				const Node& child = m_Nodes[children[i]];
+				float childArea = SurfaceArea(Combine(child.m_Box, leafBox));
+				if (!child.IsLeaf())
+				{
+					childArea -= SurfaceArea(child.m_Box);
+				}
+				childCost[i] = childArea + inheritanceCost;
+			}
+
+			// Cheaper to stop here?
+			if (cost < childCost[0] && cost < childCost[1])
+			{
+				break;
+			}
+			index = childCost[0] < childCost[1] ? children[0] : children[1];
+		}
+		int sibling = index;
+
+		// Create a new parent for the sibling and the leaf
+		int oldParent = m_Nodes[sibling].m_Parent;
+		int newParent = AllocateNode();
+		m_Nodes[newParent].m_Parent = oldParent;
+		m_Nodes[newParent].m_Box = Combine(leafBox, m_Nodes[sibling].m_Box);
+		m_Nodes[newParent].m_Height = m_Nodes[sibling].m_Height + 1;
+		m_Nodes[newParent].m_Child1 = sibling;
+		m_Nodes[newParent].m_Child2 = leaf;
+		m_Nodes[sibling].m_Parent = newParent;
+		m_Nodes[leaf].m_Parent = newParent;
+
+		if (oldParent != NullNode)
+		{
+			if (m_Nodes[oldParent].m_Child1 == sibling)
+			{
+				m_Nodes[oldParent].m_Child1 = newParent;
+			}
+			else
+			{
+				m_Nodes[oldParent].m_Child2 = newParent;
+			}
+		}
+		else
+		{
+			m_Root = newParent;
+		}
+
+		Refit(m_Nodes[leaf].m_Parent);
+	}
+
+	void AABBTree::RemoveLeaf(int leaf)
+	{
+		if (leaf == m_Root)
+		{
+			m_Root = NullNode;
+			return;
+		}
+
+		int parent = m_Nodes[leaf].m_Parent;
+		int grandParent = m_Nodes[parent].m_Parent;
+		int sibling = m_Nodes[parent].m_Child1 == leaf ?
+			m_Nodes[parent].m_Child2 : m_Nodes[parent].m_Child1;
+
+		// The sibling takes the place of the parent
+		if (grandParent != NullNode)
+		{
+			if (m_Nodes[grandParent].m_Child1 == parent)
+			{
+				m_Nodes[grandParent].m_Child1 = sibling;
+			}
+			else
+			{
+				m_Nodes[grandParent].m_Child2 = sibling;
+			}
+			m_Nodes[sibling].m_Parent = grandParent;
+			FreeNode(parent);
+
+			Refit(grandParent);
+		}
+		else
+		{
+			m_Root = sibling;
+			m_Nodes[sibling].m_Parent = NullNode;
+			FreeNode(parent);
+		}
+	}
+
+	void AABBTree::Refit(int node)
+	{
+		while (node != NullNode)
+		{
+			node = Balance(node);
+
+			int child1 = m_Nodes[node].m_Child1;
+			int child2 = m_Nodes[node].m_Child2;
+			m_Nodes[node].m_Height = 1 + CustomMath::Max(m_Nodes[child1].m_Height, m_Nodes[child2].m_Height);
+			m_Nodes[node].m_Box = Combine(m_Nodes[child1].m_Box, m_Nodes[child2].m_Box);
+
+			node = m_Nodes[node].m_Parent;
+		}
+	}
+
+	int AABBTree::Balance(int iA)
+	{
+		Node& A = m_Nodes[iA];
+		if (A.IsLeaf() || A.m_Height < 2)
+		{
+			return iA;
+		}
+
+		int iB = A.m_Child1;
+		int iC = A.m_Child2;
+		Node& B = m_Nodes[iB];
+		Node& C = m_Nodes[iC];
+		int balance = C.m_Height - B.m_Height;
+
+		// Rotate C up
+		if (balance > 1)
+		{
+			int iF = C.m_Child1;
+			int iG = C.m_Child2;
+			Node& F = m_Nodes[iF];
+			Node& G = m_Nodes[iG];
+
+			// Swap A and C
+			C.m_Child1 = iA;
+			C.m_Parent = A.m_Parent;
+			A.m_Parent = iC;
+
+			// A's old parent should point to C
+			if (C.m_Parent != NullNode)
+			{
+				if (m_Nodes[C.m_Parent].m_Child1 == iA)
+				{
+					m_Nodes[C.m_Parent].m_Child1 = iC;
+				}
+				else
+				{
+					m_Nodes[C.m_Parent].m_Child2 = iC;
+				}
+			}
+			else
+			{
+				m_Root = iC;
+			}
+
+			// Keep the taller of F/G under C
+			if (F.m_Height > G.m_Height)
+			{
+				C.m_Child2 = iF;
+				A.m_Child2 = iG;
+				G.m_Parent = iA;
+				A.m_Box = Combine(B.m_Box, G.m_Box);
+				C.m_Box = Combine(A.m_Box, F.m_Box);
+				A.m_Height = 1 + CustomMath::Max(B.m_Height, G.m_Height);
+				C.m_Height = 1 + CustomMath::Max(A.m_Height, F.m_Height);
+			}
+			else
+			{
+				C.m_Child2 = iG;
+				A.m_Child2 = iF;
+				F.m_Parent = iA;
+				A.m_Box = Combine(B.m_Box, F.m_Box);
+				C.m_Box = Combine(A.m_Box, G.m_Box);
+				A.m_Height = 1 + CustomMath::Max(B.m_Height, F.m_Height);
+				C.m_Height = 1 + CustomMath::Max(A.m_Height, G.m_Height);
+			}
+
+			return iC;
+		}
+
+		// Rotate B up
+		if (balance < -1)
+		{
+			int iD = B.m_Child1;
+			int iE = B.m_Child2;
+			Node& D = m_Nodes[iD];
+			Node& E = m_Nodes[iE];
+
+			// Swap A and B
+			B.m_Child1 = iA;
+			B.m_Parent = A.m_Parent;
+			A.m_Parent = iB;
+
+			// A's old parent should point to B
+			if (B.m_Parent != NullNode)
+			{
+				if (m_Nodes[B.m_Parent].m_Child1 == iA)
+				{
+					m_Nodes[B.m_Parent].m_Child1 = iB;
+				}
+				else
+				{
+					m_Nodes[B.m_Parent].m_Child2 = iB;
+				}
+			}
+			else
+			{
+				m_Root = iB;
+			}
+
+			// Keep the taller of D/E under B
+			if (D.m_Height > E.m_Height)
+			{
+				B.m_Child2 = iD;
+				A.m_Child1 = iE;
+				E.m_Parent = iA;
+				A.m_Box = Combine(C.m_Box, E.m_Box);
+				B.m_Box = Combine(A.m_Box, D.m_Box);
+				A.m_Height = 1 + CustomMath::Max(C.m_Height, E.m_Height);
+				B.m_Height = 1 + CustomMath::Max(A.m_Height, D.m_Height);
+			}
+			else
+			{
+				B.m_Child2 = iE;
+				A.m_Child1 = iD;
+				D.m_Parent = iA;
+				A.m_Box = Combine(C.m_Box, D.m_Box);
+				B.m_Box = Combine(A.m_Box, E.m_Box);
+				A.m_Height = 1 + CustomMath::Max(C.m_Height, D.m_Height);
+				B.m_Height = 1 + CustomMath::Max(A.m_Height, E.m_Height);
+			}
+
+			return iB;
+		}
+
+		return iA;
+	}
+
+	int AABBTree::BuildSAH(std::vector<int>& leaves, size_t begin, size_t end)
+	{
+		if (end - begin == 1)
+		{
+			return leaves[begin];
+		}
+
+		// Bounds of the box centers, to pick the split axis
+		AABB centerBounds(Vector3::Infinity, Vector3::NegInfinity);
+		for (size_t i = begin; i < end; i++)
+		{
+			const AABB& box = m_Nodes[leaves[i]].m_Box;
+			centerBounds.UpdateMinMax((box.m_Min + box.m_Max) * 0.5f);
+		}
+		Vector3 extents = centerBounds.m_Max - centerBounds.m_Min;
+		int axis = 0;
+		if (extents.y > extents.x)
+		{
+			axis = 1;
+		}
+		if (extents.z > (&extents.x)[axis])
+		{
+			axis = 2;
+		}
+		const float axisMin = (&centerBounds.m_Min.x)[axis];
+		const float axisExtent = (&extents.x)[axis];
+
+		size_t mid = begin + (end - begin) / 2;
+		if (axisExtent > 0.0f)
+		{
+			// Sort the boxes into bins along the axis
+			const int BinCount = 16;
+			struct Bin
+			{
+				Bin() :m_Box(Vector3::Infinity, Vector3::NegInfinity), m_Count(0) {}
+				AABB m_Box;
+				int m_Count;
+			};
+			Bin bins[BinCount];
+			const float binScale = BinCount / axisExtent;
+			auto binIndex = [&](int node)
+			{
+				const AABB& box = m_Nodes[node].m_Box;
+				float center = ((&box.m_Min.x)[axis] + (&box.m_Max.x)[axis]) * 0.5f;
+				int bin = static_cast<int>((center - axisMin) * binScale);
+				return CustomMath::Clamp(bin, 0, BinCount - 1);
+			};
+			for (size_t i = begin; i < end; i++)
+			{
+				Bin& bin = bins[binIndex(leaves[i])];
+				bin.m_Box = Combine(bin.m_Box, m_Nodes[leaves[i]].m_Box);
+				bin.m_Count++;
+			}
+
+			// Area of everything right of each split, sweeping from the right
+			float rightArea[BinCount];
+			int rightCount[BinCount];
+			AABB rightBox(Vector3::Infinity, Vector3::NegInfinity);
+			int count = 0;
+			for (int i = BinCount - 1; i > 0; i--)
+			{
+				rightBox = Combine(rightBox, bins[i].m_Box);
+				count += bins[i].m_Count;
+				rightArea[i] = count > 0 ? SurfaceArea(rightBox) : 0.0f;
+				rightCount[i] = count;
+			}
+
+			// Then sweep from the left and keep the cheapest split
+			float bestCost = CustomMath::Infinity;
+			int bestSplit = -1;
+			AABB leftBox(Vector3::Infinity, Vector3::NegInfinity);
+			count = 0;
+			for (int i = 1; i < BinCount; i++)
+			{
+				leftBox = Combine(leftBox, bins[i - 1].m_Box);
+				count += bins[i - 1].m_Count;
+				if (count == 0 || rightCount[i] == 0)
+				{
+					continue;
+				}
+				float cost = count * SurfaceArea(leftBox) + rightCount[i] * rightArea[i];
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestSplit = i;
+				}
+			}
+
+			if (bestSplit != -1)
+			{
+				auto iter = std::partition(leaves.begin() + begin, leaves.begin() + end,
+					[&](int node) { return binIndex(node) < bestSplit; });
+				mid = iter - leaves.begin();
+			}
+		}
+
+		// All the centers in the same spot (or bin), just split the list in half
+		if (mid == begin || mid == end)
+		{
+			mid = begin + (end - begin) / 2;
+		}
+
+		int child1 = BuildSAH(leaves, begin, mid);
+		int child2 = BuildSAH(leaves, mid, end);
+
+		int node = AllocateNode();
+		m_Nodes[node].m_Child1 = child1;
+		m_Nodes[node].m_Child2 = child2;
+		m_Nodes[node].m_Box = Combine(m_Nodes[child1].m_Box, m_Nodes[child2].m_Box);
+		m_Nodes[node].m_Height = 1 + CustomMath::Max(m_Nodes[child1].m_Height, m_Nodes[child2].m_Height);
+		m_Nodes[child1].m_Parent = node;
+		m_Nodes[child2].m_Parent = node;
+		return node;
+	}
+
+	AABB AABBTree::Combine(const AABB& a, const AABB& b)
+	{
+		return AABB(Vector3(CustomMath::Min(a.m_Min.x, b.m_Min.x),
+				CustomMath::Min(a.m_Min.y, b.m_Min.y),
+				CustomMath::Min(a.m_Min.z, b.m_Min.z)),
+			Vector3(CustomMath::Max(a.m_Max.x, b.m_Max.x),
+				CustomMath::Max(a.m_Max.y, b.m_Max.y),
+				CustomMath::Max(a.m_Max.z, b.m_Max.z)));
+	}
+
+	float AABBTree::SurfaceArea(const AABB& box)
+	{
+		Vector3 d = box.m_Max - box.m_Min;
+		return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+	}
+
+	bool AABBTree::BoxContains(const AABB& outer, const AABB& inner)
+	{
+		return outer.m_Min.x <= inner.m_Min.x && outer.m_Min.y <= inner.m_Min.y &&
+			outer.m_Min.z <= inner.m_Min.z && outer.m_Max.x >= inner.m_Max.x &&
+			outer.m_Max.y >= inner.m_Max.y && outer.m_Max.z >= inner.m_Max.z;
+	}
+
+	bool AABBTree::SegmentEnters(const SegmentRay& ray, const AABB& box, float maxT, float& outT)
+	{
+		// Slab test, clipping [0, maxT] against each pair of planes
+		float tMin = 0.0f;
+		float tMax = maxT;
+		const float* start = &ray.m_Start.x;
+		const float* inv = &ray.m_InvDir.x;
+		const float* boxMin = &box.m_Min.x;
+		const float* boxMax = &box.m_Max.x;
+		for (int i = 0; i < 3; i++)
+		{
+			if (ray.m_Parallel[i])
+			{
+				// Parallel to the slab, so it has to start inside it
+				if (start[i] < boxMin[i] || start[i] > boxMax[i])
+				{
+					return false;
+				}
+			}
+			else
+			{
+				float t1 = (boxMin[i] - start[i]) * inv[i];
+				float t2 = (boxMax[i] - start[i]) * inv[i];
+				if (t1 > t2)
+				{
+					std::swap(t1, t2);
+				}
+				tMin = CustomMath::Max(tMin, t1);
+				tMax = CustomMath::Min(tMax, t2);
+				if (tMin > tMax)
+				{
+					return false;
+				}
+			}
+		}
+		outT = tMin;
+		return true;
+	}
+}
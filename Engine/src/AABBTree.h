@@ -0,0 +1,179 @@
+#pragma once
+#include <vector>
+#include "CustomMath.h"
+#include "Collision.h"
+
+namespace Engine
+{
+	// Dynamic bounding volume hierarchy of AABBs
+	// Leaves store "fat" boxes (the real box grown by a margin), so small
+	// movements only need a containment check instead of a reinsertion.
+	// Proxies are inserted/removed incrementally, and the whole tree can be
+	// rebuilt top-down with the surface area heuristic (SAH) once a lot of
+	// static geometry has been added.
+	class AABBTree
+	{
+	public:
+		// Proxy id returned for a null (invalid) proxy
+		static const int NullNode = -1;
+
+		AABBTree(float margin);
+
+		// Add/remove a box, userData is handed back by queries
+		int CreateProxy(const AABB& box, void* userData);
+		void DestroyProxy(int proxyId);
+		// Update the box of a proxy
+		// Returns true if the proxy had to be reinserted
+		bool MoveProxy(int proxyId, const AABB& box);
+
+		// Throw away all internal nodes and build them again with SAH
+		// Proxy ids stay the same
+		void Rebuild();
+
+		void* GetUserData(int proxyId) const { return m_Nodes[proxyId].m_UserData; }
+		const AABB& GetFatBox(int proxyId) const { return m_Nodes[proxyId].m_Box; }
+		int GetHeight() const { return m_Root == NullNode ? 0 : m_Nodes[m_Root].m_Height; }
+
+		// Visit the leaves hit by a line segment, nearest nodes first
+		// callback(int proxyId, float& closestT) is called for every leaf box the
+		// segment enters before closestT, and should lower closestT when it
+		// finds a closer hit (subtrees further than closestT are skipped)
+		template <typename Callback>
+		void SegmentCast(const LineSegment& l, Callback callback);
+	private:
+		struct Node
+		{
+			Node()
+				:m_Box(Vector3::Zero, Vector3::Zero)
+				, m_UserData(nullptr)
+				, m_Parent(NullNode)
+				, m_Child1(NullNode)
+				, m_Child2(NullNode)
+				, m_Height(0)
+			{
+			}
+			bool IsLeaf() const { return m_Child1 == NullNode; }
+
+			AABB m_Box;
+			void* m_UserData;
+			// Parent node, or next free node when in the free list
+			int m_Parent;
+			int m_Child1;
+			int m_Child2;
+			// Leaf = 0, free node = -1
+			int m_Height;
+		};
+
+		// Segment precomputed for the slab test
+		struct SegmentRay
+		{
+			Vector3 m_Start;
+			Vector3 m_InvDir;
+			bool m_Parallel[3];
+		};
+
+		int AllocateNode();
+		void FreeNode(int node);
+
+		void InsertLeaf(int leaf);
+		void RemoveLeaf(int leaf);
+		// Rotate the tree at node if it is unbalanced, returns the new subtree root
+		int Balance(int node);
+		// Recompute boxes and heights from node up to the root
+		void Refit(int node);
+
+		// Build a subtree from leaves[begin, end) and return its root
+		int BuildSAH(std::vector<int>& leaves, size_t begin, size_t end);
+
+		static AABB Combine(const AABB& a, const AABB& b);
+		static float SurfaceArea(const AABB& box);
+		static bool BoxContains(const AABB& outer, const AABB& inner);
+		// Entry t of the segment into box, if it enters before maxT
+		static bool SegmentEnters(const SegmentRay& ray, const AABB& box, float maxT, float& outT);
+
+		std::vector<Node> m_Nodes;
+		int m_Root;
+		int m_FreeList;
+		float m_Margin;
+
+		// Traversal stack reused between casts (node, entry t)
+		std::vector<std::pair<int, float>> m_Stack;
+		// Scratch list of leaves for rebuilds
+		std::vector<int> m_Leaves;
+	};
+
+	template <typename Callback>
+	void AABBTree::SegmentCast(const LineSegment& l, Callback callback)
+	{
+		if (m_Root == NullNode)
+		{
+			return;
+		}
+
+		SegmentRay ray;
+		ray.m_Start = l.m_Start;
+		Vector3 dir = l.m_End - l.m_Start;
+		const float* d = &dir.x;
+		float* inv = &ray.m_InvDir.x;
+		for (int i = 0; i < 3; i++)
+		{
+			ray.m_Parallel[i] = CustomMath::NearZero(d[i]);
+			inv[i] = ray.m_Parallel[i] ? 0.0f : 1.0f / d[i];
+		}
+
+		// Points on the segment are 0 <= t <= 1
+		float closestT = CustomMath::Infinity;
+		float t;
+		if (!SegmentEnters(ray, m_Nodes[m_Root].m_Box, 1.0f, t))
+		{
+			return;
+		}
+
+		m_Stack.clear();
+		m_Stack.emplace_back(m_Root, t);
+		while (!m_Stack.empty())
+		{
+			std::pair<int, float> entry = m_Stack.back();
+			m_Stack.pop_back();
+			// Something closer was found since this node was pushed
+			if (entry.second > closestT)
+			{
+				continue;
+			}
+
+			const Node& node = m_Nodes[entry.first];
+			if (node.IsLeaf())
+			{
+				callback(entry.first, closestT);
+				continue;
+			}
+
+			float maxT = CustomMath::Min(closestT, 1.0f);
+			float t1, t2;
+			bool hit1 = SegmentEnters(ray, m_Nodes[node.m_Child1].m_Box, maxT, t1);
+			bool hit2 = SegmentEnters(ray, m_Nodes[node.m_Child2].m_Box, maxT, t2);
+			// Push the far child first, so the near one is visited first
+			if (hit1 && hit2)
+			{
+				if (t1 <= t2)
+				{
+					m_Stack.emplace_back(node.m_Child2, t2);
+					m_Stack.emplace_back(node.m_Child1, t1);
+				}
+				else
+				{
+					m_Stack.emplace_back(node.m_Child1, t1);
+					m_Stack.emplace_back(node.m_Child2, t2);
+				}
+			}
+			else if (hit1)
+			{
+				m_Stack.emplace_back(node.m_Child1, t1);
+			}
+			else if (hit2)
+			{
+				m_Stack.emplace_back(node.m_Child2, t2);
+			}
+		}
+	}
+}
@@ -0,0 +1,102 @@
+#include "AStar.h"
+#include "PathGrid.h"
+#include <algorithm>
+
+namespace Engine
+{
+	AStar::AStar() :
+		m_Search(0),
+		m_NodesExpanded(0)
+	{
+	}
+
+	bool AStar::FindPath(const PathGrid& grid, int start, int goal, std::vector<int>& outPath)
+	{
+		outPath.clear();
+		m_NodesExpanded = 0;
+		const int cellCount = grid.GetCellCount();
+		if (start < 0 || goal < 0 || start >= cellCount || goal >= cellCount || grid.IsBlocked(goal))
+		{
+			return false;
+		}
+
+		Prepare(cellCount);
+
+		Node& first = m_Nodes[start];
+		first.m_G = 0.0f;
+		first.m_Parent = -1;
+		first.m_Search = m_Search;
+		first.m_Closed = false;
+		m_Open.Push(start, grid.Heuristic(start, goal));
+
+		int cells[8];
+		float costs[8];
+		bool found = false;
+		while (!m_Open.IsEmpty())
+		{
+			int current = m_Open.Pop();
+			m_Nodes[current].m_Closed = true;
+			m_NodesExpanded++;
+			if (current == goal)
+			{
+				found = true;
+				break;
+			}
+
+			const float currentG = m_Nodes[current].m_G;
+			int count = grid.GetNeighbors(current, cells, costs);
+			for (int i = 0; i < count; i++)
+			{
+				int neighbor = cells[i];
+				float g = currentG + costs[i];
+				Node& node = m_Nodes[neighbor];
+				if (!IsVisited(neighbor))
+				{
+					node.m_Search = m_Search;
+					node.m_Closed = false;
+				}
+				else if (node.m_Closed || g >= node.m_G)
+				{
+					// The heuristic is consistent, so closed cells already have their best g
+					continue;
+				}
+				node.m_G = g;
+				node.m_Parent = current;
+				// Adds it, or lowers its priority if it's already open
+				m_Open.Push(neighbor, g + grid.Heuristic(neighbor, goal));
+			}
+		}
+		m_Open.Clear();
+
+		if (found)
+		{
+			for (int cell = goal; cell != -1; cell = m_Nodes[cell].m_Parent)
+			{
+				outPath.emplace_back(cell);
+			}
+			std::reverse(outPath.begin(), outPath.end());
+		}
+		return found;
+	}
+
+	void AStar::Prepare(int cellCount)
+	{
+		if (static_cast<int>(m_Nodes.size()) != cellCount)
+		{
+			m_Nodes.assign(cellCount, Node{ 0.0f, -1, 0, false });
+			m_Open.Reserve(cellCount);
+			m_Search = 0;
+		}
+
+		m_Search++;
+		if (m_Search == 0)
+		{
+			// Wrapped around, old stamps could match again
+			for (auto& node : m_Nodes)
+			{
+				node.m_Search = 0;
+			}
+			m_Search = 1;
+		}
+	}
+}
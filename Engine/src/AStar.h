@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "IndexedHeap.h"
+
+namespace Engine
+{
+	class PathGrid;
+
+	// A* search over a PathGrid
+	// Keep one around and reuse it: the per cell search state is stamped with a
+	// search number, so starting a new search doesn't touch every cell
+	class AStar
+	{
+	public:
+		AStar();
+
+		// Fills outPath with the cells from start to goal (both included)
+		// Returns false (and leaves outPath empty) if there's no path
+		bool FindPath(const PathGrid& grid, int start, int goal, std::vector<int>& outPath);
+
+		// Cells taken off the open set by the last search
+		int GetNodesExpanded() const { return m_NodesExpanded; }
+	private:
+		void Prepare(int cellCount);
+		// Node state from an older search counts as unvisited
+		bool IsVisited(int cell) const { return m_Nodes[cell].m_Search == m_Search; }
+
+		struct Node
+		{
+			float m_G;
+			int m_Parent;
+			uint32_t m_Search;
+			bool m_Closed;
+		};
+		std::vector<Node> m_Nodes;
+		IndexedHeap m_Open;
+		uint32_t m_Search;
+		int m_NodesExpanded;
+	};
+}
@@ -4,6 +4,8 @@
 #include <SDL_log.h>
 #include <vector>
 #include "SoundEvent.h"
+#include "Game.h"
+#include "FrameArena.h"
 
 namespace
 {
@@ -88,8 +90,8 @@ namespace Engine
 
 	void AudioSystem::Update(float deltaTime)
 	{
-		// Find any stopped event instances
-		std::vector<unsigned int> done;
+		// Find any stopped event instances (ids kept in frame memory)
+		FrameVector<unsigned int> done(m_Game->GetFrameArena());
 		for (auto& iter : m_EventInstances)
 		{
 			FMOD::Studio::EventInstance* e = iter.second;
@@ -200,16 +200,17 @@ void AABB::Rotate(const Quaternion& q)
 	// Max point corner
 	points[7] = Vector3(m_Max);
 
-	// Rotate first point
-	Vector3 p = Vector3::Transform(points[0], q);
+	// Rotate all the points in one batch
+	// (one quaternion to matrix conversion instead of one per corner)
+	Matrix4 rotation = Matrix4::CreateFromQuaternion(q);
+	Vector3::TransformPoints(points.data(), points.size(), rotation, points.data());
 	// Reset min/max to first point rotated
-	m_Min = p;
-	m_Max = p;
-	// Update min/max based on remaining points, rotated
+	m_Min = points[0];
+	m_Max = points[0];
+	// Update min/max based on remaining points
 	for (size_t i = 1; i < points.size(); i++)
 	{
-		p = Vector3::Transform(points[i], q);
-		UpdateMinMax(p);
+		UpdateMinMax(points[i]);
 	}
 }
 
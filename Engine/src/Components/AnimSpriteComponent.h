@@ -10,6 +10,7 @@ namespace Engine
 		AnimSpriteComponent(class Actor* owner, int drawOrder = 100);
 		// Update animation every frame (overriden from component)
 		void Update(float deltaTime) override;
+		bool IsThreadSafe() const override { return true; }
 		//Set the textures used for animation
 		void SetAnimTextures(const std::vector<class Texture*>& textures);
 		float GetAnimFPS() const { return m_AnimFPS; }
@@ -26,7 +26,7 @@ namespace Engine
 		}
 	}
 
-	void BGSpriteComponent::Draw(Shader* shader)
+	void BGSpriteComponent::Draw(RenderQueue* queue)
 	{
 		
 	}
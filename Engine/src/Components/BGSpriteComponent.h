@@ -11,7 +11,7 @@ namespace Engine
 	public:
 		BGSpriteComponent(class Actor* owner, int drawOrder = 10);
 		void Update(float deltaTime) override;
-		void Draw(Shader* shader) override;
+		void Draw(class RenderQueue* queue) override;
 		void SetBGTextures(const std::vector<class Texture*>& textures);
 		void SetScreenSize(const Vector2 size) { m_ScreenSize = size; }
 		void SetScrollSpeed(float speed) { m_ScrollSpeed = speed; }
@@ -10,6 +10,8 @@ namespace Engine
 
 		void SetPlayer(Actor* player) { m_Player = player; }
 		void Update(float deltaTime) override;
+		// Segment casts against the PhysWorld
+		bool IsThreadSafe() const override { return false; }
 	protected:
 		class Actor* m_Player;
 	};
@@ -10,6 +10,8 @@ namespace Engine
 		, m_ObjectBox(Vector3::Zero, Vector3::Zero)
 		, m_WorldBox(Vector3::Zero, Vector3::Zero)
 		, m_ShouldRotate(true)
+		, m_ProxyId(AABBTree::NullNode)
+		, m_SAPProxyId(-1)
 	{
 		m_Owner->GetGame()->GetPhysWorld()->AddBox(this);
 	}
@@ -34,5 +36,8 @@ namespace Engine
 		// Translate
 		m_WorldBox.m_Min += m_Owner->GetPosition();
 		m_WorldBox.m_Max += m_Owner->GetPosition();
+
+		// Refit (or reinsert) in the BVH
+		m_Owner->GetGame()->GetPhysWorld()->UpdateBox(this);
 	}
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "Component.h"
 #include "Collision.h"
+#include "SlotMap.h"
 
 namespace Engine
 {
@@ -16,10 +17,23 @@ namespace Engine
 		const AABB& GetWorldBox() const { return m_WorldBox; }
 
 		void SetShouldRotate(bool value) { m_ShouldRotate = value; }
+
+		// Id of this box in the PhysWorld BVH
+		void SetProxyId(int id) { m_ProxyId = id; }
+		int GetProxyId() const { return m_ProxyId; }
+		// Id of this box in the PhysWorld sweep and prune
+		void SetSAPProxyId(int id) { m_SAPProxyId = id; }
+		int GetSAPProxyId() const { return m_SAPProxyId; }
+		// Handle in the PhysWorld box list
+		void SetPhysHandle(SlotHandle handle) { m_PhysHandle = handle; }
+		SlotHandle GetPhysHandle() const { return m_PhysHandle; }
 	private:
 		AABB m_ObjectBox;
 		AABB m_WorldBox;
 		bool m_ShouldRotate;
+		int m_ProxyId;
+		int m_SAPProxyId;
+		SlotHandle m_PhysHandle;
 	};
 }
 
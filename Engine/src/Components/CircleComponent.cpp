@@ -1,13 +1,23 @@
 
 #include "CircleComponent.h"
 #include "Actor.h"
+#include "Game.h"
+#include "SpatialHash.h"
 
 namespace Engine
 {
 	CircleComponent::CircleComponent(Actor* owner) :
 		Component(owner),
-		m_Radius(0.0f)
+		m_Radius(0.0f),
+		m_Layer(ELayerDefault),
+		m_HashIndex(-1)
 	{
+		m_Owner->GetGame()->GetCircleHash()->Add(this);
+	}
+
+	CircleComponent::~CircleComponent()
+	{
+		m_Owner->GetGame()->GetCircleHash()->Remove(this);
 	}
 
 	float CircleComponent::GetRadius() const
@@ -7,15 +7,35 @@ namespace Engine
 	class CircleComponent : public Component
 	{
 	public:
+		// Layers used to filter spatial hash queries
+		enum Layer
+		{
+			ELayerDefault = 1 << 0,
+			ELayerEnemy = 1 << 1,
+			ELayerProjectile = 1 << 2,
+			ELayerAsteroid = 1 << 3,
+			ELayerAll = 0xFFFFFFFF
+		};
+
 		CircleComponent(class Actor* owner);
+		~CircleComponent();
 		
 		void SetRadius(float radius) { m_Radius = radius; }
 		float GetRadius() const;
 
 		const Vector3& GetCenter() const;
 
+		void SetLayer(unsigned int layer) { m_Layer = layer; }
+		unsigned int GetLayer() const { return m_Layer; }
+
+		// Index of this circle in the game's SpatialHash
+		void SetHashIndex(int index) { m_HashIndex = index; }
+		int GetHashIndex() const { return m_HashIndex; }
+
 		static bool Intersect(const CircleComponent& a, const CircleComponent& b);
 	private:
 		float m_Radius;
+		unsigned int m_Layer;
+		int m_HashIndex;
 	};
 }
\ No newline at end of file
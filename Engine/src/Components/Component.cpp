@@ -4,6 +4,27 @@
 
 namespace Engine
 {
+	static PoolAllocator& GetComponentPool()
+	{
+		static PoolAllocator pool;
+		return pool;
+	}
+
+	void* Component::operator new(size_t size)
+	{
+		return GetComponentPool().Allocate(size);
+	}
+
+	void Component::operator delete(void* ptr, size_t size)
+	{
+		GetComponentPool().Free(ptr, size);
+	}
+
+	PoolStats Component::GetPoolStats()
+	{
+		return GetComponentPool().GetStats();
+	}
+
 	Component::Component(Actor* owner, int updateOrder) :
 		m_Owner(owner),
 		m_UpdateOrder(updateOrder)
@@ -1,5 +1,7 @@
 #pragma once
 #include <cstdint>
+#include <cstddef>
+#include "PoolAllocator.h"
 
 namespace Engine
 {
@@ -9,9 +11,18 @@ namespace Engine
 		// The lower the update order, the earlier the component updates
 		Component(class Actor* owner, int updateOrder = 100);
 		virtual ~Component();
+
+		// Components are pooled like actors (same rules, main thread only)
+		static void* operator new(size_t size);
+		static void operator delete(void* ptr, size_t size);
+		static PoolStats GetPoolStats();
 		virtual void Update(float deltaTime);
 		virtual void ProcessInput(const struct InputState& state) {}
 		virtual void OnUpdateWorldTransform() {}
+		// Thread-safe components only touch their own state and their owner's
+		// transform in Update, so they can be updated in parallel with other actors
+		// (anything structural, like creating actors, has to go through Game::Defer)
+		virtual bool IsThreadSafe() const { return false; }
 
 		int GetUpdateOrder() const { return m_UpdateOrder; }
 
@@ -1,11 +1,9 @@
 
-#include "Shader.h"
 #include "Mesh.h"
 #include "Actor.h"
 #include "Game.h"
 #include "Renderer.h"
 #include "Texture.h"
-#include "VertexArray.h"
 #include "MeshComponent.h"
 
 namespace Engine
@@ -14,40 +12,19 @@ namespace Engine
 		Component(owner),
 		m_Mesh(nullptr),
 		m_TextureIndex(0),
+		m_Lod(0),
 		m_Visible(true)
 	{
-		m_Owner->GetGame()->GetRenderer()->AddMeshComp(this);
+		m_RendererHandle = m_Owner->GetGame()->GetRenderer()->AddMeshComp(this);
 	}
 
 	MeshComponent::~MeshComponent()
 	{
-		m_Owner->GetGame()->GetRenderer()->RemoveMeshComp(this);
+		m_Owner->GetGame()->GetRenderer()->RemoveMeshComp(m_RendererHandle);
 	}
 
-	void MeshComponent::Draw(Shader* shader)
+	Texture* MeshComponent::GetTexture() const
 	{
-		if (m_Mesh)
-		{
-			shader->SetMatrixUniform("uWorldTransform",
-				m_Owner->GetWorldTransform());
-			// Set Specular power
-			shader->SetFloatUniform("uSpecPower", m_Mesh->GetSpecPower());
-
-			Texture* t = m_Mesh->GetTexture(m_TextureIndex);
-			if (t)
-			{
-				t->SetActive();
-			}
-
-			VertexArray* va = m_Mesh->GetVertexArray();
-			va->SetActive();
-
-			glDrawElements(
-				GL_TRIANGLES,
-				va->GetNumIndices(),
-				GL_UNSIGNED_INT,
-				nullptr
-			);
-		}
+		return m_Mesh ? m_Mesh->GetTexture(m_TextureIndex) : nullptr;
 	}
 }
\ No newline at end of file
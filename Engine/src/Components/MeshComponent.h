@@ -2,6 +2,7 @@
 
 #include "Component.h"
 #include <cstddef>
+#include "SlotMap.h"
 
 namespace Engine
 {
@@ -11,15 +12,24 @@ namespace Engine
 		MeshComponent(class Actor* owner);
 		~MeshComponent();
 
-		virtual void Draw(class Shader* shader);
-		virtual void SetMesh(class Mesh* mesh) { m_Mesh = mesh; }
+		virtual void SetMesh(class Mesh* mesh) { m_Mesh = mesh; m_Lod = 0; }
+		class Mesh* GetMesh() const { return m_Mesh; }
+		// Texture this component draws with (nullptr if none)
+		class Texture* GetTexture() const;
 		void SetTextureIndex(size_t index) { m_TextureIndex = index; }
 
 		void SetVisible(bool visible) { m_Visible = visible; }
 		bool GetVisible() const { return m_Visible; }
+
+		// Mesh LOD drawn last frame (the renderer picks it from the on screen size)
+		size_t GetLod() const { return m_Lod; }
+		void SetLod(size_t lod) { m_Lod = lod; }
 	private:
 		class Mesh* m_Mesh;
 		size_t m_TextureIndex;
+		size_t m_Lod;
+		// Handle in the renderer's mesh list
+		SlotHandle m_RendererHandle;
 		bool m_Visible;
 	};
 }
\ No newline at end of file
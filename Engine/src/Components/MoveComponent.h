@@ -11,6 +11,7 @@ namespace Engine
 		MoveComponent(class Actor* owner, int updateOrder = 10);
 
 		void Update(float deltaTime) override;
+		bool IsThreadSafe() const override { return true; }
 
 		void AddForce(Vector3& force);
 		void ResetVelocity() { m_Velocity = Vector3::Zero; }
@@ -2,18 +2,57 @@
 #include "NavComponent.h"
 #include "Actor.h"
 #include "GameObjects/TowerDefense/Tile.h"
+#include "FlowField.h"
+#include "NavMesh.h"
 
 namespace Engine
 {
 	NavComponent::NavComponent(Actor* owner, int updateOrder) :
 		MoveComponent(owner, updateOrder),
-		m_NextNode(nullptr)
+		m_NextNode(nullptr),
+		m_Field(nullptr),
+		m_PathIndex(0),
+		m_PathQueue(nullptr),
+		m_PathTicket(PathRequestQueue::NoTicket)
 	{
 	}
 
+	NavComponent::~NavComponent()
+	{
+		CancelPathRequest();
+	}
+
 	void NavComponent::Update(float deltaTime)
 	{
-		if (m_NextNode)
+		if (m_Field)
+		{
+			const Vector3& pos = m_Owner->GetPosition();
+			Vector2 dir = m_Field->GetDirection(Vector2(pos.x, pos.y));
+			if (dir.LengthSq() > 0.0f)
+			{
+				TurnTo(pos + Vector3(dir.x, dir.y, 0.0f));
+			}
+		}
+		else if (m_PathIndex < m_Path.size())
+		{
+			Vector3 diff = m_Path[m_PathIndex] - m_Owner->GetPosition();
+			diff.z = 0.0f;
+			if (CustomMath::NearZero(diff.Length(), 10.0f))
+			{
+				m_PathIndex++;
+				if (m_PathIndex < m_Path.size())
+				{
+					TurnTo(m_Path[m_PathIndex]);
+				}
+				else
+				{
+					// Got there
+					SetForwardSpeed(0.0f);
+					ResetVelocity();
+				}
+			}
+		}
+		else if (m_NextNode)
 		{
 			Vector3 diff = m_Owner->GetPosition() - m_NextNode->GetPosition();
 			if (CustomMath::NearZero(diff.Length(), 2.0f))
@@ -33,11 +72,58 @@ namespace Engine
 		TurnTo(m_NextNode->GetPosition());
 	}
 
+	bool NavComponent::MoveTo(NavMesh* mesh, const Vector3& target)
+	{
+		CancelPathRequest();
+		m_Path.clear();
+		m_PathIndex = 0;
+		if (!mesh->FindPath(m_Owner->GetPosition(), target, m_Path))
+		{
+			return false;
+		}
+
+		// The first corner is where the owner already is
+		m_PathIndex = 1;
+		TurnTo(m_Path[m_PathIndex]);
+		return true;
+	}
+
+	void NavComponent::RequestMoveTo(PathRequestQueue* queue, const Vector3& target)
+	{
+		CancelPathRequest();
+		m_PathQueue = queue;
+		m_PathTicket = queue->Request(m_Owner->GetPosition(), target,
+			[this](PathRequestQueue::Ticket, bool found, const std::vector<Vector3>& path)
+			{
+				m_PathQueue = nullptr;
+				m_PathTicket = PathRequestQueue::NoTicket;
+				if (!found)
+				{
+					return;
+				}
+
+				// The first corner is where the owner was (or close to it, for a merged request)
+				m_Path = path;
+				m_PathIndex = 1;
+				TurnTo(m_Path[m_PathIndex]);
+			});
+	}
+
+	void NavComponent::CancelPathRequest()
+	{
+		if (m_PathQueue)
+		{
+			m_PathQueue->Cancel(m_PathTicket);
+			m_PathQueue = nullptr;
+			m_PathTicket = PathRequestQueue::NoTicket;
+		}
+	}
+
 	void NavComponent::TurnTo(const Vector3& pos)
 	{
 		Vector3 dir = pos - m_Owner->GetPosition();
-		// New angle is just atan2 of this dir vector
-		// (Negate y because +y is down on screen
-		//m_Owner->SetRotation();
+		// New angle is just atan2 of this dir vector (turning about the up axis)
+		float angle = CustomMath::Atan2(dir.y, dir.x);
+		m_Owner->SetRotation(Quaternion(Vector3::UnitZ, angle));
 	}
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 #include "MoveComponent.h"
 #include "CustomMath.h"
+#include "PathRequestQueue.h"
+#include <vector>
 
 namespace Engine
 {
@@ -9,10 +11,29 @@ namespace Engine
 	public:
 		// Lower update order to update first
 		NavComponent(class Actor* owner, int updateOrder = 10);
+		~NavComponent();
 		void Update(float deltaTime) override;
 		void StartPath(const class Tile* start);
+		// Steer by the field's direction wherever the owner is, instead of a tile path
+		void FollowField(const class FlowField* field) { m_Field = field; }
+		// Walk to target over the nav mesh at the current forward speed, stopping there
+		// Returns false if there's no way to get there
+		bool MoveTo(class NavMesh* mesh, const Vector3& target);
+		// Same, but the path comes from the queue in a later frame (the owner keeps
+		// doing what it was until then, and carries on with it if there's no way there)
+		void RequestMoveTo(PathRequestQueue* queue, const Vector3& target);
+		// Yaw the owner about +z so its forward (+x) points at pos
 		void TurnTo(const Vector3& pos);
 	private:
+		void CancelPathRequest();
+
 		const class Tile* m_NextNode;
+		const class FlowField* m_Field;
+		// Corners of the nav mesh path, and the one being walked to
+		std::vector<Vector3> m_Path;
+		size_t m_PathIndex;
+		// Request still waiting on the queue, if any
+		PathRequestQueue* m_PathQueue;
+		PathRequestQueue::Ticket m_PathTicket;
 	};
 }
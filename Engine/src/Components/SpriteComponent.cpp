@@ -2,7 +2,7 @@
 #include "SpriteComponent.h"
 #include "Actor.h"
 #include "Game.h"
-#include "Shader.h"
+#include "RenderQueue.h"
 #include "Texture.h"
 #include <iostream>
 #include "Renderer.h"
@@ -16,15 +16,15 @@ namespace Engine
 		m_TexWidth(0),
 		m_TexHeight(0)
 	{
-		m_Owner->GetGame()->GetRenderer()->AddSprite(this);
+		m_RendererHandle = m_Owner->GetGame()->GetRenderer()->AddSprite(this);
 	}
 
 	SpriteComponent::~SpriteComponent()
 	{
-		m_Owner->GetGame()->GetRenderer()->RemoveSprite(this);
+		m_Owner->GetGame()->GetRenderer()->RemoveSprite(m_RendererHandle);
 	}
 
-	void SpriteComponent::Draw(Shader* shader)
+	void SpriteComponent::Draw(RenderQueue* queue)
 	{
 		if (m_Texture)
 		{
@@ -34,21 +34,9 @@ namespace Engine
 				static_cast<float>(m_TexHeight),
 				1.f);
 
-			Matrix4 world = scaleMat * m_Owner->GetWorldTransform();
-
-			// Since all sprites use the same shader/vertices,
-			// the game first sets them active before any sprite draws
-
-			shader->SetMatrixUniform("uWorldTransform", world);
-			m_Texture->SetActive();
-
-			glDrawElements(
-				GL_TRIANGLES,		// Type of polygon/primitive to draw
-				6,					// Number of indices in index buffer
-				GL_UNSIGNED_INT,    // Type of each index
-				nullptr				// Usually nullptr
-			);
-		};
+			Matrix4 world = scaleMat * m_Owner->GetRenderTransform();
+			queue->AddQuad(RenderQueue::ESprites, m_Texture, world, m_DrawOrder);
+		}
 	}
 
 	void SpriteComponent::SetTexture(Texture* texture)
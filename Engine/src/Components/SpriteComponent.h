@@ -1,6 +1,7 @@
 #pragma once
 #include "Component.h"
 #include "CustomMath.h"
+#include "SlotMap.h"
 
 namespace Engine
 {
@@ -11,7 +12,8 @@ namespace Engine
 		SpriteComponent(class Actor* owner, int drawOrder = 100);
 		~SpriteComponent();
 
-		virtual void Draw(class Shader* shader);
+		// Add this sprite's quad to the render queue
+		virtual void Draw(class RenderQueue* queue);
 		virtual void SetTexture(class Texture* texture);
 
 		int GetDrawOrder() const { return m_DrawOrder; }
@@ -22,5 +24,7 @@ namespace Engine
 		int m_DrawOrder;
 		int m_TexWidth;
 		int m_TexHeight;
+		// Handle in the renderer's sprite list
+		SlotHandle m_RendererHandle;
 	};
 }
\ No newline at end of file
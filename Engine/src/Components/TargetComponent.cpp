@@ -12,11 +12,11 @@ namespace Engine
 	TargetComponent::TargetComponent(Actor* owner)
 		:Component(owner)
 	{
-		m_Owner->GetGame()->GetHUD()->AddTargetComponent(this);
+		m_HUDHandle = m_Owner->GetGame()->GetHUD()->AddTargetComponent(this);
 	}
 
 	TargetComponent::~TargetComponent()
 	{
-		m_Owner->GetGame()->GetHUD()->RemoveTargetComponent(this);
+		m_Owner->GetGame()->GetHUD()->RemoveTargetComponent(m_HUDHandle);
 	}
 }
\ No newline at end of file
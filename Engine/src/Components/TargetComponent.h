@@ -1,5 +1,6 @@
 #pragma once
 #include "Component.h"
+#include "SlotMap.h"
 
 namespace Engine
 {
@@ -8,5 +9,8 @@ namespace Engine
 	public:
 		TargetComponent(class Actor* owner);
 		~TargetComponent();
+	private:
+		// Handle in the HUD's target list
+		SlotHandle m_HUDHandle;
 	};
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 // ----------------------------------------------------------------
 
 #include "CustomMath.h"
+#include <utility>
 
 const Vector2 Vector2::Zero(0.0f, 0.0f);
 const Vector2 Vector2::UnitX(1.0f, 0.0f);
@@ -44,6 +45,24 @@ const Matrix4 Matrix4::Identity(m4Ident);
 
 const Quaternion Quaternion::Identity(0.0f, 0.0f, 0.0f, 1.0f);
 
+#ifdef CUSTOMMATH_SIMD_SSE
+// Load four arbitrary floats from an array into one register
+static inline __m128 Gather4(const float* a, int i0, int i1, int i2, int i3)
+{
+	return _mm_setr_ps(a[i0], a[i1], a[i2], a[i3]);
+}
+
+// vec.x * row0 + vec.y * row1 + vec.z * row2 + w * row3
+static inline __m128 TransformRows(const Vector3& vec, const Matrix4& mat, float w)
+{
+	__m128 retVal = _mm_mul_ps(_mm_set1_ps(vec.x), _mm_loadu_ps(mat.mat[0]));
+	retVal = _mm_add_ps(retVal, _mm_mul_ps(_mm_set1_ps(vec.y), _mm_loadu_ps(mat.mat[1])));
+	retVal = _mm_add_ps(retVal, _mm_mul_ps(_mm_set1_ps(vec.z), _mm_loadu_ps(mat.mat[2])));
+	retVal = _mm_add_ps(retVal, _mm_mul_ps(_mm_set1_ps(w), _mm_loadu_ps(mat.mat[3])));
+	return retVal;
+}
+#endif
+
 Vector2 Vector2::Transform(const Vector2& vec, const Matrix3& mat, float w /*= 1.0f*/)
 {
 	Vector2 retVal;
@@ -56,20 +75,65 @@ Vector2 Vector2::Transform(const Vector2& vec, const Matrix3& mat, float w /*= 1
 Vector3 Vector3::Transform(const Vector3& vec, const Matrix4& mat, float w /*= 1.0f*/)
 {
 	Vector3 retVal;
+#ifdef CUSTOMMATH_SIMD_SSE
+	float result[4];
+	_mm_storeu_ps(result, TransformRows(vec, mat, w));
+	retVal.x = result[0];
+	retVal.y = result[1];
+	retVal.z = result[2];
+#else
 	retVal.x = vec.x * mat.mat[0][0] + vec.y * mat.mat[1][0] +
 		vec.z * mat.mat[2][0] + w * mat.mat[3][0];
 	retVal.y = vec.x * mat.mat[0][1] + vec.y * mat.mat[1][1] +
 		vec.z * mat.mat[2][1] + w * mat.mat[3][1];
 	retVal.z = vec.x * mat.mat[0][2] + vec.y * mat.mat[1][2] +
 		vec.z * mat.mat[2][2] + w * mat.mat[3][2];
+#endif
 	//ignore w since we aren't returning a new value for it...
 	return retVal;
 }
 
+void Vector3::TransformPoints(const Vector3* points, size_t count, const Matrix4& mat, Vector3* out)
+{
+#ifdef CUSTOMMATH_SIMD_SSE
+	// Keep the matrix rows in registers for the whole batch
+	const __m128 row0 = _mm_loadu_ps(mat.mat[0]);
+	const __m128 row1 = _mm_loadu_ps(mat.mat[1]);
+	const __m128 row2 = _mm_loadu_ps(mat.mat[2]);
+	const __m128 row3 = _mm_loadu_ps(mat.mat[3]);
+	float result[4];
+	for (size_t i = 0; i < count; i++)
+	{
+		// w is 1, so the last row is added as is
+		__m128 v = _mm_mul_ps(_mm_set1_ps(points[i].x), row0);
+		v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(points[i].y), row1));
+		v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(points[i].z), row2));
+		v = _mm_add_ps(v, row3);
+		_mm_storeu_ps(result, v);
+		out[i].x = result[0];
+		out[i].y = result[1];
+		out[i].z = result[2];
+	}
+#else
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = Transform(points[i], mat);
+	}
+#endif
+}
+
 // This will transform the vector and renormalize the w component
 Vector3 Vector3::TransformWithPerspDiv(const Vector3& vec, const Matrix4& mat, float w /*= 1.0f*/)
 {
 	Vector3 retVal;
+#ifdef CUSTOMMATH_SIMD_SSE
+	float result[4];
+	_mm_storeu_ps(result, TransformRows(vec, mat, w));
+	retVal.x = result[0];
+	retVal.y = result[1];
+	retVal.z = result[2];
+	float transformedW = result[3];
+#else
 	retVal.x = vec.x * mat.mat[0][0] + vec.y * mat.mat[1][0] +
 		vec.z * mat.mat[2][0] + w * mat.mat[3][0];
 	retVal.y = vec.x * mat.mat[0][1] + vec.y * mat.mat[1][1] +
@@ -78,6 +142,7 @@ Vector3 Vector3::TransformWithPerspDiv(const Vector3& vec, const Matrix4& mat, f
 		vec.z * mat.mat[2][2] + w * mat.mat[3][2];
 	float transformedW = vec.x * mat.mat[0][3] + vec.y * mat.mat[1][3] +
 		vec.z * mat.mat[2][3] + w * mat.mat[3][3];
+#endif
 	if (!CustomMath::NearZero(CustomMath::Abs(transformedW)))
 	{
 		transformedW = 1.0f / transformedW;
@@ -130,6 +195,71 @@ void Matrix4::Invert()
 	src[11] = mat[3][2];
 	src[15] = mat[3][3];
 
+#ifdef CUSTOMMATH_SIMD_SSE
+	// Same cofactors as below, four at a time
+	// Products are gathered so each lane does exactly the scalar operations
+	__m128 d[4];
+
+	// Pairs for the first 8 cofactors
+	_mm_storeu_ps(tmp, _mm_mul_ps(Gather4(src, 10, 11, 9, 11), Gather4(src, 15, 14, 15, 13)));
+	_mm_storeu_ps(tmp + 4, _mm_mul_ps(Gather4(src, 9, 10, 8, 11), Gather4(src, 14, 13, 15, 12)));
+	_mm_storeu_ps(tmp + 8, _mm_mul_ps(Gather4(src, 8, 10, 8, 9), Gather4(src, 14, 12, 13, 12)));
+
+	for (int k = 0; k < 2; k++)
+	{
+		// dst[0..3] use src[4..7], dst[4..7] use src[0..3] with the signs swapped
+		const int o = (k == 0) ? 4 : 0;
+		__m128 a1 = Gather4(tmp, 0, 1, 2, 5);
+		__m128 a2 = Gather4(tmp, 3, 6, 7, 8);
+		__m128 a3 = Gather4(tmp, 4, 9, 10, 11);
+		__m128 b1 = Gather4(tmp, 1, 0, 3, 4);
+		__m128 b2 = Gather4(tmp, 2, 7, 6, 9);
+		__m128 b3 = Gather4(tmp, 5, 8, 11, 10);
+		const __m128 s1 = Gather4(src, o + 1, o, o, o);
+		const __m128 s2 = Gather4(src, o + 2, o + 2, o + 1, o + 1);
+		const __m128 s3 = Gather4(src, o + 3, o + 3, o + 3, o + 2);
+		if (k == 1)
+		{
+			std::swap(a1, b1);
+			std::swap(a2, b2);
+			std::swap(a3, b3);
+		}
+		__m128 pos = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a1, s1), _mm_mul_ps(a2, s2)), _mm_mul_ps(a3, s3));
+		__m128 neg = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b1, s1), _mm_mul_ps(b2, s2)), _mm_mul_ps(b3, s3));
+		d[k] = _mm_sub_ps(pos, neg);
+	}
+
+	// Pairs for the second 8 cofactors
+	_mm_storeu_ps(tmp, _mm_mul_ps(Gather4(src, 2, 3, 1, 3), Gather4(src, 7, 6, 7, 5)));
+	_mm_storeu_ps(tmp + 4, _mm_mul_ps(Gather4(src, 1, 2, 0, 3), Gather4(src, 6, 5, 7, 4)));
+	_mm_storeu_ps(tmp + 8, _mm_mul_ps(Gather4(src, 0, 2, 0, 1), Gather4(src, 6, 4, 5, 4)));
+
+	{
+		__m128 s1 = Gather4(src, 13, 12, 12, 12);
+		__m128 s2 = Gather4(src, 14, 14, 13, 13);
+		__m128 s3 = Gather4(src, 15, 15, 15, 14);
+		__m128 pos = _mm_add_ps(_mm_add_ps(_mm_mul_ps(Gather4(tmp, 0, 1, 2, 5), s1),
+			_mm_mul_ps(Gather4(tmp, 3, 6, 7, 8), s2)), _mm_mul_ps(Gather4(tmp, 4, 9, 10, 11), s3));
+		__m128 neg = _mm_add_ps(_mm_add_ps(_mm_mul_ps(Gather4(tmp, 1, 0, 3, 4), s1),
+			_mm_mul_ps(Gather4(tmp, 2, 7, 6, 9), s2)), _mm_mul_ps(Gather4(tmp, 5, 8, 11, 10), s3));
+		d[2] = _mm_sub_ps(pos, neg);
+
+		pos = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(Gather4(tmp, 2, 8, 6, 10), Gather4(src, 10, 11, 9, 10)),
+			_mm_mul_ps(Gather4(tmp, 5, 0, 11, 4), Gather4(src, 11, 8, 11, 8))),
+			_mm_mul_ps(Gather4(tmp, 1, 7, 3, 9), Gather4(src, 9, 10, 8, 9)));
+		neg = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(Gather4(tmp, 4, 6, 10, 8), Gather4(src, 11, 10, 11, 9)),
+			_mm_mul_ps(Gather4(tmp, 0, 9, 2, 11), Gather4(src, 9, 11, 8, 10))),
+			_mm_mul_ps(Gather4(tmp, 3, 1, 7, 5), Gather4(src, 10, 8, 9, 8)));
+		d[3] = _mm_sub_ps(pos, neg);
+	}
+
+	for (int i = 0; i < 4; i++)
+	{
+		_mm_storeu_ps(dst + i * 4, d[i]);
+	}
+#else
 	// Calculate cofactors
 	tmp[0] = src[10] * src[15];
 	tmp[1] = src[11] * src[14];
@@ -191,6 +321,8 @@ void Matrix4::Invert()
 	dst[15] = tmp[10] * src[10] + tmp[4] * src[8] + tmp[9] * src[9];
 	dst[15] -= tmp[8] * src[9] + tmp[11] * src[10] + tmp[5] * src[8];
 	
+#endif
+
 	// Calculate determinant
 	det = src[0] * dst[0] + src[1] * dst[1] + src[2] * dst[2] + src[3] * dst[3];
 	
@@ -237,3 +369,64 @@ Matrix4 Matrix4::CreateFromQuaternion(const class Quaternion& q)
 
 	return Matrix4(mat);
 }
+
+void Matrix4::CreateFromQuaternions(const Quaternion* quats, size_t count, Matrix4* out)
+{
+	size_t i = 0;
+#ifdef CUSTOMMATH_SIMD_SSE
+	// Four quaternions at a time: transpose to x/y/z/w registers,
+	// build each matrix element for all four, then transpose back to rows
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 two = _mm_set1_ps(2.0f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 lastRow = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(&quats[i].x);
+		__m128 y = _mm_loadu_ps(&quats[i + 1].x);
+		__m128 z = _mm_loadu_ps(&quats[i + 2].x);
+		__m128 w = _mm_loadu_ps(&quats[i + 3].x);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+
+		const __m128 x2 = _mm_mul_ps(two, x);
+		const __m128 y2 = _mm_mul_ps(two, y);
+		const __m128 z2 = _mm_mul_ps(two, z);
+		const __m128 w2 = _mm_mul_ps(two, w);
+
+		__m128 m00 = _mm_sub_ps(_mm_sub_ps(one, _mm_mul_ps(y2, y)), _mm_mul_ps(z2, z));
+		__m128 m01 = _mm_add_ps(_mm_mul_ps(x2, y), _mm_mul_ps(w2, z));
+		__m128 m02 = _mm_sub_ps(_mm_mul_ps(x2, z), _mm_mul_ps(w2, y));
+		__m128 m0w = zero;
+
+		__m128 m10 = _mm_sub_ps(_mm_mul_ps(x2, y), _mm_mul_ps(w2, z));
+		__m128 m11 = _mm_sub_ps(_mm_sub_ps(one, _mm_mul_ps(x2, x)), _mm_mul_ps(z2, z));
+		__m128 m12 = _mm_add_ps(_mm_mul_ps(y2, z), _mm_mul_ps(w2, x));
+		__m128 m1w = zero;
+
+		__m128 m20 = _mm_add_ps(_mm_mul_ps(x2, z), _mm_mul_ps(w2, y));
+		__m128 m21 = _mm_sub_ps(_mm_mul_ps(y2, z), _mm_mul_ps(w2, x));
+		__m128 m22 = _mm_sub_ps(_mm_sub_ps(one, _mm_mul_ps(x2, x)), _mm_mul_ps(y2, y));
+		__m128 m2w = zero;
+
+		_MM_TRANSPOSE4_PS(m00, m01, m02, m0w);
+		_MM_TRANSPOSE4_PS(m10, m11, m12, m1w);
+		_MM_TRANSPOSE4_PS(m20, m21, m22, m2w);
+
+		const __m128 rows0[4] = { m00, m01, m02, m0w };
+		const __m128 rows1[4] = { m10, m11, m12, m1w };
+		const __m128 rows2[4] = { m20, m21, m22, m2w };
+		for (int k = 0; k < 4; k++)
+		{
+			_mm_storeu_ps(out[i + k].mat[0], rows0[k]);
+			_mm_storeu_ps(out[i + k].mat[1], rows1[k]);
+			_mm_storeu_ps(out[i + k].mat[2], rows2[k]);
+			_mm_storeu_ps(out[i + k].mat[3], lastRow);
+		}
+	}
+#endif
+	// Leftovers (or everything, without SIMD)
+	for (; i < count; i++)
+	{
+		out[i] = CreateFromQuaternion(quats[i]);
+	}
+}
\ No newline at end of file
@@ -11,6 +11,16 @@
 #include <cmath>
 #include <memory.h>
 #include <limits>
+#include <cstddef>
+
+// SIMD kernels for the hot matrix/vector/quaternion functions
+// SSE is selected at compile time whenever the target supports it (always true on x64),
+// define CUSTOMMATH_NO_SIMD to force the scalar versions.
+// Both versions perform the same operations in the same order, so they give bit-for-bit identical results
+#if !defined(CUSTOMMATH_NO_SIMD) && (defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define CUSTOMMATH_SIMD_SSE 1
+#include <xmmintrin.h>
+#endif
 
 namespace CustomMath
 {
@@ -406,6 +416,9 @@ public:
 	}
 
 	static Vector3 Transform(const Vector3& vec, const class Matrix4& mat, float w = 1.0f);
+	// Transform count points (w = 1) by the same matrix
+	// out can be the same array as points
+	static void TransformPoints(const Vector3* points, size_t count, const class Matrix4& mat, Vector3* out);
 	// This will transform the vector and renormalize the w component
 	static Vector3 TransformWithPerspDiv(const Vector3& vec, const class Matrix4& mat, float w = 1.0f);
 
@@ -583,6 +596,21 @@ public:
 	friend Matrix4 operator*(const Matrix4& a, const Matrix4& b)
 	{
 		Matrix4 retVal;
+#ifdef CUSTOMMATH_SIMD_SSE
+		// Each row of the result is a linear combination of the rows of b
+		const __m128 b0 = _mm_loadu_ps(b.mat[0]);
+		const __m128 b1 = _mm_loadu_ps(b.mat[1]);
+		const __m128 b2 = _mm_loadu_ps(b.mat[2]);
+		const __m128 b3 = _mm_loadu_ps(b.mat[3]);
+		for (int i = 0; i < 4; i++)
+		{
+			__m128 row = _mm_mul_ps(_mm_set1_ps(a.mat[i][0]), b0);
+			row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.mat[i][1]), b1));
+			row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.mat[i][2]), b2));
+			row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a.mat[i][3]), b3));
+			_mm_storeu_ps(retVal.mat[i], row);
+		}
+#else
 		// row 0
 		retVal.mat[0][0] = 
 			a.mat[0][0] * b.mat[0][0] + 
@@ -682,6 +710,7 @@ public:
 			a.mat[3][1] * b.mat[1][3] +
 			a.mat[3][2] * b.mat[2][3] +
 			a.mat[3][3] * b.mat[3][3];
+#endif
 		
 		return retVal;
 	}
@@ -794,6 +823,8 @@ public:
 
 	// Create a rotation matrix from a quaternion
 	static Matrix4 CreateFromQuaternion(const class Quaternion& q);
+	// Create count rotation matrices from count quaternions
+	static void CreateFromQuaternions(const class Quaternion* quats, size_t count, Matrix4* out);
 
 	static Matrix4 CreateTranslation(const Vector3& trans)
 	{
@@ -1010,6 +1041,26 @@ public:
 	{
 		Quaternion retVal;
 
+#ifdef CUSTOMMATH_SIMD_SSE
+		// Vector component is:
+		// ps * qv + qs * pv + pv x qv
+		// (the w lane is computed, but overwritten below)
+		const __m128 qv = _mm_loadu_ps(&q.x);
+		const __m128 pv = _mm_loadu_ps(&p.x);
+		__m128 newVec = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p.w), qv),
+			_mm_mul_ps(_mm_set1_ps(q.w), pv));
+		// Cross product with (y, z, x) and (z, x, y) swizzles
+		const __m128 pYZX = _mm_shuffle_ps(pv, pv, _MM_SHUFFLE(3, 0, 2, 1));
+		const __m128 pZXY = _mm_shuffle_ps(pv, pv, _MM_SHUFFLE(3, 1, 0, 2));
+		const __m128 qYZX = _mm_shuffle_ps(qv, qv, _MM_SHUFFLE(3, 0, 2, 1));
+		const __m128 qZXY = _mm_shuffle_ps(qv, qv, _MM_SHUFFLE(3, 1, 0, 2));
+		newVec = _mm_add_ps(newVec, _mm_sub_ps(_mm_mul_ps(pYZX, qZXY), _mm_mul_ps(pZXY, qYZX)));
+		_mm_storeu_ps(&retVal.x, newVec);
+
+		// Scalar component is:
+		// ps * qs - pv . qv
+		retVal.w = p.w * q.w - (p.x * q.x + p.y * q.y + p.z * q.z);
+#else
 		// Vector component is:
 		// ps * qv + qs * pv + pv x qv
 		Vector3 qv(q.x, q.y, q.z);
@@ -1022,6 +1073,7 @@ public:
 		// Scalar component is:
 		// ps * qs - pv . qv
 		retVal.w = p.w * q.w - Vector3::Dot(pv, qv);
+#endif
 
 		return retVal;
 	}
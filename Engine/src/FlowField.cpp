@@ -0,0 +1,235 @@
+#include "FlowField.h"
+#include "PathGrid.h"
+
+namespace Engine
+{
+	FlowField::FlowField() :
+		m_Grid(nullptr),
+		m_Goal(-1),
+		m_Version(0),
+		m_CellsUpdated(0)
+	{
+	}
+
+	void FlowField::Build(const PathGrid& grid, int goal)
+	{
+		m_Grid = &grid;
+		m_Goal = goal;
+		m_Version = grid.GetVersion();
+		m_CellsUpdated = 0;
+
+		const int cellCount = grid.GetCellCount();
+		m_Integration.assign(cellCount, CustomMath::Infinity);
+		m_Next.assign(cellCount, -1);
+		m_Directions.assign(cellCount, Vector2::Zero);
+		m_IsStale.assign(cellCount, 0);
+		m_Open.Reserve(cellCount);
+
+		if (goal < 0 || goal >= cellCount || grid.IsBlocked(goal))
+		{
+			return;
+		}
+		m_Integration[goal] = 0.0f;
+		m_Open.Push(goal, 0.0f);
+		Propagate();
+	}
+
+	void FlowField::Repair(int cell)
+	{
+		m_Version = m_Grid->GetVersion();
+		m_CellsUpdated = 0;
+		if (m_Goal < 0)
+		{
+			return;
+		}
+		if (cell == m_Goal)
+		{
+			Build(*m_Grid, m_Goal);
+			return;
+		}
+
+		int cells[8];
+		float costs[8];
+
+		// Everything whose route ran through cell has to be redone (the cell itself too),
+		// along with cells whose diagonal step past its corner isn't allowed any more
+		m_Stale.clear();
+		m_Stale.emplace_back(cell);
+		m_IsStale[cell] = 1;
+		const int x = m_Grid->GetX(cell);
+		const int y = m_Grid->GetY(cell);
+		for (int ny = y - 1; ny <= y + 1; ny++)
+		{
+			for (int nx = x - 1; nx <= x + 1; nx++)
+			{
+				if (!m_Grid->IsInside(nx, ny))
+				{
+					continue;
+				}
+				int around = m_Grid->GetIndex(nx, ny);
+				if (m_Next[around] >= 0 && !IsStepAllowed(around, m_Next[around]) && !m_IsStale[around])
+				{
+					m_IsStale[around] = 1;
+					m_Stale.emplace_back(around);
+				}
+			}
+		}
+		for (size_t i = 0; i < m_Stale.size(); i++)
+		{
+			int stale = m_Stale[i];
+			int count = m_Grid->GetNeighbors(stale, cells, costs);
+			for (int j = 0; j < count; j++)
+			{
+				if (m_Next[cells[j]] == stale && !m_IsStale[cells[j]])
+				{
+					m_IsStale[cells[j]] = 1;
+					m_Stale.emplace_back(cells[j]);
+				}
+			}
+		}
+		for (int stale : m_Stale)
+		{
+			m_Integration[stale] = CustomMath::Infinity;
+			m_Next[stale] = -1;
+		}
+
+		// Seed each stale cell from its best neighbour that's still good
+		for (int stale : m_Stale)
+		{
+			if (m_Grid->IsBlocked(stale))
+			{
+				continue;
+			}
+			int count = m_Grid->GetNeighbors(stale, cells, costs);
+			for (int j = 0; j < count; j++)
+			{
+				int neighbor = cells[j];
+				if (m_IsStale[neighbor])
+				{
+					continue;
+				}
+				float integration = m_Integration[neighbor] + m_Grid->GetStepCost(stale, neighbor);
+				if (integration < m_Integration[stale])
+				{
+					m_Integration[stale] = integration;
+					m_Next[stale] = neighbor;
+				}
+			}
+			if (m_Integration[stale] != CustomMath::Infinity)
+			{
+				m_Open.Push(stale, m_Integration[stale]);
+			}
+		}
+		// The cells around it go back in as they are, so any step that just opened
+		// up past the cell's corners gets tried
+		for (int ny = y - 1; ny <= y + 1; ny++)
+		{
+			for (int nx = x - 1; nx <= x + 1; nx++)
+			{
+				if (!m_Grid->IsInside(nx, ny))
+				{
+					continue;
+				}
+				int around = m_Grid->GetIndex(nx, ny);
+				if (!m_IsStale[around] && m_Integration[around] != CustomMath::Infinity)
+				{
+					m_Open.Push(around, m_Integration[around]);
+				}
+			}
+		}
+		for (int stale : m_Stale)
+		{
+			m_IsStale[stale] = 0;
+		}
+
+		// From here it's Dijkstra again, and it also carries any savings
+		// (when the cell got cheaper) out to the cells around it
+		Propagate();
+
+		// Cells that stayed cut off still need their direction cleared
+		for (int stale : m_Stale)
+		{
+			UpdateDirection(stale);
+		}
+	}
+
+	Vector2 FlowField::GetDirection(const Vector2& pos) const
+	{
+		int cell = m_Grid ? m_Grid->GetCellAt(pos) : -1;
+		if (cell < 0)
+		{
+			return Vector2::Zero;
+		}
+		if (cell == m_Goal)
+		{
+			// Head for the middle of the goal
+			Vector2 dir = m_Grid->GetCellCenter(cell) - pos;
+			if (dir.LengthSq() > 1.0f)
+			{
+				dir.Normalize();
+				return dir;
+			}
+			return Vector2::Zero;
+		}
+		return m_Directions[cell];
+	}
+
+	bool FlowField::IsUpToDate() const
+	{
+		return m_Grid && m_Version == m_Grid->GetVersion();
+	}
+
+	void FlowField::Propagate()
+	{
+		int cells[8];
+		float costs[8];
+		while (!m_Open.IsEmpty())
+		{
+			int current = m_Open.Pop();
+			m_CellsUpdated++;
+			UpdateDirection(current);
+
+			// Moves can be walked both ways, so the neighbours are the cells that can step in here
+			const float integration = m_Integration[current];
+			int count = m_Grid->GetNeighbors(current, cells, costs);
+			for (int i = 0; i < count; i++)
+			{
+				int neighbor = cells[i];
+				float newIntegration = integration + m_Grid->GetStepCost(neighbor, current);
+				if (newIntegration < m_Integration[neighbor])
+				{
+					m_Integration[neighbor] = newIntegration;
+					m_Next[neighbor] = current;
+					m_Open.Push(neighbor, newIntegration);
+				}
+			}
+		}
+	}
+
+	bool FlowField::IsStepAllowed(int from, int to) const
+	{
+		int cells[8];
+		float costs[8];
+		int count = m_Grid->GetNeighbors(from, cells, costs);
+		for (int i = 0; i < count; i++)
+		{
+			if (cells[i] == to)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void FlowField::UpdateDirection(int cell)
+	{
+		if (m_Next[cell] < 0)
+		{
+			m_Directions[cell] = Vector2::Zero;
+			return;
+		}
+		Vector2 dir = m_Grid->GetCellCenter(m_Next[cell]) - m_Grid->GetCellCenter(cell);
+		dir.Normalize();
+		m_Directions[cell] = dir;
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "CustomMath.h"
+#include "IndexedHeap.h"
+
+namespace Engine
+{
+	class PathGrid;
+
+	// Paths from every cell of a PathGrid to a single goal, built once and shared
+	// The integration field is each cell's cost to reach the goal, and the direction
+	// field is the way to walk out of each cell, so looking one up is O(1)
+	class FlowField
+	{
+	public:
+		FlowField();
+
+		// Dijkstra out from the goal over the whole grid
+		void Build(const PathGrid& grid, int goal);
+		// Fix the field after the cost of one cell changed (blocked, unblocked or
+		// reweighted). Only the cells whose route went through it are redone,
+		// plus any that can now get a cheaper route through it
+		void Repair(int cell);
+
+		// Cost to reach the goal from cell, CustomMath::Infinity if it can't
+		float GetIntegration(int cell) const { return m_Integration[cell]; }
+		bool IsReachable(int cell) const { return m_Integration[cell] != CustomMath::Infinity; }
+		// Next cell on the way to the goal, -1 at the goal or if unreachable
+		int GetNext(int cell) const { return m_Next[cell]; }
+		// Unit direction to walk in from a world position, zero if there's no way on
+		Vector2 GetDirection(const Vector2& pos) const;
+
+		int GetGoal() const { return m_Goal; }
+		const PathGrid* GetGrid() const { return m_Grid; }
+		// False once the grid changed without the field being repaired
+		bool IsUpToDate() const;
+		// Cells settled by the last Build or Repair
+		int GetCellsUpdated() const { return m_CellsUpdated; }
+	private:
+		void Propagate();
+		void UpdateDirection(int cell);
+		bool IsStepAllowed(int from, int to) const;
+
+		const PathGrid* m_Grid;
+		int m_Goal;
+		std::vector<float> m_Integration;
+		std::vector<int> m_Next;
+		std::vector<Vector2> m_Directions;
+		IndexedHeap m_Open;
+		// Scratch for Repair
+		std::vector<int> m_Stale;
+		std::vector<uint8_t> m_IsStale;
+		uint32_t m_Version;
+		int m_CellsUpdated;
+	};
+}
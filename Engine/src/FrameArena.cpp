@@ -0,0 +1,103 @@
+#include "FrameArena.h"
+#include <new>
+#include <cstdint>
+#include <SDL_log.h>
+
+namespace Engine
+{
+	FrameArena::FrameArena(size_t blockSize) :
+		m_BlockSize(blockSize > 0 ? blockSize : 1),
+		m_Current(0),
+		m_Offset(0),
+		m_Used(0),
+		m_Peak(0),
+#ifdef _DEBUG
+		m_ReportPeaks(true)
+#else
+		m_ReportPeaks(false)
+#endif
+	{
+		AddBlock(m_BlockSize);
+	}
+
+	FrameArena::~FrameArena()
+	{
+		FreeBlocks();
+	}
+
+	void* FrameArena::Allocate(size_t size, size_t alignment)
+	{
+		// alignment is a power of two
+		while (true)
+		{
+			Block& block = m_Blocks[m_Current];
+			uintptr_t address = reinterpret_cast<uintptr_t>(block.m_Data) + m_Offset;
+			size_t padding = static_cast<size_t>((alignment - (address & (alignment - 1))) & (alignment - 1));
+			if (m_Offset + padding + size <= block.m_Size)
+			{
+				void* ptr = block.m_Data + m_Offset + padding;
+				m_Offset += padding + size;
+				m_Used += padding + size;
+				return ptr;
+			}
+
+			// Doesn't fit, move on to the next block (making one big enough if needed)
+			m_Current++;
+			m_Offset = 0;
+			if (m_Current == m_Blocks.size())
+			{
+				AddBlock(size + alignment);
+			}
+		}
+	}
+
+	void FrameArena::Reset()
+	{
+		if (m_Used > m_Peak)
+		{
+			m_Peak = m_Used;
+			if (m_ReportPeaks)
+			{
+				SDL_Log("Frame arena peak: %u bytes (%u reserved)",
+					static_cast<unsigned int>(m_Peak), static_cast<unsigned int>(GetCapacity()));
+			}
+		}
+
+		// Chained blocks become one, so a frame like this one fits next time
+		if (m_Blocks.size() > 1)
+		{
+			size_t capacity = GetCapacity();
+			FreeBlocks();
+			AddBlock(capacity);
+		}
+
+		m_Current = 0;
+		m_Offset = 0;
+		m_Used = 0;
+	}
+
+	size_t FrameArena::GetCapacity() const
+	{
+		size_t capacity = 0;
+		for (const auto& block : m_Blocks)
+		{
+			capacity += block.m_Size;
+		}
+		return capacity;
+	}
+
+	void FrameArena::AddBlock(size_t minSize)
+	{
+		size_t size = minSize > m_BlockSize ? minSize : m_BlockSize;
+		m_Blocks.emplace_back(Block{ static_cast<unsigned char*>(::operator new(size)), size });
+	}
+
+	void FrameArena::FreeBlocks()
+	{
+		for (auto& block : m_Blocks)
+		{
+			::operator delete(block.m_Data);
+		}
+		m_Blocks.clear();
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+namespace Engine
+{
+	// Bump allocator for memory that only has to last until the end of the frame
+	// Allocating moves an offset forward, freeing does nothing, and Reset (once a frame,
+	// from Game::RunLoop) takes everything back at once.
+	// If a frame needs more than the current block, more blocks are chained on,
+	// and Reset merges them into one so the next frame fits without chaining.
+	// Main thread only
+	class FrameArena
+	{
+	public:
+		FrameArena(size_t blockSize = 256 * 1024);
+		~FrameArena();
+
+		void* Allocate(size_t size, size_t alignment = 16);
+		// Release everything allocated since the last Reset
+		void Reset();
+
+		// Bytes handed out since the last Reset, the most in any frame, and what's reserved
+		size_t GetUsed() const { return m_Used; }
+		size_t GetPeak() const { return m_Peak; }
+		size_t GetCapacity() const;
+		// Log each new peak on Reset (on by default in debug builds)
+		void SetReportPeaks(bool value) { m_ReportPeaks = value; }
+	private:
+		void AddBlock(size_t minSize);
+		void FreeBlocks();
+
+		struct Block
+		{
+			unsigned char* m_Data;
+			size_t m_Size;
+		};
+		std::vector<Block> m_Blocks;
+		size_t m_BlockSize;
+		// Block being allocated from, and how far into it
+		size_t m_Current;
+		size_t m_Offset;
+		size_t m_Used;
+		size_t m_Peak;
+		bool m_ReportPeaks;
+	};
+
+	// STL allocator on top of a FrameArena, for per-frame containers
+	// deallocate is a no-op, so the container must not outlive the frame
+	template <typename T>
+	class FrameAllocator
+	{
+	public:
+		typedef T value_type;
+
+		FrameAllocator(FrameArena* arena) :
+			m_Arena(arena)
+		{
+		}
+		template <typename U>
+		FrameAllocator(const FrameAllocator<U>& other) :
+			m_Arena(other.GetArena())
+		{
+		}
+
+		T* allocate(size_t count)
+		{
+			return static_cast<T*>(m_Arena->Allocate(count * sizeof(T), alignof(T)));
+		}
+		void deallocate(T*, size_t)
+		{
+			// Reset frees it
+		}
+
+		FrameArena* GetArena() const { return m_Arena; }
+	private:
+		FrameArena* m_Arena;
+	};
+
+	template <typename T, typename U>
+	bool operator==(const FrameAllocator<T>& a, const FrameAllocator<U>& b) { return a.GetArena() == b.GetArena(); }
+	template <typename T, typename U>
+	bool operator!=(const FrameAllocator<T>& a, const FrameAllocator<U>& b) { return a.GetArena() != b.GetArena(); }
+
+	// Vector whose storage comes from a FrameArena
+	// e.g. FrameVector<Actor*> dead(game->GetFrameArena());
+	template <typename T>
+	using FrameVector = std::vector<T, FrameAllocator<T>>;
+}
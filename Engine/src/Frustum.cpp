@@ -0,0 +1,199 @@
+#include "Frustum.h"
+
+namespace Engine
+{
+	void SphereBoundsList::Clear()
+	{
+		m_X.clear();
+		m_Y.clear();
+		m_Z.clear();
+		m_Radius.clear();
+	}
+
+	void SphereBoundsList::Add(const Vector3& center, float radius)
+	{
+		m_X.emplace_back(center.x);
+		m_Y.emplace_back(center.y);
+		m_Z.emplace_back(center.z);
+		m_Radius.emplace_back(radius);
+	}
+
+	void BoxBoundsList::Clear()
+	{
+		m_X.clear();
+		m_Y.clear();
+		m_Z.clear();
+		m_ExtentX.clear();
+		m_ExtentY.clear();
+		m_ExtentZ.clear();
+	}
+
+	void BoxBoundsList::Add(const Vector3& center, const Vector3& extents)
+	{
+		m_X.emplace_back(center.x);
+		m_Y.emplace_back(center.y);
+		m_Z.emplace_back(center.z);
+		m_ExtentX.emplace_back(extents.x);
+		m_ExtentY.emplace_back(extents.y);
+		m_ExtentZ.emplace_back(extents.z);
+	}
+
+	Frustum::Frustum()
+	{
+		Extract(Matrix4::Identity);
+	}
+
+	void Frustum::Extract(const Matrix4& viewProj)
+	{
+		// With row vectors clip = v * viewProj, so each clip coordinate is v dotted
+		// with a column, and inside means -w <= x, y <= w and -w <= z <= w
+		// (GL clips z at -w, so use that even though our projection maps near to 0)
+		const float (*m)[4] = viewProj.mat;
+		for (int i = 0; i < 3; i++)
+		{
+			// w + coord >= 0
+			m_NormalX[i * 2] = m[0][3] + m[0][i];
+			m_NormalY[i * 2] = m[1][3] + m[1][i];
+			m_NormalZ[i * 2] = m[2][3] + m[2][i];
+			m_D[i * 2] = m[3][3] + m[3][i];
+			// w - coord >= 0
+			m_NormalX[i * 2 + 1] = m[0][3] - m[0][i];
+			m_NormalY[i * 2 + 1] = m[1][3] - m[1][i];
+			m_NormalZ[i * 2 + 1] = m[2][3] - m[2][i];
+			m_D[i * 2 + 1] = m[3][3] - m[3][i];
+		}
+
+		// Normalize, so plane distances are in world units and can be compared to radii
+		for (int i = 0; i < ENumPlanes; i++)
+		{
+			float length = CustomMath::Sqrt(m_NormalX[i] * m_NormalX[i] +
+				m_NormalY[i] * m_NormalY[i] + m_NormalZ[i] * m_NormalZ[i]);
+			if (length > 0.0f)
+			{
+				float invLength = 1.0f / length;
+				m_NormalX[i] *= invLength;
+				m_NormalY[i] *= invLength;
+				m_NormalZ[i] *= invLength;
+				m_D[i] *= invLength;
+			}
+		}
+	}
+
+	bool Frustum::IntersectsSphere(const Vector3& center, float radius) const
+	{
+		for (int i = 0; i < ENumPlanes; i++)
+		{
+			float dist = m_NormalX[i] * center.x + m_NormalY[i] * center.y +
+				m_NormalZ[i] * center.z + m_D[i];
+			if (dist < -radius)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool Frustum::IntersectsBox(const Vector3& center, const Vector3& extents) const
+	{
+		for (int i = 0; i < ENumPlanes; i++)
+		{
+			float dist = m_NormalX[i] * center.x + m_NormalY[i] * center.y +
+				m_NormalZ[i] * center.z + m_D[i];
+			// How far the box reaches towards the plane normal
+			float reach = CustomMath::Abs(m_NormalX[i]) * extents.x +
+				CustomMath::Abs(m_NormalY[i]) * extents.y +
+				CustomMath::Abs(m_NormalZ[i]) * extents.z;
+			// Whole box is behind the plane
+			if (dist + reach < 0.0f)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	size_t Frustum::CullSpheres(const SphereBoundsList& spheres, unsigned char* outVisible) const
+	{
+		const size_t count = spheres.Size();
+		size_t visible = 0;
+		size_t i = 0;
+#ifdef CUSTOMMATH_SIMD_SSE
+		// Four spheres per iteration against each plane
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 x = _mm_loadu_ps(&spheres.m_X[i]);
+			const __m128 y = _mm_loadu_ps(&spheres.m_Y[i]);
+			const __m128 z = _mm_loadu_ps(&spheres.m_Z[i]);
+			const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&spheres.m_Radius[i]));
+			__m128 outside = _mm_setzero_ps();
+			for (int p = 0; p < ENumPlanes; p++)
+			{
+				__m128 dist = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m_NormalX[p])),
+					_mm_mul_ps(y, _mm_set1_ps(m_NormalY[p])));
+				dist = _mm_add_ps(dist, _mm_mul_ps(z, _mm_set1_ps(m_NormalZ[p])));
+				dist = _mm_add_ps(dist, _mm_set1_ps(m_D[p]));
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, negRadius));
+			}
+			int mask = _mm_movemask_ps(outside);
+			for (int j = 0; j < 4; j++)
+			{
+				outVisible[i + j] = (mask & (1 << j)) ? 0 : 1;
+				visible += outVisible[i + j];
+			}
+		}
+#endif
+		for (; i < count; i++)
+		{
+			Vector3 center(spheres.m_X[i], spheres.m_Y[i], spheres.m_Z[i]);
+			outVisible[i] = IntersectsSphere(center, spheres.m_Radius[i]) ? 1 : 0;
+			visible += outVisible[i];
+		}
+		return visible;
+	}
+
+	size_t Frustum::CullBoxes(const BoxBoundsList& boxes, unsigned char* outVisible) const
+	{
+		const size_t count = boxes.Size();
+		size_t visible = 0;
+		size_t i = 0;
+#ifdef CUSTOMMATH_SIMD_SSE
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 x = _mm_loadu_ps(&boxes.m_X[i]);
+			const __m128 y = _mm_loadu_ps(&boxes.m_Y[i]);
+			const __m128 z = _mm_loadu_ps(&boxes.m_Z[i]);
+			const __m128 ex = _mm_loadu_ps(&boxes.m_ExtentX[i]);
+			const __m128 ey = _mm_loadu_ps(&boxes.m_ExtentY[i]);
+			const __m128 ez = _mm_loadu_ps(&boxes.m_ExtentZ[i]);
+			__m128 outside = _mm_setzero_ps();
+			for (int p = 0; p < ENumPlanes; p++)
+			{
+				const __m128 nx = _mm_set1_ps(m_NormalX[p]);
+				const __m128 ny = _mm_set1_ps(m_NormalY[p]);
+				const __m128 nz = _mm_set1_ps(m_NormalZ[p]);
+				__m128 dist = _mm_add_ps(_mm_mul_ps(x, nx), _mm_mul_ps(y, ny));
+				dist = _mm_add_ps(dist, _mm_mul_ps(z, nz));
+				dist = _mm_add_ps(dist, _mm_set1_ps(m_D[p]));
+				__m128 reach = _mm_add_ps(_mm_mul_ps(ex, _mm_set1_ps(CustomMath::Abs(m_NormalX[p]))),
+					_mm_mul_ps(ey, _mm_set1_ps(CustomMath::Abs(m_NormalY[p]))));
+				reach = _mm_add_ps(reach, _mm_mul_ps(ez, _mm_set1_ps(CustomMath::Abs(m_NormalZ[p]))));
+				outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dist, reach), _mm_setzero_ps()));
+			}
+			int mask = _mm_movemask_ps(outside);
+			for (int j = 0; j < 4; j++)
+			{
+				outVisible[i + j] = (mask & (1 << j)) ? 0 : 1;
+				visible += outVisible[i + j];
+			}
+		}
+#endif
+		for (; i < count; i++)
+		{
+			Vector3 center(boxes.m_X[i], boxes.m_Y[i], boxes.m_Z[i]);
+			Vector3 extents(boxes.m_ExtentX[i], boxes.m_ExtentY[i], boxes.m_ExtentZ[i]);
+			outVisible[i] = IntersectsBox(center, extents) ? 1 : 0;
+			visible += outVisible[i];
+		}
+		return visible;
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include "CustomMath.h"
+
+namespace Engine
+{
+	// Bounding spheres of many objects, one array per component
+	// so the frustum can test four of them at once
+	struct SphereBoundsList
+	{
+		void Clear();
+		void Add(const Vector3& center, float radius);
+		size_t Size() const { return m_X.size(); }
+
+		std::vector<float> m_X;
+		std::vector<float> m_Y;
+		std::vector<float> m_Z;
+		std::vector<float> m_Radius;
+	};
+
+	// Axis aligned boxes as center + half extents, one array per component
+	struct BoxBoundsList
+	{
+		void Clear();
+		void Add(const Vector3& center, const Vector3& extents);
+		size_t Size() const { return m_X.size(); }
+
+		std::vector<float> m_X;
+		std::vector<float> m_Y;
+		std::vector<float> m_Z;
+		std::vector<float> m_ExtentX;
+		std::vector<float> m_ExtentY;
+		std::vector<float> m_ExtentZ;
+	};
+
+	// The six planes of a view-projection, for rejecting objects that can't be on screen
+	// Tests are conservative: an object close to a corner of the frustum can pass
+	// even though it's outside, but nothing on screen is ever rejected
+	class Frustum
+	{
+	public:
+		enum PlaneIndex
+		{
+			ELeft,
+			ERight,
+			EBottom,
+			ETop,
+			ENear,
+			EFar,
+			ENumPlanes
+		};
+
+		Frustum();
+
+		// Get the planes from a (row vector) view-projection matrix
+		void Extract(const Matrix4& viewProj);
+
+		bool IntersectsSphere(const Vector3& center, float radius) const;
+		bool IntersectsBox(const Vector3& center, const Vector3& extents) const;
+
+		// outVisible[i] = 1 if object i is at least partly inside, 0 if not
+		// (outVisible needs room for Size() entries)
+		// Returns how many are visible
+		size_t CullSpheres(const SphereBoundsList& spheres, unsigned char* outVisible) const;
+		size_t CullBoxes(const BoxBoundsList& boxes, unsigned char* outVisible) const;
+	private:
+		// Plane i is m_NormalX[i] * x + m_NormalY[i] * y + m_NormalZ[i] * z + m_D[i] = 0,
+		// with the normal pointing into the frustum
+		float m_NormalX[ENumPlanes];
+		float m_NormalY[ENumPlanes];
+		float m_NormalZ[ENumPlanes];
+		float m_D[ENumPlanes];
+	};
+}
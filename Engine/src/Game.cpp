@@ -2,6 +2,7 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <cmath>
 #include "Actor.h"
 // https://www.libsdl.org/projects/SDL_image/
 #include "SDL_image.h"
@@ -23,6 +24,13 @@
 #include "FollowActor.h"
 #include "CameraActor.h"
 #include "PhysWorld.h"
+#include "TransformStore.h"
+#include "SpatialHash.h"
+#include "JobSystem.h"
+#include "FrameArena.h"
+#include "NavMesh.h"
+#include "PathRequestQueue.h"
+#include "BoxComponent.h"
 #include "TargetActor.h"
 #include "SDL_ttf.h"
 #include "Font.h"
@@ -35,11 +43,25 @@ namespace Engine
 {
 	const int thickness = 15;
 	const float paddleH = 100.0f;
+	// Path searching started each frame (run here, or spread over the workers)
+	const float pathBudgetMicroseconds = 1000.0f;
 
 	Game::Game():
-		m_Renderer(nullptr),
 		m_IsRunning(true),
-		m_TicksCount(0)
+		m_LastCounter(0),
+		m_CounterFrequency(1.0),
+		m_Accumulator(0.0),
+		m_FixedDeltaTime(1.0 / 60.0),
+		m_MaxSubsteps(5),
+		m_MinFrameTime(1.0 / 144.0),
+		m_Renderer(nullptr),
+		m_Transforms(nullptr),
+		m_CircleHash(nullptr),
+		m_JobSystem(nullptr),
+		m_FrameArena(nullptr),
+		m_NavMesh(nullptr),
+		m_PathRequests(nullptr),
+		m_ParallelActorUpdate(true)
 	{
 	}
 
@@ -81,8 +103,18 @@ namespace Engine
 
 		SDL_GameControllerAddMappingsFromFile("src/Assets/gamecontrollerdb.txt");
 
+		m_JobSystem = new JobSystem();
+		m_JobSystem->Initialize();
+
 		m_PhysWorld = new PhysWorld(this);
 
+		// Actors grab their transform from here, so create it before loading any
+		m_Transforms = new TransformStore();
+		m_CircleHash = new SpatialHash(64.0f);
+		m_FrameArena = new FrameArena();
+		m_NavMesh = new NavMesh();
+		m_PathRequests = new PathRequestQueue(m_NavMesh, m_JobSystem);
+
 		// Initialize SDL_ttf
 		if (TTF_Init() != 0)
 		{
@@ -95,7 +127,8 @@ namespace Engine
 
 		std::cout << __cplusplus << std::endl;
 
-		m_TicksCount = SDL_GetTicks();
+		m_CounterFrequency = static_cast<double>(SDL_GetPerformanceFrequency());
+		m_LastCounter = SDL_GetPerformanceCounter();
 
 		return true;
 	}
@@ -111,37 +144,65 @@ namespace Engine
 		{
 			m_AudioSystem->Shutdown();
 		}
+		delete m_Transforms;
+		m_Transforms = nullptr;
+		delete m_CircleHash;
+		m_CircleHash = nullptr;
+		delete m_FrameArena;
+		m_FrameArena = nullptr;
+		delete m_PathRequests;
+		m_PathRequests = nullptr;
+		delete m_NavMesh;
+		m_NavMesh = nullptr;
+		if (m_JobSystem)
+		{
+			m_JobSystem->Shutdown();
+			delete m_JobSystem;
+			m_JobSystem = nullptr;
+		}
 		SDL_Quit();
 	}
 
-	void Game::AddActor(Actor* actor)
+	SlotHandle Game::AddActor(Actor* actor)
 	{
+		// Added at the end, so update loops that stop at the count they started with skip it
+		SlotHandle handle = m_Actors.Insert(actor);
 		if (m_UpdatingActors)
 		{
-			m_PendingActors.emplace_back(actor);
-		}
-		else
-		{
-			m_Actors.emplace_back(actor);
+			m_PendingActors.emplace_back(handle);
 		}
+		return handle;
+	}
+
+	void Game::RemoveActor(SlotHandle handle)
+	{
+		// A pending handle just goes stale, the pending list skips it
+		m_Actors.Remove(handle);
+	}
+
+	Actor* Game::GetActor(SlotHandle handle)
+	{
+		Actor** actor = m_Actors.Get(handle);
+		return actor ? *actor : nullptr;
 	}
 
-	void Game::RemoveActor(Actor* actor)
+	void Game::Defer(std::function<void()> func)
 	{
-		// Is it in pending actors?
-		auto iter = std::find(m_PendingActors.begin(), m_PendingActors.end(), actor);
-		if (iter != m_PendingActors.end())
+		std::lock_guard<std::mutex> lock(m_DeferredMutex);
+		m_Deferred.emplace_back(std::move(func));
+	}
+
+	void Game::RunDeferred()
+	{
+		// Swap out first, so deferred work can defer more work (for next frame)
+		std::vector<std::function<void()>> deferred;
 		{
-			std::iter_swap(iter, m_PendingActors.end() - 1);
-			m_PendingActors.pop_back();
+			std::lock_guard<std::mutex> lock(m_DeferredMutex);
+			deferred.swap(m_Deferred);
 		}
-
-		// Is it in actors?
-		iter = std::find(m_Actors.begin(), m_Actors.end(), actor);
-		if (iter != m_Actors.end())
+		for (auto& func : deferred)
 		{
-			std::iter_swap(iter, m_Actors.end() - 1);
-			m_Actors.pop_back();
+			func();
 		}
 	}
 
@@ -239,8 +300,6 @@ namespace Engine
 
 	void Game::ProcessInput()
 	{
-		m_InputSystem->PrepareForUpdate();
-
 		SDL_Event event;
 		while (SDL_PollEvent(&event))
 		{
@@ -280,26 +339,40 @@ namespace Engine
 			}
 		}
 
+		// Actors get their input once per fixed step (see ProcessActorInput), so a frame
+		// that runs no steps doesn't lose mouse movement and one that runs several doesn't repeat it
+		if (m_GameState != EGameplay)
+		{
+			// Drop what the actors would have seen, so the camera doesn't jump on resume
+			m_InputSystem->Update();
+			m_InputSystem->PrepareForUpdate();
+			if (!m_UIStack.empty())
+			{
+				const Uint8* state = SDL_GetKeyboardState(NULL);
+				m_UIStack.back()->ProcessInput(state);
+			}
+		}
+	}
+
+	void Game::ProcessActorInput()
+	{
 		m_InputSystem->Update();
 		const InputState& state = m_InputSystem->GetState();
 
-		if (m_GameState == EGameplay)
+		m_UpdatingActors = true;
+		// By index, actors created by input are added at the end
+		const size_t actorCount = m_Actors.size();
+		for (size_t i = 0; i < actorCount && i < m_Actors.size(); i++)
 		{
-			m_UpdatingActors = true;
-			for (auto actor : m_Actors)
+			Actor* actor = m_Actors[i];
+			if (actor->GetState() == Actor::EActive)
 			{
-				if (actor->GetState() == Actor::EActive)
-				{
-					actor->ProcessInput(state);
-				}
+				actor->ProcessInput(state);
 			}
-			m_UpdatingActors = false;
-		}
-		else if (!m_UIStack.empty())
-		{
-			const Uint8* state = SDL_GetKeyboardState(NULL);
-			m_UIStack.back()->ProcessInput(state);
 		}
+		m_UpdatingActors = false;
+
+		m_InputSystem->PrepareForUpdate();
 	}
 
 	void Game::HandleKeyPress(int key)
@@ -348,46 +421,49 @@ namespace Engine
 
 	void Game::UpdateGame()
 	{
-		while (!SDL_TICKS_PASSED(SDL_GetTicks(), m_TicksCount + 16));
-
-		float deltaTime = (SDL_GetTicks() - m_TicksCount) / 1000.0f;
-
-		if (deltaTime > 0.05f)
+		// Sleep off the rest of the frame (if frames are capped)
+		if (m_MinFrameTime > 0.0)
 		{
-			deltaTime = 0.05f;
+			double elapsed = static_cast<double>(SDL_GetPerformanceCounter() - m_LastCounter) / m_CounterFrequency;
+			if (elapsed < m_MinFrameTime)
+			{
+				SDL_Delay(static_cast<Uint32>((m_MinFrameTime - elapsed) * 1000.0));
+			}
 		}
-		m_TicksCount = SDL_GetTicks();
 
-		// Update all actors
-		m_UpdatingActors = true;
-		for (auto actor : m_Actors)
+		Uint64 now = SDL_GetPerformanceCounter();
+		double frameTime = static_cast<double>(now - m_LastCounter) / m_CounterFrequency;
+		m_LastCounter = now;
+		// Don't try to make up for long stalls (window drags, breakpoints)
+		if (frameTime > 0.25)
 		{
-			actor->Update(deltaTime);
+			frameTime = 0.25;
 		}
 
-		// Move any pending actors to m_Actors
-		for (auto pending : m_PendingActors)
+		// Run as many fixed steps as the frame took
+		m_Accumulator += frameTime;
+		int steps = 0;
+		while (m_Accumulator >= m_FixedDeltaTime && steps < m_MaxSubsteps)
 		{
-			pending->ComputeWorldTransform();
-			m_Actors.emplace_back(pending);
+			StepSimulation(static_cast<float>(m_FixedDeltaTime));
+			m_Accumulator -= m_FixedDeltaTime;
+			steps++;
 		}
-		m_PendingActors.clear();
-
-		// Add any dead actors to a temp vector
-		std::vector<Actor*> deadActors;
-		for (auto actor : m_Actors)
+		// Still behind after the max steps, so drop the backlog and let the game slow down
+		if (m_Accumulator >= m_FixedDeltaTime)
 		{
-			if (actor->GetState() == Actor::EDead)
-			{
-				deadActors.emplace_back(actor);
-			}
+			m_Accumulator = std::fmod(m_Accumulator, m_FixedDeltaTime);
 		}
 
-		// Delete dead actors (which removes them from m_Actors)
-		for (auto actor : deadActors)
-		{
-			delete actor;
-		}
+		// Draw the world part of the way between the last two steps
+		float alpha = static_cast<float>(m_Accumulator / m_FixedDeltaTime);
+		m_Transforms->ComputeRenderTransforms(alpha);
+		m_Renderer->InterpolateView(alpha);
+
+		// Hand out the paths that are done and get more going
+		m_PathRequests->Update(pathBudgetMicroseconds);
+
+		float deltaTime = static_cast<float>(frameTime);
 
 		// Update audio system
 		m_AudioSystem->Update(deltaTime);
@@ -416,6 +492,94 @@ namespace Engine
 		}
 	}
 
+	void Game::StepSimulation(float deltaTime)
+	{
+		// Interpolation blends from here to wherever this step ends up
+		m_Transforms->SavePreviousState();
+		m_Renderer->SavePreviousView();
+
+		if (m_GameState == EGameplay)
+		{
+			ProcessActorInput();
+		}
+
+		// Bring world transforms up to date (e.g. actors moved by input)
+		m_Transforms->ComputeWorldTransforms();
+		// Bucket every circle for this step's queries
+		m_CircleHash->Rebuild();
+
+		// Update all actors
+		m_UpdatingActors = true;
+		// Actors created during the update go at the end, past actorCount
+		const size_t actorCount = m_Actors.size();
+		// Thread-safe components first, in chunks spread over the job system
+		if (m_ParallelActorUpdate)
+		{
+			m_JobSystem->ParallelFor(actorCount, 64, [this, deltaTime](size_t begin, size_t end)
+				{
+					for (size_t i = begin; i < end; i++)
+					{
+						m_Actors[i]->UpdateThreadSafeComponents(deltaTime);
+					}
+				});
+		}
+		// Then the rest, one actor at a time
+		// (deleting an actor here would move the last one into its spot, stay in range if that happens)
+		for (size_t i = 0; i < actorCount && i < m_Actors.size(); i++)
+		{
+			m_Actors[i]->Update(deltaTime);
+		}
+		m_UpdatingActors = false;
+		// Structural changes the jobs couldn't make themselves
+		RunDeferred();
+
+		// Recompute every world transform that changed during the update in one pass
+		m_Transforms->ComputeWorldTransforms();
+
+		// Boxes are in their new spots, gather this step's overlaps
+		m_PhysWorld->UpdateOverlaps();
+
+		// Actors created during the update join in from the next step
+		for (auto handle : m_PendingActors)
+		{
+			Actor* pending = GetActor(handle);
+			if (pending)
+			{
+				pending->ComputeWorldTransform();
+			}
+		}
+		m_PendingActors.clear();
+
+		// Add any dead actors to a temp vector (from the frame arena, nothing to free)
+		FrameVector<Actor*> deadActors(m_FrameArena);
+		for (auto actor : m_Actors)
+		{
+			if (actor->GetState() == Actor::EDead)
+			{
+				deadActors.emplace_back(actor);
+			}
+		}
+
+		// Delete dead actors (which removes them from m_Actors)
+		for (auto actor : deadActors)
+		{
+			delete actor;
+		}
+	}
+
+	void Game::SetSimulationRate(float hz)
+	{
+		if (hz > 0.0f)
+		{
+			m_FixedDeltaTime = 1.0 / hz;
+		}
+	}
+
+	void Game::SetMaxFrameRate(float fps)
+	{
+		m_MinFrameTime = fps > 0.0f ? 1.0 / fps : 0.0;
+	}
+
 	void Game::GenerateOutput()
 	{
 		m_Renderer->Draw();
@@ -426,7 +590,20 @@ namespace Engine
 		// Load English text
 		LoadText("src/Assets/UI/English.gptext");
 
-		// Create actors
+		// UI images share atlas pages, so the HUD/menus draw in a couple of batches
+		m_Renderer->LoadAtlas({
+			"src/Assets/UI/Blip.png",
+			"src/Assets/UI/ButtonBlue.png",
+			"src/Assets/UI/ButtonYellow.png",
+			"src/Assets/UI/Crosshair.png",
+			"src/Assets/UI/CrosshairRed.png",
+			"src/Assets/UI/DialogBG.png",
+			"src/Assets/UI/HealthBar.png",
+			"src/Assets/UI/Radar.png",
+			"src/Assets/UI/RadarArrow.png"
+		});
+
+		// Create actors (props only need to show up, so their meshes load in the background)
 		Actor* a = new Actor(this);
 		a->SetPosition(Vector3(200.f, 75.f, 0.f));
 		a->SetScale(100.f);
@@ -434,13 +611,13 @@ namespace Engine
 		q = Quaternion::Concatenate(q, Quaternion(Vector3::UnitZ, CustomMath::Pi + CustomMath::Pi / 4.0f));
 		a->SetRotation(q);
 		MeshComponent* mc = new MeshComponent(a);
-		mc->SetMesh(m_Renderer->GetMesh("src/Assets/3DGraphics/Cube.gpmesh"));
+		mc->SetMesh(m_Renderer->GetMeshAsync("src/Assets/3DGraphics/Cube.gpmesh"));
 
 		a = new Actor(this);
 		a->SetPosition(Vector3(200.0f, -75.0f, 0.0f));
 		a->SetScale(3.0f);
 		mc = new MeshComponent(a);
-		mc->SetMesh(m_Renderer->GetMesh("src/Assets/3DGraphics/Sphere.gpmesh"));
+		mc->SetMesh(m_Renderer->GetMeshAsync("src/Assets/3DGraphics/Sphere.gpmesh"));
 
 		//// Setup floor
 		const float start = -1250.0f;
@@ -515,6 +692,18 @@ namespace Engine
 		a->SetPosition(Vector3(1450.0f, -500.0f, 200.0f));
 		a = new TargetActor(this);
 		a->SetPosition(Vector3(1450.0f, 500.0f, 200.0f));
+
+		// Static geometry is in place, so build a good BVH for it once
+		m_Transforms->ComputeWorldTransforms();
+		m_PhysWorld->RebuildBVH();
+
+		// Floor and walls are all planes, so the nav mesh is built from their boxes
+		std::vector<AABB> navGeometry;
+		for (PlaneActor* plane : m_Planes)
+		{
+			navGeometry.emplace_back(plane->GetBox()->GetWorldBox());
+		}
+		m_NavMesh->Build(navGeometry);
 	}
 
 	void Game::UnloadData()
@@ -528,6 +717,15 @@ namespace Engine
 		{
 			m_Renderer->UnloadData();
 		}
+		if (m_PathRequests)
+		{
+			// Searches still running read the nav mesh
+			m_PathRequests->Flush();
+		}
+		if (m_NavMesh)
+		{
+			m_NavMesh->Clear();
+		}
 	}
 
 	void Game::RunLoop()
@@ -537,6 +735,8 @@ namespace Engine
 			ProcessInput();
 			UpdateGame();
 			GenerateOutput();
+			// Nothing allocated from the frame arena lives past here
+			m_FrameArena->Reset();
 		}
 	}
 }
\ No newline at end of file
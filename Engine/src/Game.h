@@ -5,8 +5,11 @@
 #include <unordered_map>
 #include <vector>
 #include <ostream>
+#include <functional>
+#include <mutex>
 #include "CustomMath.h"
 #include "SoundEvent.h"
+#include "SlotMap.h"
 
 namespace Engine
 {
@@ -19,12 +22,35 @@ namespace Engine
 		
 		void Shutdown();
 		
-		void AddActor(class Actor* actor);
-		void RemoveActor(class Actor* actor);
+		// Register/unregister an actor (done by Actor), the handle stays valid until it's removed
+		SlotHandle AddActor(class Actor* actor);
+		void RemoveActor(SlotHandle handle);
+		// nullptr once the actor is gone
+		class Actor* GetActor(SlotHandle handle);
 
 		class Renderer* GetRenderer() { return m_Renderer; }
 		class AudioSystem* GetAudioSystem() { return m_AudioSystem; }
 		class PhysWorld* GetPhysWorld() { return m_PhysWorld; }
+		class TransformStore* GetTransforms() { return m_Transforms; }
+		class SpatialHash* GetCircleHash() { return m_CircleHash; }
+		class JobSystem* GetJobSystem() { return m_JobSystem; }
+		// Scratch memory that's released at the end of every frame (main thread only)
+		class FrameArena* GetFrameArena() { return m_FrameArena; }
+		class NavMesh* GetNavMesh() { return m_NavMesh; }
+		class PathRequestQueue* GetPathRequests() { return m_PathRequests; }
+
+		// Run func on the main thread after the actor update
+		// (creating/destroying actors or components from a job has to go through here)
+		// Safe to call from any thread
+		void Defer(std::function<void()> func);
+		// Update thread-safe components in parallel before the serial actor update
+		void SetParallelActorUpdate(bool value) { m_ParallelActorUpdate = value; }
+		// Simulation runs in fixed steps of 1 / hz seconds, no matter the frame rate
+		void SetSimulationRate(float hz);
+		// Most steps to run in one frame, so a slow frame can't snowball into slower ones
+		void SetMaxSubsteps(int maxSubsteps) { m_MaxSubsteps = maxSubsteps; }
+		// Sleep at the start of a frame to stay under fps (0 to not cap it)
+		void SetMaxFrameRate(float fps);
 		class HUD* GetHUD() { return m_HUD; }
 		class FPSActor* GetPlayer() { return m_FPSActor; }
 
@@ -52,24 +78,52 @@ namespace Engine
 		std::vector<class PlaneActor*>& GetPlanes() { return m_Planes; }
 	private:
 		void ProcessInput();
+		// Hand the input gathered since the last step to the actors
+		void ProcessActorInput();
 		void HandleKeyPress(int key);
 		void UpdateGame();
+		// Advance actors and physics by one fixed step
+		void StepSimulation(float deltaTime);
 		void GenerateOutput();
 		void LoadData();
 		void UnloadData();
+		void RunDeferred();
 
 		GameState m_GameState;
 		bool m_IsRunning;
-		Uint32 m_TicksCount;
+		// Frame timing
+		Uint64 m_LastCounter;
+		double m_CounterFrequency;
+		// Time not yet simulated
+		double m_Accumulator;
+		double m_FixedDeltaTime;
+		int m_MaxSubsteps;
+		double m_MinFrameTime;
 
 		class Renderer* m_Renderer;
 		class AudioSystem* m_AudioSystem;
 		class InputSystem* m_InputSystem;
 		class PhysWorld* m_PhysWorld;
 		class HUD* m_HUD;
+		// Contiguous storage for all actor transforms
+		class TransformStore* m_Transforms;
+		// Grid of every CircleComponent, for overlap/nearest queries
+		class SpatialHash* m_CircleHash;
+		class JobSystem* m_JobSystem;
+		class FrameArena* m_FrameArena;
+		// Walkable area of the static level geometry
+		class NavMesh* m_NavMesh;
+		// Nav mesh paths for agents, spread over frames and the job workers
+		class PathRequestQueue* m_PathRequests;
+		bool m_ParallelActorUpdate;
+		// Work queued with Defer
+		std::vector<std::function<void()>> m_Deferred;
+		std::mutex m_DeferredMutex;
 
-		std::vector<class Actor*> m_Actors;
-		std::vector<class Actor*> m_PendingActors;
+		// Every actor, including ones created during the current update
+		SlotMap<class Actor*> m_Actors;
+		// Actors created during the current update (they start updating next step)
+		std::vector<SlotHandle> m_PendingActors;
 		// Track if we're updating actors right now
 		bool m_UpdatingActors;
 
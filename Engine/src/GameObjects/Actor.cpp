@@ -2,49 +2,98 @@
 #include "Actor.h"
 #include "Game.h"
 #include "Component.h"
+#include "TransformStore.h"
 
 namespace Engine
 {
+	static PoolAllocator& GetActorPool()
+	{
+		static PoolAllocator pool;
+		return pool;
+	}
+
+	void* Actor::operator new(size_t size)
+	{
+		return GetActorPool().Allocate(size);
+	}
+
+	void Actor::operator delete(void* ptr, size_t size)
+	{
+		GetActorPool().Free(ptr, size);
+	}
+
+	PoolStats Actor::GetPoolStats()
+	{
+		return GetActorPool().GetStats();
+	}
+
 	Actor::Actor(Game* game) :
 		m_State(EActive),
-		m_Position(Vector3::Zero),
-		m_Scale(1.0f),
-		m_Rotation(Quaternion::Identity),
-		m_Game(game),
-		m_RecomputeWorldTransform(true)
+		m_Transforms(game->GetTransforms()),
+		m_UpdatedInParallel(false),
+		m_Game(game)
 	{
-		m_Game->AddActor(this);
+		m_TransformHandle = m_Transforms->Add(this);
+		m_Handle = m_Game->AddActor(this);
 	}
 
 	Actor::~Actor()
 	{
-		m_Game->RemoveActor(this);
+		m_Game->RemoveActor(m_Handle);
 
 		// Because ~Component calls RemoveComponent, need a different style loop
 		while (!m_Components.empty())
 		{
 			delete m_Components.back();
 		}
+
+		m_Transforms->Remove(m_TransformHandle);
 	}
 
 	void Actor::Update(float deltaTime)
 	{
+		// World transforms are recomputed in one batch by Game::UpdateGame
 		if (m_State == EActive || m_State == EInvisible)
 		{
-			ComputeWorldTransform();
-
 			UpdateComponents(deltaTime);
 			UpdateActor(deltaTime);
-
-			ComputeWorldTransform();
 		}
 	}
 
 	void Actor::UpdateComponents(float deltaTime)
 	{
-		for (auto comp : m_Components)
+		auto iter = m_Components.begin();
+		// Skip what UpdateThreadSafeComponents already did
+		if (m_UpdatedInParallel)
 		{
-			comp->Update(deltaTime);
+			while (iter != m_Components.end() && (*iter)->IsThreadSafe())
+			{
+				++iter;
+			}
+			m_UpdatedInParallel = false;
+		}
+
+		for (; iter != m_Components.end(); ++iter)
+		{
+			(*iter)->Update(deltaTime);
+		}
+	}
+
+	void Actor::UpdateThreadSafeComponents(float deltaTime)
+	{
+		if (m_State == EActive || m_State == EInvisible)
+		{
+			// Only the thread-safe components before the first unsafe one,
+			// so components still update in their usual order
+			for (auto comp : m_Components)
+			{
+				if (!comp->IsThreadSafe())
+				{
+					break;
+				}
+				comp->Update(deltaTime);
+			}
+			m_UpdatedInParallel = true;
 		}
 	}
 
@@ -72,19 +121,19 @@ namespace Engine
 
 	void Actor::ComputeWorldTransform()
 	{
-		if (m_RecomputeWorldTransform)
+		// Only recompute this actor's WT (e.g. when it needs an up to date box mid-update)
+		if (m_Transforms->ComputeWorldTransform(m_TransformHandle))
 		{
-			m_RecomputeWorldTransform = false;
-			m_WorldTransform = Matrix4::CreateScale(m_Scale);
-			m_WorldTransform *= Matrix4::CreateFromQuaternion(m_Rotation);
-			m_WorldTransform *= Matrix4::CreateTranslation(m_Position);
-
-			for (auto comp : m_Components)
-			{
-				comp->OnUpdateWorldTransform();
-			}
+			OnWorldTransformUpdated();
 		}
+	}
 
+	void Actor::OnWorldTransformUpdated()
+	{
+		for (auto comp : m_Components)
+		{
+			comp->OnUpdateWorldTransform();
+		}
 	}
 
 	void Actor::RotateToNewForward(const Vector3& forward)
@@ -1,6 +1,9 @@
 #pragma once
 #include <vector>
 #include "CustomMath.h"
+#include "TransformStore.h"
+#include "PoolAllocator.h"
+#include "SlotMap.h"
 #include <iostream>
 
 namespace Engine
@@ -19,9 +22,19 @@ namespace Engine
 		Actor(class Game* game);
 		virtual ~Actor();
 
+		// Actors of every type come out of size class pools instead of the heap
+		// (the virtual destructor hands delete the real object's size)
+		// Only create/delete actors on the main thread, jobs go through Game::Defer
+		static void* operator new(size_t size);
+		static void operator delete(void* ptr, size_t size);
+		static PoolStats GetPoolStats();
+
 		// Update function called from Game (not overridable)
 		void Update(float deltaTime);
 		void UpdateComponents(float deltaTime);
+		// Update the leading thread-safe components (called from job system workers)
+		// Update then skips them for this frame
+		void UpdateThreadSafeComponents(float deltaTime);
 		// Any actor specific update code (overridable)
 		virtual void UpdateActor(float deltaTime);
 
@@ -31,27 +44,23 @@ namespace Engine
 		virtual void ActorInput(const struct InputState& state);
 
 		// Getters/Setters
-		const Vector3& GetPosition() const { return m_Position; }
-		void SetPosition(const Vector3& pos) {
-			m_Position = pos;
-			m_RecomputeWorldTransform = true;
-		}
-		float GetScale() const { return m_Scale; }
-		void SetScale(float scale) {
-			m_Scale = scale; 
-			m_RecomputeWorldTransform = true;
-		}
-		Quaternion GetRotation() const { return m_Rotation; }
-		void SetRotation(Quaternion rotation) {
-			m_Rotation = rotation; 
-			m_RecomputeWorldTransform = true;
-		}
+		// The transform itself lives in the game's TransformStore
+		const Vector3& GetPosition() const { return m_Transforms->GetPosition(m_TransformHandle); }
+		void SetPosition(const Vector3& pos) { m_Transforms->SetPosition(m_TransformHandle, pos); }
+		float GetScale() const { return m_Transforms->GetScale(m_TransformHandle); }
+		void SetScale(float scale) { m_Transforms->SetScale(m_TransformHandle, scale); }
+		Quaternion GetRotation() const { return m_Transforms->GetRotation(m_TransformHandle); }
+		void SetRotation(Quaternion rotation) { m_Transforms->SetRotation(m_TransformHandle, rotation); }
 
 		void ComputeWorldTransform();
-		const Matrix4& GetWorldTransform() const { return m_WorldTransform; }
+		const Matrix4& GetWorldTransform() const { return m_Transforms->GetWorldTransform(m_TransformHandle); }
+		// World transform interpolated between simulation steps, for drawing
+		const Matrix4& GetRenderTransform() const { return m_Transforms->GetRenderTransform(m_TransformHandle); }
+		// Called when the world transform was recomputed
+		void OnWorldTransformUpdated();
 
-		Vector3 GetForward() const { return Vector3::Transform(Vector3::UnitX, m_Rotation); }
-		Vector3 GetRight() const { return Vector3::Transform(Vector3::UnitY, m_Rotation); }
+		Vector3 GetForward() const { return Vector3::Transform(Vector3::UnitX, GetRotation()); }
+		Vector3 GetRight() const { return Vector3::Transform(Vector3::UnitY, GetRotation()); }
 
 		void RotateToNewForward(const Vector3& forward);
 
@@ -59,6 +68,8 @@ namespace Engine
 		void SetState(State state) { m_State = state; }
 
 		class Game* GetGame() { return m_Game; }
+		// Handle in the game's actor list (Game::GetActor turns it back into the actor while it's alive)
+		SlotHandle GetHandle() const { return m_Handle; }
 
 		void AddComponent(class Component* component);
 		void RemoveComponent(class Component* component);
@@ -69,14 +80,15 @@ namespace Engine
 		// Transform
 		// We need a Matrix4 because the vertex layout assumes 3D (x, y, z), even if the z component is not used in 2D
 		// Homogenous coordinates for 3D are (x, y, z, w)
-		Matrix4 m_WorldTransform;
-		Vector3 m_Position;
-		float m_Scale;
-		Quaternion m_Rotation;
-		// We recompute the WT only if one of the components changes
-		bool m_RecomputeWorldTransform;
+		// The position/scale/rotation and the world transform are stored contiguously in the TransformStore,
+		// which only recomputes the WT if one of the components changes
+		class TransformStore* m_Transforms;
+		TransformHandle m_TransformHandle;
 
 		std::vector<class Component*> m_Components;
+		// The thread-safe components were already updated this frame
+		bool m_UpdatedInParallel;
 		class Game* m_Game;
+		SlotHandle m_Handle;
 	};
 }
\ No newline at end of file
@@ -29,6 +29,7 @@ namespace Engine
 
 		m_Circle = new CircleComponent(this);
 		m_Circle->SetRadius(40.0f);
+		m_Circle->SetLayer(CircleComponent::ELayerAsteroid);
 
 		game->AddAsteroid(this);
 	}
@@ -4,7 +4,7 @@
 #include "MoveComponent.h"
 #include "Game.h"
 #include "CircleComponent.h"
-#include "Asteroid.h"
+#include "SpatialHash.h"
 #include "Texture.h"
 
 namespace Engine
@@ -24,6 +24,7 @@ namespace Engine
 
 		m_Circle = new CircleComponent(this);
 		m_Circle->SetRadius(11.0f);
+		m_Circle->SetLayer(CircleComponent::ELayerProjectile);
 	}
 
 	void Laser::UpdateActor(float deltaTime)
@@ -38,14 +39,13 @@ namespace Engine
 		}
 		else
 		{
-			for (auto ast : GetGame()->GetAsteroids())
+			std::vector<CircleComponent*> hits;
+			GetGame()->GetCircleHash()->QueryRadius(m_Circle->GetCenter(), m_Circle->GetRadius(),
+				CircleComponent::ELayerAsteroid, hits);
+			if (!hits.empty())
 			{
-				if (CircleComponent::Intersect(*m_Circle, *(ast->GetCircle())))
-				{
-					SetState(EDead);
-					ast->SetState(EDead);
-					break;
-				}
+				SetState(EDead);
+				hits[0]->GetOwner()->SetState(EDead);
 			}
 		}
 	}
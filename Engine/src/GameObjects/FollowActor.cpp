@@ -12,7 +12,8 @@ namespace Engine
 		:Actor(game)
 	{
 		m_MeshComp = new MeshComponent(this);
-		m_MeshComp->SetMesh(game->GetRenderer()->GetMesh("src/Assets/3DGraphics/RacingCar.gpmesh"));
+		// Big mesh and nothing depends on its bounds, so stream it in
+		m_MeshComp->SetMesh(game->GetRenderer()->GetMeshAsync("src/Assets/3DGraphics/RacingCar.gpmesh"));
 		SetPosition(Vector3(0.0f, 0.0f, -100.0f));
 
 		m_InputComp = new InputComponent(this);
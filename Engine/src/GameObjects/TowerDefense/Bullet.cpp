@@ -4,7 +4,7 @@
 #include "SpriteComponent.h"
 #include "MoveComponent.h"
 #include "CircleComponent.h"
-#include "Enemy.h"
+#include "SpatialHash.h"
 
 namespace Engine
 {
@@ -21,6 +21,7 @@ namespace Engine
 
 		m_Circle = new CircleComponent(this);
 		m_Circle->SetRadius(5.0f);
+		m_Circle->SetLayer(CircleComponent::ELayerProjectile);
 
 		m_LiveTime = 1.0f;
 	}
@@ -29,16 +30,15 @@ namespace Engine
 	{
 		Actor::UpdateActor(deltaTime);
 
-		// Check for collision vs enemies
-		for (Enemy* e : GetGame()->GetEnemies())
+		// Check for collision vs enemies near the bullet
+		std::vector<CircleComponent*> hits;
+		GetGame()->GetCircleHash()->QueryRadius(m_Circle->GetCenter(), m_Circle->GetRadius(),
+			CircleComponent::ELayerEnemy, hits);
+		if (!hits.empty())
 		{
-			if (CircleComponent::Intersect(*m_Circle, *(e->GetCircle())))
-			{
-				// We both die on collision
-				e->SetState(EDead);
-				SetState(EDead);
-				break;
-			}
+			// We both die on collision
+			hits[0]->GetOwner()->SetState(EDead);
+			SetState(EDead);
 		}
 
 		m_LiveTime -= deltaTime;
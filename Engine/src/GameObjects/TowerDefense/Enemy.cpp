@@ -12,7 +12,7 @@ namespace Engine
 	Enemy::Enemy(Game* game) :
 		Actor(game)
 	{
-		game->GetEnemies().emplace_back(this);
+		m_EnemyHandle = game->GetEnemies().Insert(this);
 
 		SpriteComponent* sc = new SpriteComponent(this);
 		sc->SetTexture(game->GetTexture("src/Assets/TowerDefense/Airplane.png"));
@@ -28,15 +28,13 @@ namespace Engine
 
 		m_Circle = new CircleComponent(this);
 		m_Circle->SetRadius(25.0f);
+		m_Circle->SetLayer(CircleComponent::ELayerEnemy);
 	}
 
 	Enemy::~Enemy()
 	{
-		// Remove from enemy vector
-		auto iter = std::find(GetGame()->GetEnemies().begin(),
-			GetGame()->GetEnemies().end(),
-			this);
-		GetGame()->GetEnemies().erase(iter);
+		// Remove from enemy list (O(1), the last enemy takes this one's spot)
+		GetGame()->GetEnemies().Remove(m_EnemyHandle);
 	}
 
 	void Enemy::UpdateActor(float deltaTime)
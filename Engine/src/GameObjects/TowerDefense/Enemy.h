@@ -12,5 +12,7 @@ namespace Engine
 		class CircleComponent* GetCircle() { return m_Circle; }
 	private:
 		class CircleComponent* m_Circle;
+		// Handle in the game's enemy list
+		SlotHandle m_EnemyHandle;
 	};
 }
@@ -2,7 +2,8 @@
 #include "Tower.h"
 #include "Game.h"
 #include "SpriteComponent.h"
-#include "Enemy.h"
+#include "CircleComponent.h"
+#include "SpatialHash.h"
 #include "Bullet.h"
 #include "MoveComponent.h"
 
@@ -27,9 +28,12 @@ namespace Engine
 		m_NextAttack -= deltaTime;
 		if (m_NextAttack <= 0.0f)
 		{
-			Enemy* e = GetGame()->GetNearestEnemy(GetPosition());
-			if (e != nullptr)
+			// Nearest enemy within range
+			CircleComponent* target = GetGame()->GetCircleHash()->QueryNearest(GetPosition(),
+				AttackRange, CircleComponent::ELayerEnemy);
+			if (target != nullptr)
 			{
+				Actor* e = target->GetOwner();
 				Vector2 dir = e->GetPosition() - GetPosition();
 				float dist = dir.Length();
 				if (dist < AttackRange)
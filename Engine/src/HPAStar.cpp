@@ -0,0 +1,502 @@
+#include "HPAStar.h"
+#include "PathGrid.h"
+#include <algorithm>
+
+namespace Engine
+{
+	// Openings at least this wide get a crossing at each end instead of one in the middle
+	static const int WideEntrance = 6;
+
+	HPAStar::HPAStar(int clusterSize) :
+		m_Grid(nullptr),
+		m_Version(0),
+		m_ClusterSize(clusterSize > 1 ? clusterSize : 2),
+		m_ClustersX(0),
+		m_ClustersY(0),
+		m_LocalGeneration(0),
+		m_Search(0),
+		m_NodesExpanded(0)
+	{
+	}
+
+	void HPAStar::Build(const PathGrid& grid)
+	{
+		m_Grid = &grid;
+		m_Version = grid.GetVersion();
+		m_ClustersX = (grid.GetWidth() + m_ClusterSize - 1) / m_ClusterSize;
+		m_ClustersY = (grid.GetHeight() + m_ClusterSize - 1) / m_ClusterSize;
+
+		m_Nodes.clear();
+		m_FreeNodes.clear();
+		m_CellNodes.assign(grid.GetCellCount(), -1);
+		m_ClusterNodes.assign(GetClusterCount(), std::vector<int>());
+		m_Borders.assign(GetClusterCount() * 2, Border());
+
+		const int localCount = m_ClusterSize * m_ClusterSize;
+		m_LocalCost.assign(localCount, 0.0f);
+		m_LocalParent.assign(localCount, -1);
+		m_LocalSearch.assign(localCount, 0);
+		m_LocalGeneration = 0;
+		m_LocalOpen.Reserve(localCount);
+
+		for (int cy = 0; cy < m_ClustersY; cy++)
+		{
+			for (int cx = 0; cx < m_ClustersX; cx++)
+			{
+				if (cx + 1 < m_ClustersX)
+				{
+					BuildBorder(cx, cy, true);
+				}
+				if (cy + 1 < m_ClustersY)
+				{
+					BuildBorder(cx, cy, false);
+				}
+			}
+		}
+		for (int cluster = 0; cluster < GetClusterCount(); cluster++)
+		{
+			LinkCluster(cluster);
+		}
+	}
+
+	void HPAStar::OnCellChanged(int cell)
+	{
+		m_Version = m_Grid->GetVersion();
+		const int x = m_Grid->GetX(cell);
+		const int y = m_Grid->GetY(cell);
+		const int cx = x / m_ClusterSize;
+		const int cy = y / m_ClusterSize;
+
+		// A cell on the edge of its cluster can open or close a crossing,
+		// which changes the nodes of the cluster next door too
+		std::vector<int> relink;
+		relink.emplace_back(cy * m_ClustersX + cx);
+		if (x % m_ClusterSize == 0 && cx > 0)
+		{
+			ClearBorder(GetRightBorder(cx - 1, cy));
+			BuildBorder(cx - 1, cy, true);
+			relink.emplace_back(cy * m_ClustersX + cx - 1);
+		}
+		if ((x % m_ClusterSize == m_ClusterSize - 1 || x == m_Grid->GetWidth() - 1) && cx + 1 < m_ClustersX)
+		{
+			ClearBorder(GetRightBorder(cx, cy));
+			BuildBorder(cx, cy, true);
+			relink.emplace_back(cy * m_ClustersX + cx + 1);
+		}
+		if (y % m_ClusterSize == 0 && cy > 0)
+		{
+			ClearBorder(GetBottomBorder(cx, cy - 1));
+			BuildBorder(cx, cy - 1, false);
+			relink.emplace_back((cy - 1) * m_ClustersX + cx);
+		}
+		if ((y % m_ClusterSize == m_ClusterSize - 1 || y == m_Grid->GetHeight() - 1) && cy + 1 < m_ClustersY)
+		{
+			ClearBorder(GetBottomBorder(cx, cy));
+			BuildBorder(cx, cy, false);
+			relink.emplace_back((cy + 1) * m_ClustersX + cx);
+		}
+
+		for (int cluster : relink)
+		{
+			LinkCluster(cluster);
+		}
+	}
+
+	bool HPAStar::FindPath(int start, int goal, std::vector<int>& outPath)
+	{
+		outPath.clear();
+		m_NodesExpanded = 0;
+		const int cellCount = m_Grid ? m_Grid->GetCellCount() : 0;
+		if (start < 0 || goal < 0 || start >= cellCount || goal >= cellCount ||
+			m_Grid->IsBlocked(start) || m_Grid->IsBlocked(goal))
+		{
+			return false;
+		}
+		if (start == goal)
+		{
+			outPath.emplace_back(start);
+			return true;
+		}
+
+		// Start and goal go in as extra nodes linked to the nodes of their clusters
+		const int startId = static_cast<int>(m_Nodes.size());
+		const int goalId = startId + 1;
+		const int startCluster = GetCluster(start);
+		const int goalCluster = GetCluster(goal);
+
+		m_StartEdges.clear();
+		SearchCluster(startCluster, start, false, -1);
+		for (int node : m_ClusterNodes[startCluster])
+		{
+			if (HasLocalCost(m_Nodes[node].m_Cell))
+			{
+				m_StartEdges.emplace_back(Edge{ node, GetLocalCost(m_Nodes[node].m_Cell), false });
+			}
+		}
+		if (startCluster == goalCluster && HasLocalCost(goal))
+		{
+			m_StartEdges.emplace_back(Edge{ goalId, GetLocalCost(goal), false });
+		}
+
+		// Costs into the goal, so search backwards from it
+		m_GoalEdges.clear();
+		SearchCluster(goalCluster, goal, true, -1);
+		for (int node : m_ClusterNodes[goalCluster])
+		{
+			if (HasLocalCost(m_Nodes[node].m_Cell))
+			{
+				m_GoalEdges.emplace_back(Edge{ node, GetLocalCost(m_Nodes[node].m_Cell), false });
+			}
+		}
+
+		// A* over the nodes
+		const int searchCount = goalId + 1;
+		if (static_cast<int>(m_SearchNodes.size()) < searchCount)
+		{
+			m_SearchNodes.resize(searchCount, SearchNode{ 0.0f, -1, 0, false });
+			m_Open.Reserve(searchCount);
+		}
+		m_Search++;
+		if (m_Search == 0)
+		{
+			for (auto& node : m_SearchNodes)
+			{
+				node.m_Search = 0;
+			}
+			m_Search = 1;
+		}
+
+		auto getCell = [&](int id)
+		{
+			return id == startId ? start : (id == goalId ? goal : m_Nodes[id].m_Cell);
+		};
+		auto relax = [&](int from, int to, float cost)
+		{
+			SearchNode& node = m_SearchNodes[to];
+			float g = m_SearchNodes[from].m_G + cost;
+			if (node.m_Search != m_Search)
+			{
+				node.m_Search = m_Search;
+				node.m_Closed = false;
+			}
+			else if (node.m_Closed || g >= node.m_G)
+			{
+				return;
+			}
+			node.m_G = g;
+			node.m_Parent = from;
+			m_Open.Push(to, g + m_Grid->Heuristic(getCell(to), goal));
+		};
+
+		SearchNode& first = m_SearchNodes[startId];
+		first.m_G = 0.0f;
+		first.m_Parent = -1;
+		first.m_Search = m_Search;
+		first.m_Closed = false;
+		m_Open.Push(startId, m_Grid->Heuristic(start, goal));
+
+		bool found = false;
+		while (!m_Open.IsEmpty())
+		{
+			int current = m_Open.Pop();
+			m_SearchNodes[current].m_Closed = true;
+			m_NodesExpanded++;
+			if (current == goalId)
+			{
+				found = true;
+				break;
+			}
+
+			const std::vector<Edge>& edges = current == startId ? m_StartEdges : m_Nodes[current].m_Edges;
+			for (const Edge& edge : edges)
+			{
+				relax(current, edge.m_To, edge.m_Cost);
+			}
+			if (current != startId && GetCluster(m_Nodes[current].m_Cell) == goalCluster)
+			{
+				for (const Edge& edge : m_GoalEdges)
+				{
+					if (edge.m_To == current)
+					{
+						relax(current, goalId, edge.m_Cost);
+					}
+				}
+			}
+		}
+		m_Open.Clear();
+		if (!found)
+		{
+			return false;
+		}
+
+		m_AbstractPath.clear();
+		for (int id = goalId; id != -1; id = m_SearchNodes[id].m_Parent)
+		{
+			m_AbstractPath.emplace_back(getCell(id));
+		}
+		std::reverse(m_AbstractPath.begin(), m_AbstractPath.end());
+
+		// Refine: crossings are single steps, links inside a cluster get searched again
+		outPath.emplace_back(start);
+		for (size_t i = 1; i < m_AbstractPath.size(); i++)
+		{
+			int from = m_AbstractPath[i - 1];
+			int to = m_AbstractPath[i];
+			if (from == to)
+			{
+				continue;
+			}
+			int cluster = GetCluster(from);
+			if (cluster != GetCluster(to))
+			{
+				outPath.emplace_back(to);
+			}
+			else
+			{
+				SearchCluster(cluster, from, false, to);
+				AppendLocalPath(from, to, outPath);
+			}
+		}
+		return true;
+	}
+
+	bool HPAStar::IsUpToDate() const
+	{
+		return m_Grid && m_Version == m_Grid->GetVersion();
+	}
+
+	int HPAStar::GetCluster(int cell) const
+	{
+		return (m_Grid->GetY(cell) / m_ClusterSize) * m_ClustersX + m_Grid->GetX(cell) / m_ClusterSize;
+	}
+
+	void HPAStar::BuildBorder(int cx, int cy, bool right)
+	{
+		Border& border = m_Borders[right ? GetRightBorder(cx, cy) : GetBottomBorder(cx, cy)];
+
+		// Walk along the border, a is this cluster's side and b the other one's
+		int length;
+		int ax, ay, stepX, stepY, crossX, crossY;
+		if (right)
+		{
+			ax = (cx + 1) * m_ClusterSize - 1;
+			ay = cy * m_ClusterSize;
+			length = std::min(m_ClusterSize, m_Grid->GetHeight() - ay);
+			stepX = 0; stepY = 1;
+			crossX = 1; crossY = 0;
+		}
+		else
+		{
+			ax = cx * m_ClusterSize;
+			ay = (cy + 1) * m_ClusterSize - 1;
+			length = std::min(m_ClusterSize, m_Grid->GetWidth() - ax);
+			stepX = 1; stepY = 0;
+			crossX = 0; crossY = 1;
+		}
+
+		auto addCrossing = [&](int i)
+		{
+			int a = m_Grid->GetIndex(ax + i * stepX, ay + i * stepY);
+			int b = m_Grid->GetIndex(ax + i * stepX + crossX, ay + i * stepY + crossY);
+			int nodeA = AddNodeRef(a);
+			int nodeB = AddNodeRef(b);
+			m_Nodes[nodeA].m_Edges.emplace_back(Edge{ nodeB, m_Grid->GetStepCost(a, b), true });
+			m_Nodes[nodeB].m_Edges.emplace_back(Edge{ nodeA, m_Grid->GetStepCost(b, a), true });
+			border.m_Crossings.emplace_back(a, b);
+		};
+
+		// Each run of open pairs is one entrance
+		int runStart = -1;
+		for (int i = 0; i <= length; i++)
+		{
+			bool open = false;
+			if (i < length)
+			{
+				int a = m_Grid->GetIndex(ax + i * stepX, ay + i * stepY);
+				int b = m_Grid->GetIndex(ax + i * stepX + crossX, ay + i * stepY + crossY);
+				open = !m_Grid->IsBlocked(a) && !m_Grid->IsBlocked(b);
+			}
+			if (open && runStart < 0)
+			{
+				runStart = i;
+			}
+			else if (!open && runStart >= 0)
+			{
+				int runEnd = i - 1;
+				if (runEnd - runStart + 1 >= WideEntrance)
+				{
+					addCrossing(runStart);
+					addCrossing(runEnd);
+				}
+				else
+				{
+					addCrossing((runStart + runEnd) / 2);
+				}
+				runStart = -1;
+			}
+		}
+	}
+
+	void HPAStar::ClearBorder(int border)
+	{
+		for (const auto& crossing : m_Borders[border].m_Crossings)
+		{
+			RemoveEdge(m_CellNodes[crossing.first], m_CellNodes[crossing.second]);
+			RemoveEdge(m_CellNodes[crossing.second], m_CellNodes[crossing.first]);
+			RemoveNodeRef(crossing.first);
+			RemoveNodeRef(crossing.second);
+		}
+		m_Borders[border].m_Crossings.clear();
+	}
+
+	void HPAStar::LinkCluster(int cluster)
+	{
+		const std::vector<int>& nodes = m_ClusterNodes[cluster];
+		for (int node : nodes)
+		{
+			auto& edges = m_Nodes[node].m_Edges;
+			edges.erase(std::remove_if(edges.begin(), edges.end(),
+				[](const Edge& edge)
+				{
+					return !edge.m_Inter;
+				}), edges.end());
+		}
+
+		for (int node : nodes)
+		{
+			SearchCluster(cluster, m_Nodes[node].m_Cell, false, -1);
+			for (int other : nodes)
+			{
+				int cell = m_Nodes[other].m_Cell;
+				if (other != node && HasLocalCost(cell))
+				{
+					m_Nodes[node].m_Edges.emplace_back(Edge{ other, GetLocalCost(cell), false });
+				}
+			}
+		}
+	}
+
+	int HPAStar::AddNodeRef(int cell)
+	{
+		int node = m_CellNodes[cell];
+		if (node < 0)
+		{
+			if (!m_FreeNodes.empty())
+			{
+				node = m_FreeNodes.back();
+				m_FreeNodes.pop_back();
+			}
+			else
+			{
+				node = static_cast<int>(m_Nodes.size());
+				m_Nodes.emplace_back();
+			}
+			m_Nodes[node].m_Cell = cell;
+			m_Nodes[node].m_Refs = 0;
+			m_Nodes[node].m_Edges.clear();
+			m_CellNodes[cell] = node;
+			m_ClusterNodes[GetCluster(cell)].emplace_back(node);
+		}
+		m_Nodes[node].m_Refs++;
+		return node;
+	}
+
+	void HPAStar::RemoveNodeRef(int cell)
+	{
+		int node = m_CellNodes[cell];
+		if (--m_Nodes[node].m_Refs > 0)
+		{
+			return;
+		}
+
+		// Links inside the cluster get redone by LinkCluster afterwards
+		m_Nodes[node].m_Edges.clear();
+		m_CellNodes[cell] = -1;
+		auto& clusterNodes = m_ClusterNodes[GetCluster(cell)];
+		auto iter = std::find(clusterNodes.begin(), clusterNodes.end(), node);
+		std::iter_swap(iter, clusterNodes.end() - 1);
+		clusterNodes.pop_back();
+		m_FreeNodes.emplace_back(node);
+	}
+
+	void HPAStar::RemoveEdge(int from, int to)
+	{
+		auto& edges = m_Nodes[from].m_Edges;
+		for (size_t i = 0; i < edges.size(); i++)
+		{
+			if (edges[i].m_To == to && edges[i].m_Inter)
+			{
+				edges[i] = edges.back();
+				edges.pop_back();
+				return;
+			}
+		}
+	}
+
+	void HPAStar::SearchCluster(int cluster, int source, bool reverse, int target)
+	{
+		m_LocalGeneration++;
+		if (m_LocalGeneration == 0)
+		{
+			std::fill(m_LocalSearch.begin(), m_LocalSearch.end(), 0);
+			m_LocalGeneration = 1;
+		}
+
+		int local = GetLocal(source);
+		m_LocalSearch[local] = m_LocalGeneration;
+		m_LocalCost[local] = 0.0f;
+		m_LocalParent[local] = -1;
+		m_LocalOpen.Push(local, 0.0f);
+
+		// Cells in a cluster are local to its corner, row by row
+		const int x0 = (cluster % m_ClustersX) * m_ClusterSize;
+		const int y0 = (cluster / m_ClustersX) * m_ClusterSize;
+		int cells[8];
+		float costs[8];
+		while (!m_LocalOpen.IsEmpty())
+		{
+			int current = m_LocalOpen.Pop();
+			int cell = m_Grid->GetIndex(x0 + current % m_ClusterSize, y0 + current / m_ClusterSize);
+			if (cell == target)
+			{
+				break;
+			}
+
+			const float cost = m_LocalCost[current];
+			int count = m_Grid->GetNeighbors(cell, cells, costs);
+			for (int i = 0; i < count; i++)
+			{
+				int neighbor = cells[i];
+				if (GetCluster(neighbor) != cluster)
+				{
+					continue;
+				}
+				float newCost = cost + (reverse ? m_Grid->GetStepCost(neighbor, cell) : costs[i]);
+				int n = GetLocal(neighbor);
+				if (m_LocalSearch[n] != m_LocalGeneration || newCost < m_LocalCost[n])
+				{
+					m_LocalSearch[n] = m_LocalGeneration;
+					m_LocalCost[n] = newCost;
+					m_LocalParent[n] = cell;
+					m_LocalOpen.Push(n, newCost);
+				}
+			}
+		}
+		m_LocalOpen.Clear();
+	}
+
+	int HPAStar::GetLocal(int cell) const
+	{
+		return (m_Grid->GetY(cell) % m_ClusterSize) * m_ClusterSize + m_Grid->GetX(cell) % m_ClusterSize;
+	}
+
+	void HPAStar::AppendLocalPath(int from, int to, std::vector<int>& outPath)
+	{
+		size_t first = outPath.size();
+		for (int cell = to; cell != from && cell != -1; cell = m_LocalParent[GetLocal(cell)])
+		{
+			outPath.emplace_back(cell);
+		}
+		std::reverse(outPath.begin() + first, outPath.end());
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "IndexedHeap.h"
+
+namespace Engine
+{
+	class PathGrid;
+
+	// Hierarchical A* (HPA*) over a PathGrid
+	// The grid is cut into square clusters. Open cells on either side of a cluster
+	// border become entrance nodes, and nodes in the same cluster are linked with the
+	// cost of the best path between them inside it. A search runs over that small
+	// graph first, then only the clusters on the result are searched cell by cell.
+	// Paths come out close to, but not always exactly, the shortest.
+	class HPAStar
+	{
+	public:
+		HPAStar(int clusterSize = 16);
+
+		// Cluster the grid and link up every cluster (keeps a pointer to grid)
+		void Build(const PathGrid& grid);
+		// Redo the cluster holding cell (and its neighbours' links) after the cell's cost changed
+		void OnCellChanged(int cell);
+
+		// Fills outPath with the cells from start to goal (both included)
+		// Returns false (and leaves outPath empty) if there's no path
+		// Unlike AStar, start has to be an open cell
+		bool FindPath(int start, int goal, std::vector<int>& outPath);
+
+		int GetClusterSize() const { return m_ClusterSize; }
+		int GetClusterCount() const { return m_ClustersX * m_ClustersY; }
+		int GetNodeCount() const { return static_cast<int>(m_Nodes.size() - m_FreeNodes.size()); }
+		// Abstract nodes taken off the open set by the last FindPath
+		int GetNodesExpanded() const { return m_NodesExpanded; }
+		// False once the grid changed without OnCellChanged being called
+		bool IsUpToDate() const;
+	private:
+		struct Edge
+		{
+			int m_To;
+			float m_Cost;
+			// Between clusters (kept when a cluster's own links are redone)
+			bool m_Inter;
+		};
+		struct Node
+		{
+			int m_Cell;
+			// How many border crossings use this cell, the node goes when it hits 0
+			int m_Refs;
+			std::vector<Edge> m_Edges;
+		};
+		// Cell pairs (one each side) where a path can cross a border
+		struct Border
+		{
+			std::vector<std::pair<int, int>> m_Crossings;
+		};
+
+		int GetCluster(int cell) const;
+		// Borders are numbered: first the ones to the right of each cluster, then the ones below
+		int GetRightBorder(int cx, int cy) const { return cy * m_ClustersX + cx; }
+		int GetBottomBorder(int cx, int cy) const { return GetClusterCount() + cy * m_ClustersX + cx; }
+		void BuildBorder(int cx, int cy, bool right);
+		void ClearBorder(int border);
+		void LinkCluster(int cluster);
+		int AddNodeRef(int cell);
+		void RemoveNodeRef(int cell);
+		void RemoveEdge(int from, int to);
+
+		// Dijkstra from source inside one cluster; reverse gives costs *to* source instead
+		// Stops early once target is reached (target -1 searches the whole cluster)
+		void SearchCluster(int cluster, int source, bool reverse, int target);
+		int GetLocal(int cell) const;
+		bool HasLocalCost(int cell) const { return m_LocalSearch[GetLocal(cell)] == m_LocalGeneration; }
+		float GetLocalCost(int cell) const { return m_LocalCost[GetLocal(cell)]; }
+		// Appends the cells after from up to and including to (from the last SearchCluster)
+		void AppendLocalPath(int from, int to, std::vector<int>& outPath);
+
+		const PathGrid* m_Grid;
+		uint32_t m_Version;
+		int m_ClusterSize;
+		int m_ClustersX;
+		int m_ClustersY;
+
+		std::vector<Node> m_Nodes;
+		std::vector<int> m_FreeNodes;
+		// Node at each cell, -1 for none
+		std::vector<int> m_CellNodes;
+		std::vector<std::vector<int>> m_ClusterNodes;
+		std::vector<Border> m_Borders;
+
+		// Search state inside a cluster, stamped so it doesn't need clearing
+		std::vector<float> m_LocalCost;
+		std::vector<int> m_LocalParent;
+		std::vector<uint32_t> m_LocalSearch;
+		uint32_t m_LocalGeneration;
+		IndexedHeap m_LocalOpen;
+
+		// Search state over the nodes (plus start and goal at the end)
+		struct SearchNode
+		{
+			float m_G;
+			int m_Parent;
+			uint32_t m_Search;
+			bool m_Closed;
+		};
+		std::vector<SearchNode> m_SearchNodes;
+		uint32_t m_Search;
+		IndexedHeap m_Open;
+		std::vector<Edge> m_StartEdges;
+		std::vector<Edge> m_GoalEdges;
+		std::vector<int> m_AbstractPath;
+		int m_NodesExpanded;
+	};
+}
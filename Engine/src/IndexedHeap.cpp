@@ -0,0 +1,110 @@
+#include "IndexedHeap.h"
+
+namespace Engine
+{
+	IndexedHeap::IndexedHeap()
+	{
+	}
+
+	void IndexedHeap::Reserve(int capacity)
+	{
+		m_Heap.clear();
+		m_Heap.reserve(capacity);
+		m_Positions.assign(capacity, -1);
+	}
+
+	void IndexedHeap::Clear()
+	{
+		for (const auto& entry : m_Heap)
+		{
+			m_Positions[entry.m_Id] = -1;
+		}
+		m_Heap.clear();
+	}
+
+	void IndexedHeap::Push(int id, float priority)
+	{
+		int pos = m_Positions[id];
+		if (pos < 0)
+		{
+			m_Heap.emplace_back(Entry{ priority, id });
+			pos = static_cast<int>(m_Heap.size()) - 1;
+			m_Positions[id] = pos;
+			SiftUp(pos);
+		}
+		else if (priority < m_Heap[pos].m_Priority)
+		{
+			m_Heap[pos].m_Priority = priority;
+			SiftUp(pos);
+		}
+		else
+		{
+			m_Heap[pos].m_Priority = priority;
+			SiftDown(pos);
+		}
+	}
+
+	int IndexedHeap::Pop()
+	{
+		int top = m_Heap[0].m_Id;
+		m_Positions[top] = -1;
+
+		Entry last = m_Heap.back();
+		m_Heap.pop_back();
+		if (!m_Heap.empty())
+		{
+			Place(0, last.m_Id, last.m_Priority);
+			SiftDown(0);
+		}
+		return top;
+	}
+
+	void IndexedHeap::SiftUp(int pos)
+	{
+		// Move the hole up until the parent is no bigger
+		Entry entry = m_Heap[pos];
+		while (pos > 0)
+		{
+			int parent = (pos - 1) / 2;
+			if (m_Heap[parent].m_Priority <= entry.m_Priority)
+			{
+				break;
+			}
+			Place(pos, m_Heap[parent].m_Id, m_Heap[parent].m_Priority);
+			pos = parent;
+		}
+		Place(pos, entry.m_Id, entry.m_Priority);
+	}
+
+	void IndexedHeap::SiftDown(int pos)
+	{
+		Entry entry = m_Heap[pos];
+		const int size = static_cast<int>(m_Heap.size());
+		while (true)
+		{
+			int child = pos * 2 + 1;
+			if (child >= size)
+			{
+				break;
+			}
+			if (child + 1 < size && m_Heap[child + 1].m_Priority < m_Heap[child].m_Priority)
+			{
+				child++;
+			}
+			if (entry.m_Priority <= m_Heap[child].m_Priority)
+			{
+				break;
+			}
+			Place(pos, m_Heap[child].m_Id, m_Heap[child].m_Priority);
+			pos = child;
+		}
+		Place(pos, entry.m_Id, entry.m_Priority);
+	}
+
+	void IndexedHeap::Place(int pos, int id, float priority)
+	{
+		m_Heap[pos].m_Id = id;
+		m_Heap[pos].m_Priority = priority;
+		m_Positions[id] = pos;
+	}
+}
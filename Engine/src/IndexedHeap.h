@@ -0,0 +1,43 @@
+#pragma once
+#include <vector>
+
+namespace Engine
+{
+	// Binary min heap of ids in [0, capacity) keyed by float priority
+	// Each id knows its spot in the heap, so checking membership and lowering
+	// an id's priority (decrease-key) don't need a search
+	class IndexedHeap
+	{
+	public:
+		IndexedHeap();
+
+		// Ids go from 0 to capacity - 1 (also empties the heap)
+		void Reserve(int capacity);
+		// Empty the heap, O(size) rather than O(capacity)
+		void Clear();
+
+		bool IsEmpty() const { return m_Heap.empty(); }
+		int GetSize() const { return static_cast<int>(m_Heap.size()); }
+		bool Contains(int id) const { return m_Positions[id] >= 0; }
+
+		// Add id, or change its priority if it's already in
+		void Push(int id, float priority);
+		// Lowest priority id (the heap can't be empty)
+		int Top() const { return m_Heap[0].m_Id; }
+		float TopPriority() const { return m_Heap[0].m_Priority; }
+		int Pop();
+	private:
+		void SiftUp(int pos);
+		void SiftDown(int pos);
+		void Place(int pos, int id, float priority);
+
+		struct Entry
+		{
+			float m_Priority;
+			int m_Id;
+		};
+		std::vector<Entry> m_Heap;
+		// Heap position of each id, -1 if not in the heap
+		std::vector<int> m_Positions;
+	};
+}
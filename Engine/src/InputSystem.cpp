@@ -38,14 +38,14 @@ namespace Engine
 	void InputSystem::PrepareForUpdate()
 	{
 		// Keyboard
-		// Prepare for Update is called before SDL_PollEvents, so m_CurrState still has the state from the current frame
+		// m_CurrState is what was just handed out, it becomes the state to compare the next Update with
 		memcpy(m_State.Keyboard.m_PrevState,
 			m_State.Keyboard.m_CurrState,
 			SDL_NUM_SCANCODES);
 
 		// Mouse
 		m_State.Mouse.m_PrevButtons = m_State.Mouse.m_CurrButtons;
-		// The mouse wheel event only triggers on frames where the scroll wheel moves
+		// The mouse wheel event only triggers on frames where the scroll wheel moves (adds up until handed out)
 		m_State.Mouse.m_ScrollWheel = Vector2::Zero;
 
 		// Controller
@@ -110,7 +110,7 @@ namespace Engine
 		switch (event.type)
 		{
 		case SDL_MOUSEWHEEL:
-			m_State.Mouse.m_ScrollWheel = Vector2(
+			m_State.Mouse.m_ScrollWheel += Vector2(
 				static_cast<float>(event.wheel.x),
 				static_cast<float>(event.wheel.y));
 			break;
@@ -108,9 +108,10 @@ namespace Engine
 		bool Initialize();
 		void Shutdown();
 
-		// Called right before SDL_PollEvents loop
+		// Called once the state has been handed out, so the next Update's
+		// pressed/released (and scroll) are relative to what was seen last
 		void PrepareForUpdate();
-		// Called after SDL_PollEvents loop
+		// Called before handing the state out (mouse movement is everything since the last Update)
 		void Update();
 		// Called to process an SDL event in input system
 		void ProcessEvent(SDL_Event& event);
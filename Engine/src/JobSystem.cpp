@@ -0,0 +1,247 @@
+#include "JobSystem.h"
+#include <SDL.h>
+
+namespace Engine
+{
+	// Which queue the current thread owns (0 for the main thread)
+	static thread_local int t_QueueIndex = 0;
+
+	JobSystem::JobSystem()
+		:m_QueuedJobs(0)
+		, m_Running(false)
+	{
+	}
+
+	bool JobSystem::Initialize(int numWorkers)
+	{
+		if (numWorkers <= 0)
+		{
+			// The main thread does work too, so leave one hardware thread for it
+			int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+			numWorkers = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+		}
+
+		m_Queues.emplace_back(new WorkQueue());
+		for (int i = 0; i < numWorkers; i++)
+		{
+			m_Queues.emplace_back(new WorkQueue());
+		}
+
+		m_Running = true;
+		for (int i = 0; i < numWorkers; i++)
+		{
+			m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+		}
+
+		SDL_Log("Job system running on %d threads", GetThreadCount());
+		return true;
+	}
+
+	void JobSystem::Shutdown()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_SleepMutex);
+			m_Running = false;
+		}
+		m_WakeUp.notify_all();
+		for (auto& worker : m_Workers)
+		{
+			worker.join();
+		}
+		m_Workers.clear();
+
+		for (auto queue : m_Queues)
+		{
+			delete queue;
+		}
+		m_Queues.clear();
+		m_BackgroundQueue.m_Jobs.clear();
+	}
+
+	void JobSystem::Run(std::function<void()> job, JobCounter* counter, const JobCounter* dependency)
+	{
+		if (counter)
+		{
+			counter->m_Count.fetch_add(1, std::memory_order_relaxed);
+		}
+		Push(GetQueueIndex(), Job{ std::move(job), counter, dependency });
+	}
+
+	void JobSystem::RunBackground(std::function<void()> job, JobCounter* counter)
+	{
+		if (m_Workers.empty())
+		{
+			job();
+			return;
+		}
+
+		if (counter)
+		{
+			counter->m_Count.fetch_add(1, std::memory_order_relaxed);
+		}
+		{
+			std::lock_guard<std::mutex> lock(m_BackgroundQueue.m_Mutex);
+			m_BackgroundQueue.m_Jobs.emplace_back(Job{ std::move(job), counter, nullptr });
+		}
+		m_QueuedJobs.fetch_add(1);
+
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+		m_WakeUp.notify_one();
+	}
+
+	void JobSystem::Wait(const JobCounter& counter)
+	{
+		int index = GetQueueIndex();
+		while (!counter.IsDone())
+		{
+			if (!RunOneJob(index))
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void JobSystem::ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& func)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+		if (chunkSize == 0)
+		{
+			chunkSize = 1;
+		}
+
+		// Not worth splitting up
+		if (m_Queues.size() <= 1 || count <= chunkSize)
+		{
+			func(0, count);
+			return;
+		}
+
+		JobCounter counter;
+		for (size_t begin = 0; begin < count; begin += chunkSize)
+		{
+			size_t end = begin + chunkSize < count ? begin + chunkSize : count;
+			Run([&func, begin, end]() { func(begin, end); }, &counter);
+		}
+		Wait(counter);
+	}
+
+	void JobSystem::WorkerLoop(int index)
+	{
+		t_QueueIndex = index;
+		while (m_Running)
+		{
+			if (!RunOneJob(index))
+			{
+				// Only jobs waiting on a dependency left, check again soon
+				if (m_QueuedJobs.load() > 0)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+
+				// Sleep until something gets queued
+				std::unique_lock<std::mutex> lock(m_SleepMutex);
+				m_WakeUp.wait(lock, [this]()
+					{
+						return m_QueuedJobs.load() > 0 || !m_Running;
+					});
+			}
+		}
+	}
+
+	bool JobSystem::TryGetJob(int index, Job& outJob)
+	{
+		const int queueCount = static_cast<int>(m_Queues.size());
+		for (int i = 0; i < queueCount; i++)
+		{
+			// Own queue first (newest job, still warm in cache),
+			// then the other queues (oldest job, the biggest chunk of remaining work)
+			int victim = (index + i) % queueCount;
+			WorkQueue* queue = m_Queues[victim];
+			std::lock_guard<std::mutex> lock(queue->m_Mutex);
+			if (queue->m_Jobs.empty())
+			{
+				continue;
+			}
+
+			if (victim == index)
+			{
+				for (auto iter = queue->m_Jobs.rbegin(); iter != queue->m_Jobs.rend(); ++iter)
+				{
+					if (!iter->m_Dependency || iter->m_Dependency->IsDone())
+					{
+						outJob = std::move(*iter);
+						queue->m_Jobs.erase(std::next(iter).base());
+						m_QueuedJobs.fetch_sub(1);
+						return true;
+					}
+				}
+			}
+			else
+			{
+				for (auto iter = queue->m_Jobs.begin(); iter != queue->m_Jobs.end(); ++iter)
+				{
+					if (!iter->m_Dependency || iter->m_Dependency->IsDone())
+					{
+						outJob = std::move(*iter);
+						queue->m_Jobs.erase(iter);
+						m_QueuedJobs.fetch_sub(1);
+						return true;
+					}
+				}
+			}
+		}
+
+		// Nothing short left, workers take on background work
+		if (index != 0)
+		{
+			std::lock_guard<std::mutex> lock(m_BackgroundQueue.m_Mutex);
+			if (!m_BackgroundQueue.m_Jobs.empty())
+			{
+				outJob = std::move(m_BackgroundQueue.m_Jobs.front());
+				m_BackgroundQueue.m_Jobs.pop_front();
+				m_QueuedJobs.fetch_sub(1);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool JobSystem::RunOneJob(int index)
+	{
+		Job job;
+		if (!TryGetJob(index, job))
+		{
+			return false;
+		}
+
+		job.m_Func();
+		if (job.m_Counter)
+		{
+			job.m_Counter->m_Count.fetch_sub(1, std::memory_order_release);
+		}
+		return true;
+	}
+
+	void JobSystem::Push(int index, Job&& job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Queues[index]->m_Mutex);
+			m_Queues[index]->m_Jobs.emplace_back(std::move(job));
+		}
+		m_QueuedJobs.fetch_add(1);
+
+		// Notify under the sleep mutex, so a worker about to sleep can't miss the new job
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+		m_WakeUp.notify_one();
+	}
+
+	int JobSystem::GetQueueIndex() const
+	{
+		// Threads the job system doesn't know about share the main thread's queue
+		return t_QueueIndex < static_cast<int>(m_Queues.size()) ? t_QueueIndex : 0;
+	}
+}
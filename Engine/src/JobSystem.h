@@ -0,0 +1,92 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+namespace Engine
+{
+	// Counts the unfinished jobs of a group
+	// Run increments it, and it goes back down as each job finishes,
+	// so a counter at zero means the whole group is done
+	class JobCounter
+	{
+	public:
+		JobCounter() :m_Count(0) {}
+		bool IsDone() const { return m_Count.load(std::memory_order_acquire) == 0; }
+	private:
+		friend class JobSystem;
+		std::atomic<int> m_Count;
+	};
+
+	// Work-stealing job scheduler
+	// Every thread (workers plus the main thread) has its own deque of jobs.
+	// A thread pushes/pops its own jobs at the back, and when it runs out it
+	// steals from the front of another thread's deque.
+	// Waiting on a counter doesn't block: the waiting thread runs jobs until the
+	// counter reaches zero.
+	class JobSystem
+	{
+	public:
+		JobSystem();
+
+		// numWorkers = 0 uses one worker per extra hardware thread
+		bool Initialize(int numWorkers = 0);
+		void Shutdown();
+
+		// Queue a job on the calling thread's deque
+		// counter (optional) is incremented now and decremented when the job finishes
+		// The job won't start until dependency (optional) is done
+		// (queue the dependency's jobs first, an empty counter counts as done)
+		void Run(std::function<void()> job, JobCounter* counter = nullptr,
+			const JobCounter* dependency = nullptr);
+		// Queue a long running job (file loads and the like) that only worker threads pick up,
+		// so the main thread never gets stuck with one while it waits on other work
+		// With no workers the job runs right away
+		void RunBackground(std::function<void()> job, JobCounter* counter = nullptr);
+		// Run other jobs until counter reaches zero
+		void Wait(const JobCounter& counter);
+
+		// Call func(begin, end) over [0, count) split into chunks of chunkSize,
+		// and wait for all of them
+		void ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& func);
+
+		// Number of threads running jobs (workers + the main thread)
+		int GetThreadCount() const { return static_cast<int>(m_Queues.size()); }
+	private:
+		struct Job
+		{
+			std::function<void()> m_Func;
+			JobCounter* m_Counter;
+			const JobCounter* m_Dependency;
+		};
+
+		struct WorkQueue
+		{
+			std::mutex m_Mutex;
+			std::deque<Job> m_Jobs;
+		};
+
+		void WorkerLoop(int index);
+		// Pop from our own queue, or steal from someone else's
+		bool TryGetJob(int index, Job& outJob);
+		// Run one job if there is one, returns false if there was nothing to do
+		bool RunOneJob(int index);
+		void Push(int index, Job&& job);
+		int GetQueueIndex() const;
+
+		// Queue 0 belongs to the main thread, queue i + 1 to worker i
+		std::vector<WorkQueue*> m_Queues;
+		// Jobs queued with RunBackground (workers only, oldest first)
+		WorkQueue m_BackgroundQueue;
+		std::vector<std::thread> m_Workers;
+		// Jobs sitting in any queue (idle workers sleep while this is zero)
+		std::atomic<int> m_QueuedJobs;
+		std::atomic<bool> m_Running;
+		std::mutex m_SleepMutex;
+		std::condition_variable m_WakeUp;
+	};
+}
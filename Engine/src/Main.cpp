@@ -1,7 +1,52 @@
 #include "Game.h"
+#include "MeshFile.h"
+#include <cstring>
+
+// Offline converter: Engine --convert-meshes a.gpmesh b.gpmesh ...
+// writes a.gpmeshb, b.gpmeshb ... next to the json files
+// Meshes without hand made LODs get simplified ones generated
+static int ConvertMeshes(int count, char** fileNames)
+{
+	int failed = 0;
+	for (int i = 0; i < count; i++)
+	{
+		std::string jsonName = fileNames[i];
+		std::string binaryName = jsonName + "b";
+		Engine::MeshFile file;
+		if (!file.LoadJson(jsonName))
+		{
+			SDL_Log("Failed to convert %s", jsonName.c_str());
+			failed++;
+			continue;
+		}
+		if (file.GetLods().size() == 1)
+		{
+			file.GenerateLods(Engine::MeshFile::MaxLods);
+		}
+		if (!file.SaveBinary(binaryName))
+		{
+			SDL_Log("Failed to convert %s", jsonName.c_str());
+			failed++;
+			continue;
+		}
+		SDL_Log("%s -> %s (%u verts, %u indices)", jsonName.c_str(), binaryName.c_str(),
+			file.GetVertexCount(), file.GetIndexCount());
+		for (size_t lod = 0; lod < file.GetLods().size(); lod++)
+		{
+			SDL_Log("  LOD %u: %u triangles", static_cast<unsigned int>(lod),
+				file.GetLods()[lod].m_IndexCount / 3);
+		}
+	}
+	return failed == 0 ? 0 : 1;
+}
 
 int main(int argc, char** argv)
 {
+	if (argc > 1 && strcmp(argv[1], "--convert-meshes") == 0)
+	{
+		return ConvertMeshes(argc - 2, argv + 2);
+	}
+
 	Engine::Game game;
 	bool success = game.Initialize();
 
@@ -12,4 +57,4 @@ int main(int argc, char** argv)
 
 	game.Shutdown();
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,759 @@
+#include "NavMesh.h"
+#include <algorithm>
+#include <cmath>
+#include <SDL_log.h>
+
+namespace Engine
+{
+	// Side offsets, in the same order as Cell::m_Neighbors
+	static const int DirX[4] = { 1, 0, -1, 0 };
+	static const int DirY[4] = { 0, 1, 0, -1 };
+
+	// Twice the signed area of triangle abc on x/y (positive if c is left of a->b)
+	static float TriArea2(const Vector3& a, const Vector3& b, const Vector3& c)
+	{
+		return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+	}
+
+	static bool SamePoint(const Vector3& a, const Vector3& b)
+	{
+		return CustomMath::NearZero(a.x - b.x, 0.01f) && CustomMath::NearZero(a.y - b.y, 0.01f);
+	}
+
+	NavMeshSettings::NavMeshSettings() :
+		m_CellSize(25.0f),
+		m_AgentHeight(150.0f),
+		m_AgentRadius(40.0f),
+		m_MaxClimb(30.0f),
+		m_MaxPolyCells(16)
+	{
+	}
+
+	NavMesh::NavMesh() :
+		m_Origin(Vector2::Zero),
+		m_Width(0),
+		m_Height(0)
+	{
+	}
+
+	void NavMesh::Build(const std::vector<AABB>& geometry, const NavMeshSettings& settings)
+	{
+		Clear();
+		m_Settings = settings;
+		if (geometry.empty())
+		{
+			return;
+		}
+
+		std::vector<std::vector<std::pair<float, float>>> spans;
+		VoxelizeColumns(geometry, spans);
+
+		// The top of each solid span is a floor if there's room to stand above it
+		m_ColumnStart.resize(spans.size() + 1);
+		for (size_t column = 0; column < spans.size(); column++)
+		{
+			m_ColumnStart[column] = static_cast<int>(m_Cells.size());
+			const auto& columnSpans = spans[column];
+			for (size_t i = 0; i < columnSpans.size(); i++)
+			{
+				float floor = columnSpans[i].second;
+				float ceiling = i + 1 < columnSpans.size() ? columnSpans[i + 1].first : CustomMath::Infinity;
+				if (ceiling - floor >= m_Settings.m_AgentHeight)
+				{
+					m_Cells.emplace_back(Cell{ floor, ceiling, { -1, -1, -1, -1 }, -1, true });
+				}
+			}
+		}
+		m_ColumnStart[spans.size()] = static_cast<int>(m_Cells.size());
+
+		ConnectCells();
+		ErodeCells();
+		MergePolys();
+		LinkPolys();
+
+		SDL_Log("Built nav mesh: %dx%d columns, %d cells, %d polygons, %d links",
+			m_Width, m_Height, static_cast<int>(m_Cells.size()), GetPolyCount(), static_cast<int>(m_Links.size()));
+	}
+
+	void NavMesh::Clear()
+	{
+		m_Width = 0;
+		m_Height = 0;
+		m_ColumnStart.clear();
+		m_Cells.clear();
+		m_Polys.clear();
+		m_Links.clear();
+	}
+
+	int NavMesh::FindNearestPoly(const Vector3& pos, float maxDistance, Vector3& outPoint) const
+	{
+		if (m_Polys.empty())
+		{
+			return -1;
+		}
+
+		int cx, cy;
+		GetColumnAt(pos.x, pos.y, cx, cy);
+		const float cellSize = m_Settings.m_CellSize;
+		const int maxRing = static_cast<int>(maxDistance / cellSize) + 1;
+
+		int best = -1;
+		float bestDistSq = maxDistance * maxDistance;
+		// Rings of columns outwards, until nothing further out can be closer
+		for (int ring = 0; ring <= maxRing; ring++)
+		{
+			for (int y = cy - ring; y <= cy + ring; y++)
+			{
+				for (int x = cx - ring; x <= cx + ring; x++)
+				{
+					bool onRing = x == cx - ring || x == cx + ring || y == cy - ring || y == cy + ring;
+					if (!onRing || x < 0 || y < 0 || x >= m_Width || y >= m_Height)
+					{
+						continue;
+					}
+					int column = GetColumn(x, y);
+					for (int i = m_ColumnStart[column]; i < m_ColumnStart[column + 1]; i++)
+					{
+						int poly = m_Cells[i].m_Poly;
+						if (poly < 0)
+						{
+							continue;
+						}
+						Vector3 point = ClosestPointOnPoly(poly, pos);
+						float distSq = (point - pos).LengthSq();
+						if (distSq <= bestDistSq)
+						{
+							best = poly;
+							bestDistSq = distSq;
+							outPoint = point;
+						}
+					}
+				}
+			}
+			float ringDist = ring * cellSize;
+			if (best >= 0 && ringDist * ringDist >= bestDistSq)
+			{
+				break;
+			}
+		}
+		return best;
+	}
+
+	bool NavMesh::FindPath(const Vector3& start, const Vector3& end, std::vector<Vector3>& outPath)
+	{
+		return FindPath(start, end, outPath, m_Query);
+	}
+
+	bool NavMesh::FindPath(const Vector3& start, const Vector3& end, std::vector<Vector3>& outPath, Query& query) const
+	{
+		outPath.clear();
+		query.m_NodesExpanded = 0;
+
+		Vector3 startPoint, endPoint;
+		int startPoly = FindNearestPoly(start, m_Settings.m_AgentHeight, startPoint);
+		int endPoly = FindNearestPoly(end, m_Settings.m_AgentHeight, endPoint);
+		if (startPoly < 0 || endPoly < 0)
+		{
+			return false;
+		}
+
+		// Sized for this mesh on first use (or after a rebuild)
+		if (query.m_SearchNodes.size() != m_Polys.size())
+		{
+			query.m_SearchNodes.assign(m_Polys.size(), Query::SearchNode());
+			query.m_Open.Reserve(GetPolyCount());
+			query.m_Search = 0;
+		}
+		query.m_Search++;
+		if (query.m_Search == 0)
+		{
+			for (auto& node : query.m_SearchNodes)
+			{
+				node.m_Search = 0;
+			}
+			query.m_Search = 1;
+		}
+
+		// A* over polygons, each one reached at the middle of the edge crossed into it
+		Query::SearchNode& first = query.m_SearchNodes[startPoly];
+		first.m_Pos = startPoint;
+		first.m_G = 0.0f;
+		first.m_Parent = -1;
+		first.m_ParentLink = -1;
+		first.m_Search = query.m_Search;
+		first.m_Closed = false;
+		query.m_Open.Push(startPoly, (endPoint - startPoint).Length());
+
+		bool found = false;
+		while (!query.m_Open.IsEmpty())
+		{
+			int current = query.m_Open.Pop();
+			query.m_SearchNodes[current].m_Closed = true;
+			query.m_NodesExpanded++;
+			if (current == endPoly)
+			{
+				found = true;
+				break;
+			}
+
+			const Poly& poly = m_Polys[current];
+			for (int i = poly.m_FirstLink; i < poly.m_FirstLink + poly.m_LinkCount; i++)
+			{
+				const Link& link = m_Links[i];
+				Vector3 pos = (link.m_A + link.m_B) * 0.5f;
+				float g = query.m_SearchNodes[current].m_G + (pos - query.m_SearchNodes[current].m_Pos).Length();
+				Query::SearchNode& node = query.m_SearchNodes[link.m_Poly];
+				if (node.m_Search != query.m_Search)
+				{
+					node.m_Search = query.m_Search;
+					node.m_Closed = false;
+				}
+				else if (node.m_Closed || g >= node.m_G)
+				{
+					continue;
+				}
+				node.m_Pos = pos;
+				node.m_G = g;
+				node.m_Parent = current;
+				node.m_ParentLink = i;
+				query.m_Open.Push(link.m_Poly, g + (endPoint - pos).Length());
+			}
+		}
+		query.m_Open.Clear();
+		if (!found)
+		{
+			return false;
+		}
+
+		query.m_PolyPath.clear();
+		query.m_LinkPath.clear();
+		for (int poly = endPoly; query.m_SearchNodes[poly].m_Parent != -1; poly = query.m_SearchNodes[poly].m_Parent)
+		{
+			query.m_PolyPath.emplace_back(query.m_SearchNodes[poly].m_Parent);
+			query.m_LinkPath.emplace_back(query.m_SearchNodes[poly].m_ParentLink);
+		}
+		std::reverse(query.m_PolyPath.begin(), query.m_PolyPath.end());
+		std::reverse(query.m_LinkPath.begin(), query.m_LinkPath.end());
+		query.m_StartPoly = startPoly;
+		query.m_EndPoly = endPoly;
+
+		StraightenPath(query, startPoint, endPoint, outPath);
+		return true;
+	}
+
+	void NavMesh::FindPathAlong(const Vector3& start, const Vector3& end, const Query& query, std::vector<Vector3>& outPath) const
+	{
+		outPath.clear();
+		StraightenPath(query, ClosestPointOnPoly(query.m_StartPoly, start),
+			ClosestPointOnPoly(query.m_EndPoly, end), outPath);
+	}
+
+	int NavMesh::FindPathPoly(const Vector3& pos) const
+	{
+		Vector3 point;
+		return FindNearestPoly(pos, m_Settings.m_AgentHeight, point);
+	}
+
+	void NavMesh::StraightenPath(const Query& query, const Vector3& start, const Vector3& end, std::vector<Vector3>& outPath) const
+	{
+		StringPull(query, start, end, outPath);
+
+		// The funnel is only as straight as the polygons A* picked, so skip
+		// any corner that has a clear line past it
+		size_t kept = 1;
+		for (size_t i = 1; i + 1 < outPath.size(); i++)
+		{
+			float t;
+			if (Raycast(outPath[kept - 1], outPath[i + 1], t))
+			{
+				outPath[kept++] = outPath[i];
+			}
+		}
+		outPath[kept++] = outPath.back();
+		outPath.resize(kept);
+	}
+
+	bool NavMesh::Raycast(const Vector3& start, const Vector3& end, float& outT) const
+	{
+		outT = 0.0f;
+		Vector3 startPoint;
+		int poly = FindNearestPoly(start, m_Settings.m_AgentHeight, startPoint);
+		if (poly < 0)
+		{
+			return true;
+		}
+
+		const float dx = end.x - start.x;
+		const float dy = end.y - start.y;
+		const float epsilon = m_Settings.m_CellSize * 0.001f;
+		int previous = -1;
+		// Each step moves on to another polygon, so this is only a guard
+		for (size_t step = 0; step <= m_Polys.size(); step++)
+		{
+			// Where the ray leaves this rectangle
+			const Poly& current = m_Polys[poly];
+			float tx = CustomMath::Infinity;
+			float ty = CustomMath::Infinity;
+			if (dx > 0.0f)
+			{
+				tx = (current.m_Max.x - start.x) / dx;
+			}
+			else if (dx < 0.0f)
+			{
+				tx = (current.m_Min.x - start.x) / dx;
+			}
+			if (dy > 0.0f)
+			{
+				ty = (current.m_Max.y - start.y) / dy;
+			}
+			else if (dy < 0.0f)
+			{
+				ty = (current.m_Min.y - start.y) / dy;
+			}
+			float tExit = tx < ty ? tx : ty;
+			if (tExit >= 1.0f)
+			{
+				outT = 1.0f;
+				return false;
+			}
+			outT = tExit > 0.0f ? tExit : 0.0f;
+
+			// Carry on through whichever link the exit point is on
+			float px = start.x + dx * tExit;
+			float py = start.y + dy * tExit;
+			int next = -1;
+			for (int i = current.m_FirstLink; i < current.m_FirstLink + current.m_LinkCount && next < 0; i++)
+			{
+				const Link& link = m_Links[i];
+				if (link.m_Poly == previous)
+				{
+					continue;
+				}
+				float minX = CustomMath::Min(link.m_A.x, link.m_B.x) - epsilon;
+				float maxX = CustomMath::Max(link.m_A.x, link.m_B.x) + epsilon;
+				float minY = CustomMath::Min(link.m_A.y, link.m_B.y) - epsilon;
+				float maxY = CustomMath::Max(link.m_A.y, link.m_B.y) + epsilon;
+				if (px >= minX && px <= maxX && py >= minY && py <= maxY)
+				{
+					next = link.m_Poly;
+				}
+			}
+			if (next < 0)
+			{
+				return true;
+			}
+			previous = poly;
+			poly = next;
+		}
+		return true;
+	}
+
+	void NavMesh::VoxelizeColumns(const std::vector<AABB>& geometry, std::vector<std::vector<std::pair<float, float>>>& outSpans)
+	{
+		Vector2 min(CustomMath::Infinity, CustomMath::Infinity);
+		Vector2 max(CustomMath::NegInfinity, CustomMath::NegInfinity);
+		for (const AABB& box : geometry)
+		{
+			min.x = CustomMath::Min(min.x, box.m_Min.x);
+			min.y = CustomMath::Min(min.y, box.m_Min.y);
+			max.x = CustomMath::Max(max.x, box.m_Max.x);
+			max.y = CustomMath::Max(max.y, box.m_Max.y);
+		}
+
+		const float cellSize = m_Settings.m_CellSize;
+		m_Origin = min;
+		m_Width = CustomMath::Max(1, static_cast<int>(std::ceil((max.x - min.x) / cellSize)));
+		m_Height = CustomMath::Max(1, static_cast<int>(std::ceil((max.y - min.y) / cellSize)));
+		outSpans.assign(static_cast<size_t>(m_Width) * m_Height, std::vector<std::pair<float, float>>());
+
+		// Each box is solid from its bottom to its top in every column it touches
+		for (const AABB& box : geometry)
+		{
+			int x0 = static_cast<int>((box.m_Min.x - m_Origin.x) / cellSize);
+			int y0 = static_cast<int>((box.m_Min.y - m_Origin.y) / cellSize);
+			// A flat box (like a wall) still fills the column it's in
+			int x1 = static_cast<int>(std::ceil((box.m_Max.x - m_Origin.x) / cellSize)) - 1;
+			int y1 = static_cast<int>(std::ceil((box.m_Max.y - m_Origin.y) / cellSize)) - 1;
+			x0 = CustomMath::Clamp(x0, 0, m_Width - 1);
+			y0 = CustomMath::Clamp(y0, 0, m_Height - 1);
+			x1 = CustomMath::Clamp(x1, x0, m_Width - 1);
+			y1 = CustomMath::Clamp(y1, y0, m_Height - 1);
+			for (int y = y0; y <= y1; y++)
+			{
+				for (int x = x0; x <= x1; x++)
+				{
+					outSpans[GetColumn(x, y)].emplace_back(box.m_Min.z, box.m_Max.z);
+				}
+			}
+		}
+
+		// Overlapping spans become one
+		for (auto& column : outSpans)
+		{
+			std::sort(column.begin(), column.end());
+			size_t count = 0;
+			for (size_t i = 0; i < column.size(); i++)
+			{
+				if (count > 0 && column[i].first <= column[count - 1].second)
+				{
+					column[count - 1].second = CustomMath::Max(column[count - 1].second, column[i].second);
+				}
+				else
+				{
+					column[count++] = column[i];
+				}
+			}
+			column.resize(count);
+		}
+	}
+
+	void NavMesh::ConnectCells()
+	{
+		// Neighbouring floors connect if the step is small enough and there's room to walk across
+		for (int y = 0; y < m_Height; y++)
+		{
+			for (int x = 0; x < m_Width; x++)
+			{
+				int column = GetColumn(x, y);
+				for (int i = m_ColumnStart[column]; i < m_ColumnStart[column + 1]; i++)
+				{
+					Cell& cell = m_Cells[i];
+					for (int dir = 0; dir < 4; dir++)
+					{
+						int nx = x + DirX[dir];
+						int ny = y + DirY[dir];
+						if (nx < 0 || ny < 0 || nx >= m_Width || ny >= m_Height)
+						{
+							continue;
+						}
+						int other = GetColumn(nx, ny);
+						float bestStep = m_Settings.m_MaxClimb;
+						for (int j = m_ColumnStart[other]; j < m_ColumnStart[other + 1]; j++)
+						{
+							const Cell& neighbor = m_Cells[j];
+							float step = CustomMath::Abs(neighbor.m_Floor - cell.m_Floor);
+							float room = CustomMath::Min(cell.m_Ceiling, neighbor.m_Ceiling) -
+								CustomMath::Max(cell.m_Floor, neighbor.m_Floor);
+							if (step <= bestStep && room >= m_Settings.m_AgentHeight)
+							{
+								bestStep = step;
+								cell.m_Neighbors[dir] = j;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	void NavMesh::ErodeCells()
+	{
+		// Distance in cells from the nearest edge (a side with no neighbour)
+		const int cellCount = static_cast<int>(m_Cells.size());
+		std::vector<int> distance(cellCount, -1);
+		std::vector<int> queue;
+		queue.reserve(cellCount);
+		for (int i = 0; i < cellCount; i++)
+		{
+			const Cell& cell = m_Cells[i];
+			for (int dir = 0; dir < 4; dir++)
+			{
+				if (cell.m_Neighbors[dir] < 0)
+				{
+					distance[i] = 0;
+					queue.emplace_back(i);
+					break;
+				}
+			}
+		}
+		for (size_t i = 0; i < queue.size(); i++)
+		{
+			const Cell& cell = m_Cells[queue[i]];
+			for (int dir = 0; dir < 4; dir++)
+			{
+				int neighbor = cell.m_Neighbors[dir];
+				if (neighbor >= 0 && distance[neighbor] < 0)
+				{
+					distance[neighbor] = distance[queue[i]] + 1;
+					queue.emplace_back(neighbor);
+				}
+			}
+		}
+
+		// Drop cells an agent's centre can't reach, and any links to them
+		for (int i = 0; i < cellCount; i++)
+		{
+			if (distance[i] >= 0 && (distance[i] + 0.5f) * m_Settings.m_CellSize < m_Settings.m_AgentRadius)
+			{
+				m_Cells[i].m_Walkable = false;
+			}
+		}
+		for (auto& cell : m_Cells)
+		{
+			for (int dir = 0; dir < 4; dir++)
+			{
+				int neighbor = cell.m_Neighbors[dir];
+				if (!cell.m_Walkable || (neighbor >= 0 && !m_Cells[neighbor].m_Walkable))
+				{
+					cell.m_Neighbors[dir] = -1;
+				}
+			}
+		}
+	}
+
+	void NavMesh::MergePolys()
+	{
+		const float cellSize = m_Settings.m_CellSize;
+		const int maxCells = m_Settings.m_MaxPolyCells > 0 ? m_Settings.m_MaxPolyCells : 1;
+		std::vector<int> row;
+		std::vector<int> nextRow;
+		for (int y = 0; y < m_Height; y++)
+		{
+			for (int x = 0; x < m_Width; x++)
+			{
+				int column = GetColumn(x, y);
+				for (int i = m_ColumnStart[column]; i < m_ColumnStart[column + 1]; i++)
+				{
+					if (!m_Cells[i].m_Walkable || m_Cells[i].m_Poly >= 0)
+					{
+						continue;
+					}
+
+					// Grow a flat rectangle: along +x first, then whole rows along +y
+					const float floor = m_Cells[i].m_Floor;
+					auto canAdd = [&](int cell)
+					{
+						return cell >= 0 && m_Cells[cell].m_Poly < 0 && m_Cells[cell].m_Floor == floor;
+					};
+
+					row.clear();
+					row.emplace_back(i);
+					while (static_cast<int>(row.size()) < maxCells && canAdd(m_Cells[row.back()].m_Neighbors[0]))
+					{
+						row.emplace_back(m_Cells[row.back()].m_Neighbors[0]);
+					}
+
+					const int poly = static_cast<int>(m_Polys.size());
+					int rows = 1;
+					for (int cell : row)
+					{
+						m_Cells[cell].m_Poly = poly;
+					}
+					while (rows < maxCells)
+					{
+						nextRow.clear();
+						for (size_t k = 0; k < row.size(); k++)
+						{
+							int above = m_Cells[row[k]].m_Neighbors[1];
+							if (!canAdd(above) || (k > 0 && m_Cells[nextRow.back()].m_Neighbors[0] != above))
+							{
+								break;
+							}
+							nextRow.emplace_back(above);
+						}
+						if (nextRow.size() != row.size())
+						{
+							break;
+						}
+						for (int cell : nextRow)
+						{
+							m_Cells[cell].m_Poly = poly;
+						}
+						row.swap(nextRow);
+						rows++;
+					}
+
+					float minX = m_Origin.x + x * cellSize;
+					float minY = m_Origin.y + y * cellSize;
+					Poly newPoly;
+					newPoly.m_Min = Vector3(minX, minY, floor);
+					newPoly.m_Max = Vector3(minX + row.size() * cellSize, minY + rows * cellSize, floor);
+					newPoly.m_FirstLink = 0;
+					newPoly.m_LinkCount = 0;
+					m_Polys.emplace_back(newPoly);
+				}
+			}
+		}
+	}
+
+	void NavMesh::LinkPolys()
+	{
+		const float cellSize = m_Settings.m_CellSize;
+		for (int poly = 0; poly < GetPolyCount(); poly++)
+		{
+			Poly& p = m_Polys[poly];
+			p.m_FirstLink = static_cast<int>(m_Links.size());
+			int x0 = static_cast<int>((p.m_Min.x - m_Origin.x) / cellSize + 0.5f);
+			int y0 = static_cast<int>((p.m_Min.y - m_Origin.y) / cellSize + 0.5f);
+			int x1 = static_cast<int>((p.m_Max.x - m_Origin.x) / cellSize + 0.5f) - 1;
+			int y1 = static_cast<int>((p.m_Max.y - m_Origin.y) / cellSize + 0.5f) - 1;
+
+			// Walk each side, one link per run of cells that lead into the same polygon
+			for (int dir = 0; dir < 4; dir++)
+			{
+				bool alongY = DirX[dir] != 0;
+				int fixed = dir == 0 ? x1 : (dir == 1 ? y1 : (dir == 2 ? x0 : y0));
+				int from = alongY ? y0 : x0;
+				int to = alongY ? y1 : x1;
+				int runPoly = -1;
+				int runStart = from;
+				for (int t = from; t <= to + 1; t++)
+				{
+					int other = -1;
+					if (t <= to)
+					{
+						int cell = alongY ? FindCell(GetColumn(fixed, t), poly) : FindCell(GetColumn(t, fixed), poly);
+						int neighbor = m_Cells[cell].m_Neighbors[dir];
+						other = neighbor >= 0 ? m_Cells[neighbor].m_Poly : -1;
+					}
+					if (other == runPoly)
+					{
+						continue;
+					}
+					if (runPoly >= 0)
+					{
+						// Edge on the side of the rectangle, at the height between the two floors
+						float z = (p.m_Min.z + m_Polys[runPoly].m_Min.z) * 0.5f;
+						float edge = dir == 0 || dir == 1 ? (alongY ? p.m_Max.x : p.m_Max.y) : (alongY ? p.m_Min.x : p.m_Min.y);
+						float a = (alongY ? m_Origin.y : m_Origin.x) + runStart * cellSize;
+						float b = (alongY ? m_Origin.y : m_Origin.x) + t * cellSize;
+						Link link;
+						link.m_Poly = runPoly;
+						link.m_A = alongY ? Vector3(edge, a, z) : Vector3(a, edge, z);
+						link.m_B = alongY ? Vector3(edge, b, z) : Vector3(b, edge, z);
+						m_Links.emplace_back(link);
+					}
+					runPoly = other;
+					runStart = t;
+				}
+			}
+			p.m_LinkCount = static_cast<int>(m_Links.size()) - p.m_FirstLink;
+		}
+	}
+
+	int NavMesh::FindCell(int column, int poly) const
+	{
+		for (int i = m_ColumnStart[column]; i < m_ColumnStart[column + 1]; i++)
+		{
+			if (m_Cells[i].m_Poly == poly)
+			{
+				return i;
+			}
+		}
+		return -1;
+	}
+
+	void NavMesh::GetColumnAt(float wx, float wy, int& outX, int& outY) const
+	{
+		outX = static_cast<int>(std::floor((wx - m_Origin.x) / m_Settings.m_CellSize));
+		outY = static_cast<int>(std::floor((wy - m_Origin.y) / m_Settings.m_CellSize));
+		outX = CustomMath::Clamp(outX, 0, m_Width - 1);
+		outY = CustomMath::Clamp(outY, 0, m_Height - 1);
+	}
+
+	Vector3 NavMesh::ClosestPointOnPoly(int poly, const Vector3& pos) const
+	{
+		const Poly& p = m_Polys[poly];
+		return Vector3(CustomMath::Clamp(pos.x, p.m_Min.x, p.m_Max.x),
+			CustomMath::Clamp(pos.y, p.m_Min.y, p.m_Max.y), p.m_Min.z);
+	}
+
+	void NavMesh::GetPortal(int poly, const Link& link, Vector3& outLeft, Vector3& outRight) const
+	{
+		// Looking from the middle of poly towards the edge, which end is on the left
+		Vector3 center = GetPolyCenter(poly);
+		Vector3 mid = (link.m_A + link.m_B) * 0.5f;
+		if (TriArea2(center, mid, link.m_A) > 0.0f)
+		{
+			outLeft = link.m_A;
+			outRight = link.m_B;
+		}
+		else
+		{
+			outLeft = link.m_B;
+			outRight = link.m_A;
+		}
+	}
+
+	void NavMesh::StringPull(const Query& query, const Vector3& start, const Vector3& end, std::vector<Vector3>& outPath) const
+	{
+		// The edges crossed, plus start and end as zero width edges
+		std::vector<Vector3> lefts;
+		std::vector<Vector3> rights;
+		lefts.emplace_back(start);
+		rights.emplace_back(start);
+		for (size_t i = 0; i < query.m_LinkPath.size(); i++)
+		{
+			Vector3 left, right;
+			GetPortal(query.m_PolyPath[i], m_Links[query.m_LinkPath[i]], left, right);
+			lefts.emplace_back(left);
+			rights.emplace_back(right);
+		}
+		lefts.emplace_back(end);
+		rights.emplace_back(end);
+
+		// Funnel: narrow the left and right sides edge by edge, and when
+		// one side crosses the other, its end is a corner of the path
+		outPath.emplace_back(start);
+		Vector3 apex = start;
+		Vector3 left = start;
+		Vector3 right = start;
+		int apexIndex = 0;
+		int leftIndex = 0;
+		int rightIndex = 0;
+		const int count = static_cast<int>(lefts.size());
+		for (int i = 1; i < count; i++)
+		{
+			const Vector3& newLeft = lefts[i];
+			const Vector3& newRight = rights[i];
+
+			if (TriArea2(apex, right, newRight) >= 0.0f)
+			{
+				if (SamePoint(apex, right) || TriArea2(apex, left, newRight) < 0.0f)
+				{
+					right = newRight;
+					rightIndex = i;
+				}
+				else
+				{
+					// Right crossed over left, so left is a corner
+					apex = left;
+					apexIndex = leftIndex;
+					outPath.emplace_back(apex);
+					left = apex;
+					right = apex;
+					leftIndex = apexIndex;
+					rightIndex = apexIndex;
+					i = apexIndex;
+					continue;
+				}
+			}
+
+			if (TriArea2(apex, left, newLeft) <= 0.0f)
+			{
+				if (SamePoint(apex, left) || TriArea2(apex, right, newLeft) > 0.0f)
+				{
+					left = newLeft;
+					leftIndex = i;
+				}
+				else
+				{
+					apex = right;
+					apexIndex = rightIndex;
+					outPath.emplace_back(apex);
+					left = apex;
+					right = apex;
+					leftIndex = apexIndex;
+					rightIndex = apexIndex;
+					i = apexIndex;
+					continue;
+				}
+			}
+		}
+
+		if (!SamePoint(outPath.back(), end) || outPath.size() == 1)
+		{
+			outPath.emplace_back(end);
+		}
+	}
+}
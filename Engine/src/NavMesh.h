@@ -0,0 +1,156 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "CustomMath.h"
+#include "Collision.h"
+#include "IndexedHeap.h"
+
+namespace Engine
+{
+	// How a NavMesh gets built (world units, z is up)
+	struct NavMeshSettings
+	{
+		NavMeshSettings();
+
+		// Size of a voxel column on x and y
+		float m_CellSize;
+		// Room needed above a surface to stand on it
+		float m_AgentHeight;
+		// Surfaces are shrunk by this much from their edges and walls
+		float m_AgentRadius;
+		// Biggest step up or down between neighbouring cells
+		float m_MaxClimb;
+		// Polygons are at most this many cells on a side (keeps path costs close)
+		int m_MaxPolyCells;
+	};
+
+	// Walkable polygons built from static geometry, with queries to move agents over them
+	// Geometry boxes are voxelized into columns of solid spans. The tops of spans
+	// with enough room above become walkable cells, which are shrunk by the agent
+	// radius and merged into flat rectangles.
+	// Queries only read the mesh, but FindPath without a Query reuses the mesh's own
+	// search state, so only call that one from one thread at a time
+	class NavMesh
+	{
+	public:
+		NavMesh();
+
+		void Build(const std::vector<AABB>& geometry, const NavMeshSettings& settings = NavMeshSettings());
+		void Clear();
+
+		// Polygon closest to pos (within maxDistance), -1 if there's none
+		// outPoint is the closest point on that polygon
+		int FindNearestPoly(const Vector3& pos, float maxDistance, Vector3& outPoint) const;
+
+		// Search state for FindPath, stamped so it doesn't need clearing between searches
+		// Give each thread its own to search the same mesh at once
+		class Query
+		{
+		public:
+			Query() : m_Search(0), m_NodesExpanded(0), m_StartPoly(-1), m_EndPoly(-1) {}
+			// Polygons visited by the last search
+			int GetNodesExpanded() const { return m_NodesExpanded; }
+		private:
+			friend class NavMesh;
+			struct SearchNode
+			{
+				// Where the search entered the polygon
+				Vector3 m_Pos;
+				float m_G;
+				int m_Parent;
+				int m_ParentLink;
+				uint32_t m_Search;
+				bool m_Closed;
+			};
+			std::vector<SearchNode> m_SearchNodes;
+			uint32_t m_Search;
+			IndexedHeap m_Open;
+			std::vector<int> m_PolyPath;
+			std::vector<int> m_LinkPath;
+			int m_NodesExpanded;
+			// Ends of the polygon corridor found by the last successful FindPath
+			int m_StartPoly;
+			int m_EndPoly;
+		};
+
+		// Straightened path from start to end (both snapped onto the mesh)
+		// Returns false (and leaves outPath empty) if they aren't connected
+		bool FindPath(const Vector3& start, const Vector3& end, std::vector<Vector3>& outPath);
+		bool FindPath(const Vector3& start, const Vector3& end, std::vector<Vector3>& outPath, Query& query) const;
+		// Straightened path through the polygons of query's last successful FindPath, for
+		// other agents starting and ending in the same polygons (start and end are moved onto them)
+		void FindPathAlong(const Vector3& start, const Vector3& end, const Query& query, std::vector<Vector3>& outPath) const;
+		// Polygon FindPath snaps pos onto, -1 if it's off the mesh
+		int FindPathPoly(const Vector3& pos) const;
+
+		// Walk a straight line over the mesh from start towards end
+		// Returns true if it runs into an edge, with outT how far along it did (0 to 1)
+		bool Raycast(const Vector3& start, const Vector3& end, float& outT) const;
+
+		struct Link
+		{
+			// Polygon on the other side
+			int m_Poly;
+			// Ends of the shared edge
+			Vector3 m_A;
+			Vector3 m_B;
+		};
+		struct Poly
+		{
+			// Corners on x and y, both at the polygon's height
+			Vector3 m_Min;
+			Vector3 m_Max;
+			int m_FirstLink;
+			int m_LinkCount;
+		};
+
+		int GetPolyCount() const { return static_cast<int>(m_Polys.size()); }
+		const Poly& GetPoly(int poly) const { return m_Polys[poly]; }
+		const Link& GetLink(int link) const { return m_Links[link]; }
+		Vector3 GetPolyCenter(int poly) const { return (m_Polys[poly].m_Min + m_Polys[poly].m_Max) * 0.5f; }
+		// Polygons visited by the last FindPath without a Query
+		int GetNodesExpanded() const { return m_Query.GetNodesExpanded(); }
+	private:
+		struct Cell
+		{
+			float m_Floor;
+			float m_Ceiling;
+			// Cell on each side (+x, +y, -x, -y), -1 for none
+			int m_Neighbors[4];
+			int m_Poly;
+			// False once shrunk away by the agent radius
+			bool m_Walkable;
+		};
+
+		void VoxelizeColumns(const std::vector<AABB>& geometry, std::vector<std::vector<std::pair<float, float>>>& outSpans);
+		void ConnectCells();
+		void ErodeCells();
+		void MergePolys();
+		void LinkPolys();
+		int FindCell(int column, int poly) const;
+
+		int GetColumn(int x, int y) const { return y * m_Width + x; }
+		// Column under a world position, clamped onto the grid
+		void GetColumnAt(float wx, float wy, int& outX, int& outY) const;
+		Vector3 ClosestPointOnPoly(int poly, const Vector3& pos) const;
+		// Crossing from poly along link, with the ends ordered left then right
+		void GetPortal(int poly, const Link& link, Vector3& outLeft, Vector3& outRight) const;
+		void StringPull(const Query& query, const Vector3& start, const Vector3& end, std::vector<Vector3>& outPath) const;
+		// StringPull, then drop the corners a straight line can skip
+		void StraightenPath(const Query& query, const Vector3& start, const Vector3& end, std::vector<Vector3>& outPath) const;
+
+		NavMeshSettings m_Settings;
+		Vector2 m_Origin;
+		int m_Width;
+		int m_Height;
+
+		// Cells of column c are m_Cells[m_ColumnStart[c]] up to m_ColumnStart[c + 1]
+		std::vector<int> m_ColumnStart;
+		std::vector<Cell> m_Cells;
+		std::vector<Poly> m_Polys;
+		std::vector<Link> m_Links;
+
+		// Used by the FindPath without a Query
+		Query m_Query;
+	};
+}
@@ -0,0 +1,157 @@
+#include "GLStateCache.h"
+#include <GL\glew.h>
+
+namespace Engine
+{
+	// Value no real GL object/enum has, so the next set always differs
+	static const unsigned int UnknownValue = 0xffffffff;
+
+	GLStateCache::GLStateCache() :
+		m_Issued(0),
+		m_Skipped(0)
+	{
+		Invalidate();
+	}
+
+	void GLStateCache::Invalidate()
+	{
+		m_Program = UnknownValue;
+		m_VertexArray = UnknownValue;
+		for (unsigned int i = 0; i < MaxTextureUnits; i++)
+		{
+			m_Textures[i] = UnknownValue;
+		}
+		m_ActiveUnit = UnknownValue;
+		m_DepthTest = EUnknown;
+		m_Blend = EUnknown;
+		m_BlendEquation[0] = m_BlendEquation[1] = UnknownValue;
+		m_BlendFunc[0] = m_BlendFunc[1] = m_BlendFunc[2] = m_BlendFunc[3] = UnknownValue;
+	}
+
+	void GLStateCache::UseProgram(unsigned int program)
+	{
+		if (NeedsChange(program != m_Program))
+		{
+			glUseProgram(program);
+			m_Program = program;
+		}
+	}
+
+	void GLStateCache::BindVertexArray(unsigned int vertexArray)
+	{
+		if (NeedsChange(vertexArray != m_VertexArray))
+		{
+			glBindVertexArray(vertexArray);
+			m_VertexArray = vertexArray;
+		}
+	}
+
+	void GLStateCache::BindTexture(unsigned int unit, unsigned int texture)
+	{
+		if (unit >= MaxTextureUnits)
+		{
+			// Past what we track, always bind
+			glActiveTexture(GL_TEXTURE0 + unit);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			m_ActiveUnit = unit;
+			m_Issued++;
+			return;
+		}
+
+		if (NeedsChange(texture != m_Textures[unit]))
+		{
+			// The active unit only matters when something is bound
+			if (unit != m_ActiveUnit)
+			{
+				glActiveTexture(GL_TEXTURE0 + unit);
+				m_ActiveUnit = unit;
+			}
+			glBindTexture(GL_TEXTURE_2D, texture);
+			m_Textures[unit] = texture;
+		}
+	}
+
+	void GLStateCache::SetDepthTest(bool enabled)
+	{
+		if (SetFlag(m_DepthTest, enabled))
+		{
+			if (enabled)
+			{
+				glEnable(GL_DEPTH_TEST);
+			}
+			else
+			{
+				glDisable(GL_DEPTH_TEST);
+			}
+		}
+	}
+
+	void GLStateCache::SetBlend(bool enabled)
+	{
+		if (SetFlag(m_Blend, enabled))
+		{
+			if (enabled)
+			{
+				glEnable(GL_BLEND);
+			}
+			else
+			{
+				glDisable(GL_BLEND);
+			}
+		}
+	}
+
+	void GLStateCache::SetBlendEquation(unsigned int modeRGB, unsigned int modeAlpha)
+	{
+		if (NeedsChange(modeRGB != m_BlendEquation[0] || modeAlpha != m_BlendEquation[1]))
+		{
+			glBlendEquationSeparate(modeRGB, modeAlpha);
+			m_BlendEquation[0] = modeRGB;
+			m_BlendEquation[1] = modeAlpha;
+		}
+	}
+
+	void GLStateCache::SetBlendFunc(unsigned int srcRGB, unsigned int dstRGB,
+		unsigned int srcAlpha, unsigned int dstAlpha)
+	{
+		if (NeedsChange(srcRGB != m_BlendFunc[0] || dstRGB != m_BlendFunc[1] ||
+			srcAlpha != m_BlendFunc[2] || dstAlpha != m_BlendFunc[3]))
+		{
+			glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+			m_BlendFunc[0] = srcRGB;
+			m_BlendFunc[1] = dstRGB;
+			m_BlendFunc[2] = srcAlpha;
+			m_BlendFunc[3] = dstAlpha;
+		}
+	}
+
+	void GLStateCache::ResetCounters()
+	{
+		m_Issued = 0;
+		m_Skipped = 0;
+	}
+
+	bool GLStateCache::NeedsChange(bool differs)
+	{
+		if (differs)
+		{
+			m_Issued++;
+		}
+		else
+		{
+			m_Skipped++;
+		}
+		return differs;
+	}
+
+	bool GLStateCache::SetFlag(int& flag, bool enabled)
+	{
+		int value = enabled ? EEnabled : EDisabled;
+		if (NeedsChange(flag != value))
+		{
+			flag = value;
+			return true;
+		}
+		return false;
+	}
+}
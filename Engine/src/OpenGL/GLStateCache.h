@@ -0,0 +1,60 @@
+#pragma once
+
+namespace Engine
+{
+	// Shadow copy of the GL state the renderer changes while drawing
+	// (program, vertex array, textures per unit, depth test and blending)
+	// Each setter only calls GL when the value is different from what's bound.
+	// GL calls that don't go through the cache (creating/deleting textures, vertex arrays...)
+	// leave the shadow out of date, so call Invalidate after them (the renderer does every frame)
+	class GLStateCache
+	{
+	public:
+		static const unsigned int MaxTextureUnits = 8;
+
+		GLStateCache();
+
+		// Forget everything, the next set of each state always reaches GL
+		void Invalidate();
+
+		void UseProgram(unsigned int program);
+		void BindVertexArray(unsigned int vertexArray);
+		// Bind a GL_TEXTURE_2D to a texture unit
+		void BindTexture(unsigned int unit, unsigned int texture);
+		void SetDepthTest(bool enabled);
+		void SetBlend(bool enabled);
+		// glBlendEquationSeparate
+		void SetBlendEquation(unsigned int modeRGB, unsigned int modeAlpha);
+		// glBlendFuncSeparate
+		void SetBlendFunc(unsigned int srcRGB, unsigned int dstRGB,
+			unsigned int srcAlpha, unsigned int dstAlpha);
+
+		// State changes sent to GL/skipped since the last ResetCounters
+		void ResetCounters();
+		int GetIssuedChanges() const { return m_Issued; }
+		int GetSkippedChanges() const { return m_Skipped; }
+	private:
+		// Count the change, returns true if GL needs to be called
+		bool NeedsChange(bool differs);
+		// Flag (depth test/blend) in an unknown state
+		enum Flag
+		{
+			EUnknown = -1,
+			EDisabled,
+			EEnabled
+		};
+		bool SetFlag(int& flag, bool enabled);
+
+		unsigned int m_Program;
+		unsigned int m_VertexArray;
+		unsigned int m_Textures[MaxTextureUnits];
+		unsigned int m_ActiveUnit;
+		int m_DepthTest;
+		int m_Blend;
+		unsigned int m_BlendEquation[2];
+		unsigned int m_BlendFunc[4];
+
+		int m_Issued;
+		int m_Skipped;
+	};
+}
@@ -3,19 +3,20 @@
 #include "Renderer.h"
 #include "Texture.h"
 #include "VertexArray.h"
-#include <fstream>
+#include "MeshFile.h"
 #include <sstream>
-#include <rapidjson\document.h>
-#include <SDL_log.h>
-#include "CustomMath.h"
 
 namespace Engine
 {
+	// Fraction past a LOD's screen size needed before switching to or from it
+	static const float LodHysteresis = 0.1f;
+
 	Mesh::Mesh() :
 		m_VertexArray(nullptr),
 		m_Radius(0.0f),
 		m_Box(Vector3::Infinity, Vector3::NegInfinity),
-		m_SpecPower(100.0f)
+		m_SpecPower(100.0f),
+		m_SortID(0)
 	{
 	}
 
@@ -25,137 +26,55 @@ namespace Engine
 
 	bool Mesh::Load(const std::string& fileName, Renderer* renderer)
 	{
-		std::ifstream file(fileName);
-		if (!file.is_open())
-		{
-			SDL_Log("File not found: Mesh %s", fileName.c_str());
-			return false;
-		}
-
-		std::stringstream fileStream;
-		fileStream << file.rdbuf();
-		std::string contents = fileStream.str();
-		rapidjson::StringStream jsonStr(contents.c_str());
-		rapidjson::Document doc;
-		doc.ParseStream(jsonStr);
-
-		if (!doc.IsObject())
-		{
-			SDL_Log("Mesh %s is not valid json", fileName.c_str());
-			return false;
-		}
-
-		int ver = doc["version"].GetInt();
-
-		if (ver != 1)
+		// Binary version if there's an up to date one, json otherwise
+		MeshFile file;
+		if (!file.Load(fileName))
 		{
-			SDL_Log("Mesh %s not version 1", fileName.c_str());
 			return false;
 		}
 
-		m_ShaderName = doc["shader"].GetString();
-		
-		size_t vertSize = 8;
+		Create(file, renderer, false);
+		return true;
+	}
 
-		// Load textures
-		const rapidjson::Value& textures = doc["textures"];
-		if (!textures.IsArray() || textures.Size() < 1)
-		{
-			SDL_Log("Mesh %s has no textures, there should be at least one", fileName.c_str());
-			return false;
-		}
+	void Mesh::Create(const MeshFile& file, Renderer* renderer, bool asyncTextures)
+	{
+		m_ShaderName = file.GetShaderName();
 
 		// Load textures
-		for (rapidjson::SizeType i = 0; i < textures.Size(); i++)
+		for (const auto& texName : file.GetTextureNames())
 		{
 			// Is this texture already loaded?
-			std::string texName = textures[i].GetString();
 			std::stringstream nameStream;
 			nameStream << "src/Assets/3DGraphics/" << texName;
-			Texture* t = renderer->GetTexture(nameStream.str());
+			Texture* t = asyncTextures ? renderer->GetTextureAsync(nameStream.str()) :
+				renderer->GetTexture(nameStream.str());
 			if (t == nullptr)
 			{
-				t = renderer->GetTexture(nameStream.str());
-				if (t == nullptr)
-				{
-					t = renderer->GetTexture("src/Assets/3DGraphics/Default.png");
-				}
-			}
-			m_Textures.emplace_back(t);
-		}
-
-		// Load specular power
-		m_SpecPower = static_cast<float>(doc["specularPower"].GetDouble());
-
-		// Load vertices
-		const rapidjson::Value& vertsJson = doc["vertices"];
-		if (!vertsJson.IsArray() || vertsJson.Size() < 1)
-		{
-			SDL_Log("Mesh %s has no vertices", fileName.c_str());
-			return false;
-		}
-
-		std::vector<float> vertices;
-		vertices.reserve(vertsJson.Size() * vertSize);
-		m_Radius = 0.0f;
-		for (rapidjson::SizeType i = 0; i < vertsJson.Size(); i++)
-		{
-			// For now, just assume we have 8 elements
-			const rapidjson::Value& vert = vertsJson[i];
-			if (!vert.IsArray() || vert.Size() != 8)
-			{
-				SDL_Log("Unexpected vertex format for %s", fileName.c_str());
-				return false;
+				t = renderer->GetTexture("src/Assets/3DGraphics/Default.png");
 			}
-
-			Vector3 pos(vert[0].GetDouble(), vert[1].GetDouble(), vert[2].GetDouble());
-			m_Radius = CustomMath::Max(m_Radius, pos.LengthSq());
-			m_Box.UpdateMinMax(pos);
-
-			// Add the floats
-			for (rapidjson::SizeType i = 0; i < vert.Size(); i++)
+			else
 			{
-				vertices.emplace_back(static_cast<float>(vert[i].GetDouble()));
+				t->SetSampler(file.GetSampler());
 			}
+			m_Textures.emplace_back(t);
 		}
 
-		m_Radius = CustomMath::Sqrt(m_Radius);
-
-		// Load in the indices
-		const rapidjson::Value& indJson = doc["indices"];
-		if (!indJson.IsArray() || indJson.Size() < 1)
-		{
-			SDL_Log("Mesh %s has no indices", fileName.c_str());
-			return false;
-		}
-
-		std::vector<unsigned int> indices;
-		indices.reserve(indJson.Size() * 3);
-		for (rapidjson::SizeType i = 0; i < indJson.Size(); i++)
-		{
-			const rapidjson::Value& ind = indJson[i];
-			if (!ind.IsArray() || ind.Size() != 3)
-			{
-				SDL_Log("Invalid indices for %s", fileName.c_str());
-				return false;
-			}
-
-			indices.emplace_back(ind[0].GetUint());
-			indices.emplace_back(ind[1].GetUint());
-			indices.emplace_back(ind[2].GetUint());
-		}
+		m_SpecPower = file.GetSpecPower();
+		m_Radius = file.GetRadius();
+		m_Box = file.GetBox();
+		m_Lods = file.GetLods();
 
 		// Create a vertex array
-		m_VertexArray = new VertexArray(vertices.data(), static_cast<unsigned>(vertices.size()) / vertSize,
-			indices.data(), static_cast<unsigned>(indices.size()));
-
-		return true;
+		m_VertexArray = new VertexArray(file.GetVertices(), file.GetVertexCount(),
+			file.GetIndices(), file.GetIndexCount());
 	}
 
 	void Mesh::Unload()
 	{
 		delete m_VertexArray;
 		m_VertexArray = nullptr;
+		m_Lods.clear();
 	}
 
 	Texture* Mesh::GetTexture(size_t index)
@@ -169,4 +88,28 @@ namespace Engine
 			return nullptr;
 		}
 	}
+
+	size_t Mesh::SelectLod(float screenSize, size_t current) const
+	{
+		if (m_Lods.size() < 2)
+		{
+			return 0;
+		}
+		if (current >= m_Lods.size())
+		{
+			current = m_Lods.size() - 1;
+		}
+
+		// Coarser while smaller than the next LOD's size, finer while bigger than this one's
+		while (current + 1 < m_Lods.size() &&
+			screenSize < m_Lods[current + 1].m_ScreenSize * (1.0f - LodHysteresis))
+		{
+			current++;
+		}
+		while (current > 0 && screenSize > m_Lods[current].m_ScreenSize * (1.0f + LodHysteresis))
+		{
+			current--;
+		}
+		return current;
+	}
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <vector>
 #include <string>
 #include "Collision.h"
+#include "MeshFile.h"
 
 namespace Engine
 {
@@ -12,7 +13,12 @@ namespace Engine
 		~Mesh();
 
 		bool Load(const std::string& fileName, class Renderer* renderer);
+		// Create the GL data from an already loaded file (main thread)
+		// asyncTextures loads the textures in the background instead of right away
+		void Create(const class MeshFile& file, class Renderer* renderer, bool asyncTextures);
 		void Unload();
+		// False while the mesh is still loading in the background
+		bool IsLoaded() const { return m_VertexArray != nullptr; }
 		// Get the vertex array associated with this mesh
 		class VertexArray* GetVertexArray() { return m_VertexArray; }
 		class Texture* GetTexture(size_t index);
@@ -20,6 +26,17 @@ namespace Engine
 		float GetRadius() const { return m_Radius; }
 		const AABB& GetBox() const { return m_Box; }
 		float GetSpecPower() const { return m_SpecPower; }
+		// Levels of detail, 0 is the full mesh and each one after is coarser
+		size_t GetLodCount() const { return m_Lods.size(); }
+		const MeshLod& GetLod(size_t index) const { return m_Lods[index]; }
+		// LOD to draw at screenSize (bounding sphere diameter over screen height),
+		// given the one drawn last time
+		// Switching needs the size to go a margin past the threshold, so a mesh sitting
+		// right on one doesn't flip between LODs every frame
+		size_t SelectLod(float screenSize, size_t current) const;
+		// Small number identifying the mesh in render queue sort keys
+		unsigned int GetSortID() const { return m_SortID; }
+		void SetSortID(unsigned int id) { m_SortID = id; }
 	private:
 		AABB m_Box;
 		// Textures associated with this mesh
@@ -32,5 +49,8 @@ namespace Engine
 		float m_Radius;
 		// Specular power of the surface
 		float m_SpecPower;
+		// Index ranges of each LOD in the vertex array
+		std::vector<MeshLod> m_Lods;
+		unsigned int m_SortID;
 	};
 }
\ No newline at end of file
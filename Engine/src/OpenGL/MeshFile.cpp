@@ -0,0 +1,669 @@
+#include "MeshFile.h"
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <unordered_map>
+#include <sys/stat.h>
+#include <rapidjson\document.h>
+#include <SDL_log.h>
+#include "CustomMath.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Engine
+{
+	// Round up to the next 16 byte boundary
+	static uint32_t Align16(uint32_t offset)
+	{
+		return (offset + 15u) & ~15u;
+	}
+
+	// Generated LODs cluster vertices on a grid this many cells across the mesh's longest side,
+	// one entry per level past the first
+	static const unsigned int LodGridCells[] = { 32, 16, 8 };
+	// A generated LOD takes over once a grid cell covers about this many pixels
+	// of a 1080 pixel tall screen
+	static const float LodCellPixels = 3.0f;
+	static const float LodReferenceHeight = 1080.0f;
+	// A generated level is dropped if it keeps more than this much of the previous one's triangles
+	static const float LodMinReduction = 0.75f;
+
+	// Read an array of [a, b, c] triangles onto the end of indices
+	static bool ReadTriangles(const rapidjson::Value& trianglesJson, std::vector<unsigned int>& indices)
+	{
+		if (!trianglesJson.IsArray() || trianglesJson.Size() < 1)
+		{
+			return false;
+		}
+		indices.reserve(indices.size() + trianglesJson.Size() * 3);
+		for (rapidjson::SizeType i = 0; i < trianglesJson.Size(); i++)
+		{
+			const rapidjson::Value& ind = trianglesJson[i];
+			if (!ind.IsArray() || ind.Size() != 3)
+			{
+				return false;
+			}
+
+			indices.emplace_back(ind[0].GetUint());
+			indices.emplace_back(ind[1].GetUint());
+			indices.emplace_back(ind[2].GetUint());
+		}
+		return true;
+	}
+
+	static bool GetModifiedTime(const std::string& fileName, time_t& outTime)
+	{
+		struct stat info;
+		if (stat(fileName.c_str(), &info) != 0)
+		{
+			return false;
+		}
+		outTime = info.st_mtime;
+		return true;
+	}
+
+	MeshFile::MeshFile() :
+		m_SpecPower(100.0f),
+		m_Radius(0.0f),
+		m_Box(Vector3::Infinity, Vector3::NegInfinity),
+		m_Vertices(nullptr),
+		m_VertexCount(0),
+		m_Indices(nullptr),
+		m_IndexCount(0),
+		m_MappedData(nullptr),
+		m_MappedSize(0),
+		m_FileHandle(nullptr),
+		m_MappingHandle(nullptr)
+	{
+	}
+
+	MeshFile::~MeshFile()
+	{
+		Unload();
+	}
+
+	bool MeshFile::Load(const std::string& fileName)
+	{
+		const std::string binaryExt = ".gpmeshb";
+		if (fileName.size() > binaryExt.size() &&
+			fileName.compare(fileName.size() - binaryExt.size(), binaryExt.size(), binaryExt) == 0)
+		{
+			return LoadBinary(fileName);
+		}
+
+		// Prefer the converted file, unless the json was edited after converting
+		std::string binaryName = fileName + "b";
+		time_t binaryTime, jsonTime;
+		if (GetModifiedTime(binaryName, binaryTime))
+		{
+			if (!GetModifiedTime(fileName, jsonTime) || binaryTime >= jsonTime)
+			{
+				if (LoadBinary(binaryName))
+				{
+					return true;
+				}
+				SDL_Log("Falling back to %s", fileName.c_str());
+			}
+		}
+
+		return LoadJson(fileName);
+	}
+
+	bool MeshFile::LoadJson(const std::string& fileName)
+	{
+		Unload();
+
+		std::ifstream file(fileName);
+		if (!file.is_open())
+		{
+			SDL_Log("File not found: Mesh %s", fileName.c_str());
+			return false;
+		}
+
+		std::stringstream fileStream;
+		fileStream << file.rdbuf();
+		std::string contents = fileStream.str();
+		rapidjson::StringStream jsonStr(contents.c_str());
+		rapidjson::Document doc;
+		doc.ParseStream(jsonStr);
+
+		if (!doc.IsObject())
+		{
+			SDL_Log("Mesh %s is not valid json", fileName.c_str());
+			return false;
+		}
+
+		int ver = doc["version"].GetInt();
+
+		if (ver != 1)
+		{
+			SDL_Log("Mesh %s not version 1", fileName.c_str());
+			return false;
+		}
+
+		m_ShaderName = doc["shader"].GetString();
+
+		const rapidjson::Value& textures = doc["textures"];
+		if (!textures.IsArray() || textures.Size() < 1)
+		{
+			SDL_Log("Mesh %s has no textures, there should be at least one", fileName.c_str());
+			return false;
+		}
+		for (rapidjson::SizeType i = 0; i < textures.Size(); i++)
+		{
+			m_TextureNames.emplace_back(textures[i].GetString());
+		}
+
+		m_SpecPower = static_cast<float>(doc["specularPower"].GetDouble());
+
+		// Sampler settings are optional, anything left out keeps its default
+		if (doc.HasMember("sampler") && doc["sampler"].IsObject())
+		{
+			const rapidjson::Value& sampler = doc["sampler"];
+			if (sampler.HasMember("wrap") && sampler["wrap"].IsString())
+			{
+				std::string wrap = sampler["wrap"].GetString();
+				if (wrap == "clamp")
+				{
+					m_Sampler.m_Wrap = SamplerSettings::EClamp;
+				}
+				else if (wrap == "mirror")
+				{
+					m_Sampler.m_Wrap = SamplerSettings::EMirror;
+				}
+				else if (wrap != "repeat")
+				{
+					SDL_Log("Mesh %s has unknown wrap mode %s", fileName.c_str(), wrap.c_str());
+				}
+			}
+			if (sampler.HasMember("mipmaps") && sampler["mipmaps"].IsBool())
+			{
+				m_Sampler.m_Mipmaps = sampler["mipmaps"].GetBool();
+			}
+			if (sampler.HasMember("anisotropy") && sampler["anisotropy"].IsNumber())
+			{
+				m_Sampler.m_Anisotropy = static_cast<float>(sampler["anisotropy"].GetDouble());
+			}
+		}
+
+		// Load vertices
+		const rapidjson::Value& vertsJson = doc["vertices"];
+		if (!vertsJson.IsArray() || vertsJson.Size() < 1)
+		{
+			SDL_Log("Mesh %s has no vertices", fileName.c_str());
+			return false;
+		}
+
+		m_VertexStorage.reserve(vertsJson.Size() * VertexSize);
+		m_Radius = 0.0f;
+		for (rapidjson::SizeType i = 0; i < vertsJson.Size(); i++)
+		{
+			const rapidjson::Value& vert = vertsJson[i];
+			if (!vert.IsArray() || vert.Size() != VertexSize)
+			{
+				SDL_Log("Unexpected vertex format for %s", fileName.c_str());
+				return false;
+			}
+
+			Vector3 pos(vert[0].GetDouble(), vert[1].GetDouble(), vert[2].GetDouble());
+			m_Radius = CustomMath::Max(m_Radius, pos.LengthSq());
+			m_Box.UpdateMinMax(pos);
+
+			for (rapidjson::SizeType j = 0; j < vert.Size(); j++)
+			{
+				m_VertexStorage.emplace_back(static_cast<float>(vert[j].GetDouble()));
+			}
+		}
+
+		m_Radius = CustomMath::Sqrt(m_Radius);
+
+		// Load in the indices
+		if (!doc.HasMember("indices") || !ReadTriangles(doc["indices"], m_IndexStorage))
+		{
+			SDL_Log("Mesh %s has no valid indices", fileName.c_str());
+			return false;
+		}
+		m_Lods.emplace_back(MeshLod{ 0, static_cast<uint32_t>(m_IndexStorage.size()), 1.0f });
+
+		// Hand made LODs are optional: [{ "screenSize": 0.1, "indices": [[a, b, c], ...] }, ...]
+		if (doc.HasMember("lods") && doc["lods"].IsArray())
+		{
+			const rapidjson::Value& lods = doc["lods"];
+			for (rapidjson::SizeType i = 0; i < lods.Size(); i++)
+			{
+				const rapidjson::Value& lod = lods[i];
+				uint32_t first = static_cast<uint32_t>(m_IndexStorage.size());
+				if (!lod.IsObject() || !lod.HasMember("screenSize") || !lod["screenSize"].IsNumber() ||
+					!lod.HasMember("indices") || !ReadTriangles(lod["indices"], m_IndexStorage))
+				{
+					SDL_Log("Mesh %s has an invalid LOD %u", fileName.c_str(), i + 1);
+					return false;
+				}
+				m_Lods.emplace_back(MeshLod{ first, static_cast<uint32_t>(m_IndexStorage.size()) - first,
+					static_cast<float>(lod["screenSize"].GetDouble()) });
+			}
+		}
+
+		m_Vertices = m_VertexStorage.data();
+		m_VertexCount = static_cast<unsigned int>(m_VertexStorage.size() / VertexSize);
+		m_Indices = m_IndexStorage.data();
+		m_IndexCount = static_cast<unsigned int>(m_IndexStorage.size());
+		if (!ValidateLods(fileName))
+		{
+			Unload();
+			return false;
+		}
+		return true;
+	}
+
+	bool MeshFile::LoadBinary(const std::string& fileName)
+	{
+		Unload();
+
+		if (!MapFile(fileName))
+		{
+			SDL_Log("File not found: Mesh %s", fileName.c_str());
+			return false;
+		}
+
+		// Check the header before trusting any offsets in it
+		MeshFileHeader header;
+		if (m_MappedSize < sizeof(MeshFileHeader))
+		{
+			SDL_Log("Mesh %s is too small to be a binary mesh", fileName.c_str());
+			Unload();
+			return false;
+		}
+		memcpy(&header, m_MappedData, sizeof(MeshFileHeader));
+
+		if (memcmp(header.m_Magic, "GPMB", 4) != 0 || header.m_Version != BinaryVersion)
+		{
+			SDL_Log("Mesh %s is not a version %u binary mesh", fileName.c_str(), BinaryVersion);
+			Unload();
+			return false;
+		}
+
+		uint64_t vertexBytes = static_cast<uint64_t>(header.m_VertexCount) * VertexSize * sizeof(float);
+		uint64_t indexBytes = static_cast<uint64_t>(header.m_IndexCount) * sizeof(unsigned int);
+		uint64_t lodBytes = static_cast<uint64_t>(header.m_LodCount) * sizeof(MeshLod);
+		if (header.m_VertexSize != VertexSize ||
+			header.m_FileSize != m_MappedSize ||
+			header.m_LodCount < 1 || header.m_LodCount > MaxLods ||
+			header.m_LodsOffset < sizeof(MeshFileHeader) ||
+			header.m_StringsOffset < header.m_LodsOffset + lodBytes ||
+			header.m_VerticesOffset < header.m_StringsOffset ||
+			header.m_IndicesOffset < header.m_VerticesOffset + vertexBytes ||
+			header.m_IndicesOffset + indexBytes > m_MappedSize ||
+			(header.m_VerticesOffset & 15u) != 0 ||
+			(header.m_IndicesOffset & 15u) != 0)
+		{
+			SDL_Log("Mesh %s has a corrupt header", fileName.c_str());
+			Unload();
+			return false;
+		}
+
+		// Strings are packed back to back, each null terminated
+		const char* str = reinterpret_cast<const char*>(m_MappedData + header.m_StringsOffset);
+		const char* strEnd = reinterpret_cast<const char*>(m_MappedData + header.m_VerticesOffset);
+		for (uint32_t i = 0; i <= header.m_TextureCount; i++)
+		{
+			const char* end = static_cast<const char*>(memchr(str, '\0', strEnd - str));
+			if (!end)
+			{
+				SDL_Log("Mesh %s has a corrupt string table", fileName.c_str());
+				Unload();
+				return false;
+			}
+			if (i == 0)
+			{
+				m_ShaderName.assign(str, end);
+			}
+			else
+			{
+				m_TextureNames.emplace_back(str, end);
+			}
+			str = end + 1;
+		}
+
+		m_SpecPower = header.m_SpecPower;
+		m_Sampler.m_Wrap = header.m_Wrap <= SamplerSettings::EMirror ?
+			static_cast<SamplerSettings::WrapMode>(header.m_Wrap) : SamplerSettings::ERepeat;
+		m_Sampler.m_Mipmaps = header.m_Mipmaps != 0;
+		m_Sampler.m_Anisotropy = header.m_Anisotropy;
+		m_Radius = header.m_Radius;
+		m_Box.m_Min = Vector3(header.m_BoxMin[0], header.m_BoxMin[1], header.m_BoxMin[2]);
+		m_Box.m_Max = Vector3(header.m_BoxMax[0], header.m_BoxMax[1], header.m_BoxMax[2]);
+
+		// Vertex/index data is used right out of the mapping
+		m_Vertices = reinterpret_cast<const float*>(m_MappedData + header.m_VerticesOffset);
+		m_VertexCount = header.m_VertexCount;
+		m_Indices = reinterpret_cast<const unsigned int*>(m_MappedData + header.m_IndicesOffset);
+		m_IndexCount = header.m_IndexCount;
+
+		m_Lods.resize(header.m_LodCount);
+		memcpy(m_Lods.data(), m_MappedData + header.m_LodsOffset, static_cast<size_t>(lodBytes));
+		if (!ValidateLods(fileName))
+		{
+			Unload();
+			return false;
+		}
+		return true;
+	}
+
+	bool MeshFile::SaveBinary(const std::string& fileName) const
+	{
+		if (!m_Vertices || !m_Indices)
+		{
+			SDL_Log("Nothing to save to %s", fileName.c_str());
+			return false;
+		}
+
+		// Lay out the blocks
+		std::string strings = m_ShaderName;
+		strings.push_back('\0');
+		for (const auto& texName : m_TextureNames)
+		{
+			strings += texName;
+			strings.push_back('\0');
+		}
+
+		MeshFileHeader header;
+		memset(&header, 0, sizeof(MeshFileHeader));
+		memcpy(header.m_Magic, "GPMB", 4);
+		header.m_Version = BinaryVersion;
+		header.m_VertexSize = VertexSize;
+		header.m_VertexCount = m_VertexCount;
+		header.m_IndexCount = m_IndexCount;
+		header.m_TextureCount = static_cast<uint32_t>(m_TextureNames.size());
+		header.m_SpecPower = m_SpecPower;
+		header.m_Wrap = static_cast<uint32_t>(m_Sampler.m_Wrap);
+		header.m_Mipmaps = m_Sampler.m_Mipmaps ? 1 : 0;
+		header.m_Anisotropy = m_Sampler.m_Anisotropy;
+		header.m_LodCount = static_cast<uint32_t>(m_Lods.size());
+		header.m_Radius = m_Radius;
+		header.m_BoxMin[0] = m_Box.m_Min.x;
+		header.m_BoxMin[1] = m_Box.m_Min.y;
+		header.m_BoxMin[2] = m_Box.m_Min.z;
+		header.m_BoxMax[0] = m_Box.m_Max.x;
+		header.m_BoxMax[1] = m_Box.m_Max.y;
+		header.m_BoxMax[2] = m_Box.m_Max.z;
+		header.m_LodsOffset = Align16(sizeof(MeshFileHeader));
+		uint32_t lodBytes = header.m_LodCount * sizeof(MeshLod);
+		header.m_StringsOffset = Align16(header.m_LodsOffset + lodBytes);
+		header.m_VerticesOffset = Align16(header.m_StringsOffset + static_cast<uint32_t>(strings.size()));
+		uint32_t vertexBytes = m_VertexCount * VertexSize * sizeof(float);
+		header.m_IndicesOffset = Align16(header.m_VerticesOffset + vertexBytes);
+		uint32_t indexBytes = m_IndexCount * sizeof(unsigned int);
+		header.m_FileSize = header.m_IndicesOffset + indexBytes;
+
+		std::vector<unsigned char> data(header.m_FileSize, 0);
+		memcpy(data.data(), &header, sizeof(MeshFileHeader));
+		memcpy(data.data() + header.m_LodsOffset, m_Lods.data(), lodBytes);
+		memcpy(data.data() + header.m_StringsOffset, strings.data(), strings.size());
+		memcpy(data.data() + header.m_VerticesOffset, m_Vertices, vertexBytes);
+		memcpy(data.data() + header.m_IndicesOffset, m_Indices, indexBytes);
+
+		std::ofstream file(fileName, std::ios::binary);
+		if (!file.is_open())
+		{
+			SDL_Log("Couldn't open %s for writing", fileName.c_str());
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(data.data()), data.size());
+		return file.good();
+	}
+
+	void MeshFile::Unload()
+	{
+		UnmapFile();
+		m_ShaderName.clear();
+		m_TextureNames.clear();
+		m_SpecPower = 100.0f;
+		m_Sampler = SamplerSettings();
+		m_Radius = 0.0f;
+		m_Box = AABB(Vector3::Infinity, Vector3::NegInfinity);
+		m_Vertices = nullptr;
+		m_VertexCount = 0;
+		m_Indices = nullptr;
+		m_IndexCount = 0;
+		m_Lods.clear();
+		m_VertexStorage.clear();
+		m_IndexStorage.clear();
+	}
+
+	bool MeshFile::ValidateLods(const std::string& fileName) const
+	{
+		if (m_Lods.empty() || m_Lods.size() > MaxLods)
+		{
+			SDL_Log("Mesh %s has %u LODs, expected 1 to %u", fileName.c_str(),
+				static_cast<unsigned int>(m_Lods.size()), MaxLods);
+			return false;
+		}
+		for (size_t i = 0; i < m_Lods.size(); i++)
+		{
+			const MeshLod& lod = m_Lods[i];
+			if (lod.m_IndexCount == 0 || lod.m_IndexCount % 3 != 0 ||
+				static_cast<uint64_t>(lod.m_FirstIndex) + lod.m_IndexCount > m_IndexCount)
+			{
+				SDL_Log("Mesh %s LOD %u is out of range", fileName.c_str(), static_cast<unsigned int>(i));
+				return false;
+			}
+			// Coarser LODs take over at smaller sizes
+			if (i > 1 && lod.m_ScreenSize >= m_Lods[i - 1].m_ScreenSize)
+			{
+				SDL_Log("Mesh %s LOD %u screen size should be smaller than the LOD before it",
+					fileName.c_str(), static_cast<unsigned int>(i));
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void MeshFile::GenerateLods(unsigned int lodCount)
+	{
+		if (!m_Vertices || m_Lods.empty())
+		{
+			return;
+		}
+
+		// The full mesh's triangles (copied, the storage gets rebuilt below)
+		const MeshLod full = m_Lods[0];
+		std::vector<unsigned int> fullIndices(m_Indices + full.m_FirstIndex,
+			m_Indices + full.m_FirstIndex + full.m_IndexCount);
+		if (m_VertexStorage.empty())
+		{
+			// Vertices were in a mapped file, keep a copy we own
+			m_VertexStorage.assign(m_Vertices, m_Vertices + m_VertexCount * VertexSize);
+			m_Vertices = m_VertexStorage.data();
+		}
+		m_IndexStorage = fullIndices;
+		m_Lods.assign(1, MeshLod{ 0, full.m_IndexCount, 1.0f });
+
+		Vector3 size = m_Box.m_Max - m_Box.m_Min;
+		float longest = CustomMath::Max(size.x, CustomMath::Max(size.y, size.z));
+		if (lodCount > MaxLods)
+		{
+			lodCount = MaxLods;
+		}
+		std::unordered_map<uint64_t, unsigned int> cellClusters;
+		std::vector<unsigned int> vertexCluster(m_VertexCount);
+		std::vector<Vector3> clusterSum;
+		std::vector<unsigned int> clusterCount;
+		std::vector<unsigned int> clusterVertex;
+		std::vector<float> clusterBest;
+		std::vector<unsigned int> lodIndices;
+		for (unsigned int level = 1; level < lodCount && longest > 0.0f; level++)
+		{
+			const unsigned int cells = LodGridCells[level - 1];
+			const float cellSize = longest / cells;
+
+			// Vertices in the same cell whose normals point the same way become one cluster
+			// (the normal keeps the faces of hard edges apart)
+			cellClusters.clear();
+			clusterSum.clear();
+			clusterCount.clear();
+			for (unsigned int v = 0; v < m_VertexCount; v++)
+			{
+				const float* vert = m_Vertices + v * VertexSize;
+				Vector3 pos(vert[0], vert[1], vert[2]);
+				uint64_t cx = static_cast<uint64_t>(CustomMath::Min((pos.x - m_Box.m_Min.x) / cellSize, cells - 1.0f));
+				uint64_t cy = static_cast<uint64_t>(CustomMath::Min((pos.y - m_Box.m_Min.y) / cellSize, cells - 1.0f));
+				uint64_t cz = static_cast<uint64_t>(CustomMath::Min((pos.z - m_Box.m_Min.z) / cellSize, cells - 1.0f));
+				// Dominant axis and sign of the normal
+				float nx = CustomMath::Abs(vert[3]);
+				float ny = CustomMath::Abs(vert[4]);
+				float nz = CustomMath::Abs(vert[5]);
+				uint64_t axis = (nx >= ny && nx >= nz) ? 0 : (ny >= nz ? 1 : 2);
+				uint64_t facing = axis * 2 + (vert[3 + axis] < 0.0f ? 1 : 0);
+				uint64_t key = (((cx * cells + cy) * cells + cz) << 3) | facing;
+
+				auto iter = cellClusters.find(key);
+				unsigned int cluster;
+				if (iter == cellClusters.end())
+				{
+					cluster = static_cast<unsigned int>(clusterSum.size());
+					cellClusters.emplace(key, cluster);
+					clusterSum.emplace_back(Vector3::Zero);
+					clusterCount.emplace_back(0);
+				}
+				else
+				{
+					cluster = iter->second;
+				}
+				vertexCluster[v] = cluster;
+				clusterSum[cluster] += pos;
+				clusterCount[cluster]++;
+			}
+
+			// Each cluster is drawn with its vertex nearest the cluster's average position
+			clusterVertex.assign(clusterSum.size(), 0);
+			clusterBest.assign(clusterSum.size(), CustomMath::Infinity);
+			for (unsigned int v = 0; v < m_VertexCount; v++)
+			{
+				unsigned int cluster = vertexCluster[v];
+				const float* vert = m_Vertices + v * VertexSize;
+				Vector3 center = clusterSum[cluster] * (1.0f / clusterCount[cluster]);
+				float distSq = (Vector3(vert[0], vert[1], vert[2]) - center).LengthSq();
+				if (distSq < clusterBest[cluster])
+				{
+					clusterBest[cluster] = distSq;
+					clusterVertex[cluster] = v;
+				}
+			}
+
+			// Remap the full mesh's triangles, the ones that collapse are dropped
+			lodIndices.clear();
+			for (size_t i = 0; i + 2 < fullIndices.size(); i += 3)
+			{
+				unsigned int a = clusterVertex[vertexCluster[fullIndices[i]]];
+				unsigned int b = clusterVertex[vertexCluster[fullIndices[i + 1]]];
+				unsigned int c = clusterVertex[vertexCluster[fullIndices[i + 2]]];
+				if (a != b && b != c && a != c)
+				{
+					lodIndices.emplace_back(a);
+					lodIndices.emplace_back(b);
+					lodIndices.emplace_back(c);
+				}
+			}
+
+			// Too little saved over the last LOD to be worth it, try the next grid
+			const MeshLod& previous = m_Lods.back();
+			if (lodIndices.empty() || lodIndices.size() > previous.m_IndexCount * LodMinReduction)
+			{
+				continue;
+			}
+			m_Lods.emplace_back(MeshLod{ static_cast<uint32_t>(m_IndexStorage.size()),
+				static_cast<uint32_t>(lodIndices.size()), cells * LodCellPixels / LodReferenceHeight });
+			m_IndexStorage.insert(m_IndexStorage.end(), lodIndices.begin(), lodIndices.end());
+		}
+
+		// m_IndexStorage may have been mapped data before, point at what we own now
+		m_Indices = m_IndexStorage.data();
+		m_IndexCount = static_cast<unsigned int>(m_IndexStorage.size());
+	}
+
+	bool MeshFile::MapFile(const std::string& fileName)
+	{
+#ifdef _WIN32
+		HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping)
+		{
+			CloseHandle(file);
+			return false;
+		}
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!view)
+		{
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+		m_FileHandle = file;
+		m_MappingHandle = mapping;
+		m_MappedData = static_cast<const unsigned char*>(view);
+		m_MappedSize = static_cast<size_t>(size.QuadPart);
+		return true;
+#else
+		int fd = open(fileName.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+		struct stat info;
+		if (fstat(fd, &info) != 0 || info.st_size == 0)
+		{
+			close(fd);
+			return false;
+		}
+		void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		// The mapping keeps the file alive on its own
+		close(fd);
+		if (view == MAP_FAILED)
+		{
+			return false;
+		}
+		m_MappedData = static_cast<const unsigned char*>(view);
+		m_MappedSize = static_cast<size_t>(info.st_size);
+		return true;
+#endif
+	}
+
+	void MeshFile::UnmapFile()
+	{
+		if (!m_MappedData)
+		{
+			return;
+		}
+#ifdef _WIN32
+		UnmapViewOfFile(m_MappedData);
+		CloseHandle(static_cast<HANDLE>(m_MappingHandle));
+		CloseHandle(static_cast<HANDLE>(m_FileHandle));
+#else
+		munmap(const_cast<unsigned char*>(m_MappedData), m_MappedSize);
+#endif
+		m_MappedData = nullptr;
+		m_MappedSize = 0;
+		m_FileHandle = nullptr;
+		m_MappingHandle = nullptr;
+	}
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "Collision.h"
+#include "TextureFile.h"
+
+namespace Engine
+{
+	// One level of detail: a range of the mesh's index buffer
+	// (every LOD shares the same vertices)
+	struct MeshLod
+	{
+		uint32_t m_FirstIndex;
+		uint32_t m_IndexCount;
+		// Projected size (bounding sphere diameter over screen height) below which
+		// this LOD replaces the previous one, unused for LOD 0
+		float m_ScreenSize;
+	};
+
+	// CPU side contents of a mesh file, either parsed from .gpmesh json
+	// or mapped straight from a .gpmeshb binary
+	//
+	// .gpmeshb layout (little endian, every block 16 byte aligned):
+	//   MeshFileHeader
+	//   LOD table: m_LodCount MeshLods
+	//   strings: shader name, then each texture name (null terminated)
+	//   vertices: m_VertexCount * m_VertexSize floats, interleaved like VertexArray wants them
+	//   indices: m_IndexCount unsigned ints, every LOD's triangles back to back
+	// The vertex/index blocks are handed to the VertexArray as they are,
+	// nothing gets parsed per element
+	class MeshFile
+	{
+	public:
+		// Floats per vertex (position, normal, uv)
+		static const unsigned int VertexSize = 8;
+		// Detail levels a mesh can have, including the full one
+		static const unsigned int MaxLods = 4;
+
+		MeshFile();
+		~MeshFile();
+
+		// Parse a .gpmesh json file
+		bool LoadJson(const std::string& fileName);
+		// Map a .gpmeshb binary file
+		bool LoadBinary(const std::string& fileName);
+		// Write the current contents as .gpmeshb
+		bool SaveBinary(const std::string& fileName) const;
+		// Release the data (and the file mapping, if any)
+		void Unload();
+		// Replace any LODs past the first with up to lodCount - 1 coarser ones,
+		// simplified by vertex clustering (levels that barely shrink are left out)
+		void GenerateLods(unsigned int lodCount);
+
+		// Loader fallback chain for fileName (a .gpmesh or .gpmeshb):
+		// the .gpmeshb next to a .gpmesh if it's at least as new, then the json
+		bool Load(const std::string& fileName);
+
+		const std::string& GetShaderName() const { return m_ShaderName; }
+		const std::vector<std::string>& GetTextureNames() const { return m_TextureNames; }
+		float GetSpecPower() const { return m_SpecPower; }
+		// How the mesh's textures are sampled (optional "sampler" object in the json)
+		const SamplerSettings& GetSampler() const { return m_Sampler; }
+		float GetRadius() const { return m_Radius; }
+		const AABB& GetBox() const { return m_Box; }
+
+		const float* GetVertices() const { return m_Vertices; }
+		unsigned int GetVertexCount() const { return m_VertexCount; }
+		const unsigned int* GetIndices() const { return m_Indices; }
+		unsigned int GetIndexCount() const { return m_IndexCount; }
+		// At least one, LOD 0 being the full mesh
+		const std::vector<MeshLod>& GetLods() const { return m_Lods; }
+	private:
+		struct MeshFileHeader
+		{
+			char m_Magic[4];
+			uint32_t m_Version;
+			uint32_t m_VertexSize;
+			uint32_t m_VertexCount;
+			uint32_t m_IndexCount;
+			uint32_t m_TextureCount;
+			float m_SpecPower;
+			float m_Radius;
+			float m_BoxMin[3];
+			float m_BoxMax[3];
+			uint32_t m_Wrap;
+			uint32_t m_Mipmaps;
+			float m_Anisotropy;
+			uint32_t m_LodCount;
+			// Byte offsets from the start of the file
+			uint32_t m_LodsOffset;
+			uint32_t m_StringsOffset;
+			uint32_t m_VerticesOffset;
+			uint32_t m_IndicesOffset;
+			uint32_t m_FileSize;
+		};
+
+		static const uint32_t BinaryVersion = 3;
+
+		// Check the LOD table covers valid triangles of the index buffer
+		bool ValidateLods(const std::string& fileName) const;
+		bool MapFile(const std::string& fileName);
+		void UnmapFile();
+
+		std::string m_ShaderName;
+		std::vector<std::string> m_TextureNames;
+		float m_SpecPower;
+		SamplerSettings m_Sampler;
+		float m_Radius;
+		AABB m_Box;
+
+		// Point into m_VertexStorage/m_IndexStorage (json) or the mapped file (binary)
+		const float* m_Vertices;
+		unsigned int m_VertexCount;
+		const unsigned int* m_Indices;
+		unsigned int m_IndexCount;
+		std::vector<MeshLod> m_Lods;
+		std::vector<float> m_VertexStorage;
+		std::vector<unsigned int> m_IndexStorage;
+
+		// Mapped file view (OS handles kept as void* so the header stays platform neutral)
+		const unsigned char* m_MappedData;
+		size_t m_MappedSize;
+		void* m_FileHandle;
+		void* m_MappingHandle;
+	};
+}
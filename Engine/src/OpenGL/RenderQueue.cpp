@@ -0,0 +1,141 @@
+#include "RenderQueue.h"
+#include "Mesh.h"
+#include "Texture.h"
+#include <utility>
+
+namespace Engine
+{
+	RenderQueue::RenderQueue() :
+		m_QuadSequence(0)
+	{
+	}
+
+	void RenderQueue::Clear()
+	{
+		m_Commands.clear();
+		m_Transforms.clear();
+		m_QuadSequence = 0;
+	}
+
+	void RenderQueue::AddMesh(unsigned int shader, Mesh* mesh, unsigned int lod, Texture* texture,
+		const Matrix4& world, float depth, float farDepth)
+	{
+		SetMesh(Allocate(1), shader, mesh, lod, texture, world, depth, farDepth);
+	}
+
+	void RenderQueue::AddQuad(Pass pass, Texture* texture, const Matrix4& world, int drawOrder)
+	{
+		// Draw order is signed, bias it so negative orders still sort first
+		uint64_t order = static_cast<uint64_t>(static_cast<int64_t>(drawOrder) + (1 << 19)) & 0xfffff;
+		uint64_t textureBits = texture ? (texture->GetTextureID() & 0xffff) : 0;
+		uint64_t key = static_cast<uint64_t>(pass) << 60;
+		if (pass == EUI)
+		{
+			// UI keeps the exact order it was added in (later draws go on top)
+			key |= m_QuadSequence & 0xfffff;
+		}
+		else
+		{
+			key |= (order << 36) | (textureBits << 20) | (m_QuadSequence & 0xfffff);
+		}
+		m_QuadSequence++;
+
+		m_Commands.emplace_back(RenderCommand{ key, nullptr, texture,
+			static_cast<uint32_t>(m_Transforms.size()) });
+		m_Transforms.emplace_back(world);
+	}
+
+	size_t RenderQueue::Allocate(size_t count)
+	{
+		size_t first = m_Commands.size();
+		m_Commands.resize(first + count);
+		m_Transforms.resize(first + count);
+		return first;
+	}
+
+	void RenderQueue::SetMesh(size_t index, unsigned int shader, Mesh* mesh, unsigned int lod,
+		Texture* texture, const Matrix4& world, float depth, float farDepth)
+	{
+		RenderCommand& command = m_Commands[index];
+		command.m_Key = MakeMeshKey(shader, mesh, lod, texture, depth, farDepth);
+		command.m_Mesh = mesh;
+		command.m_Texture = texture;
+		// Allocate gives every command its own transform slot
+		command.m_Transform = static_cast<uint32_t>(index);
+		m_Transforms[index] = world;
+	}
+
+	uint64_t RenderQueue::MakeMeshKey(unsigned int shader, Mesh* mesh, unsigned int lod,
+		Texture* texture, float depth, float farDepth)
+	{
+		// Depth as 24 bits of [0, farDepth]
+		float t = farDepth > 0.0f ? CustomMath::Clamp(depth / farDepth, 0.0f, 1.0f) : 0.0f;
+		uint64_t depthBits = static_cast<uint64_t>(t * 16777215.0f);
+		uint64_t textureBits = texture ? (texture->GetTextureID() & 0xffff) : 0;
+		// Each LOD of a mesh batches on its own
+		uint64_t meshBits = ((mesh->GetSortID() & 0x3fff) << 2) | (lod & 0x3);
+		return (static_cast<uint64_t>(EOpaque) << 60) | (static_cast<uint64_t>(shader & 0xf) << 56) |
+			(textureBits << 40) | (meshBits << 24) | depthBits;
+	}
+
+	void RenderQueue::Sort()
+	{
+		const size_t count = m_Commands.size();
+		if (count < 2)
+		{
+			return;
+		}
+
+		m_SortEntries.resize(count);
+		m_SortScratch.resize(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			m_SortEntries[i].m_Key = m_Commands[i].m_Key;
+			m_SortEntries[i].m_Index = static_cast<uint32_t>(i);
+		}
+
+		// Count every byte of every key in one go
+		size_t counts[8][256] = {};
+		for (const auto& entry : m_SortEntries)
+		{
+			for (int b = 0; b < 8; b++)
+			{
+				counts[b][(entry.m_Key >> (b * 8)) & 0xff]++;
+			}
+		}
+
+		// LSD radix sort, a byte at a time (stable, so earlier bytes stay sorted)
+		SortEntry* src = m_SortEntries.data();
+		SortEntry* dest = m_SortScratch.data();
+		for (int b = 0; b < 8; b++)
+		{
+			// Every key has the same byte here, nothing to do
+			size_t first = (src[0].m_Key >> (b * 8)) & 0xff;
+			if (counts[b][first] == count)
+			{
+				continue;
+			}
+
+			size_t offsets[256];
+			size_t total = 0;
+			for (int i = 0; i < 256; i++)
+			{
+				offsets[i] = total;
+				total += counts[b][i];
+			}
+			for (size_t i = 0; i < count; i++)
+			{
+				size_t bucket = (src[i].m_Key >> (b * 8)) & 0xff;
+				dest[offsets[bucket]++] = src[i];
+			}
+			std::swap(src, dest);
+		}
+
+		m_SortedCommands.resize(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			m_SortedCommands[i] = m_Commands[src[i].m_Index];
+		}
+		m_Commands.swap(m_SortedCommands);
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "CustomMath.h"
+
+namespace Engine
+{
+	// One thing to draw, with a 64 bit key that puts it in the right place when sorted
+	struct RenderCommand
+	{
+		uint64_t m_Key;
+		// nullptr for a textured quad (sprite/UI)
+		class Mesh* m_Mesh;
+		class Texture* m_Texture;
+		// Index into the queue's transforms
+		uint32_t m_Transform;
+	};
+
+	// Everything the renderer draws in a frame, as a list of commands
+	// Scene/visibility code adds commands (in any order, from several threads with Allocate),
+	// Sort orders them by key, and the renderer walks the sorted list once to issue the GL calls.
+	// Key layout, high bits first:
+	//   pass (4) | shader (4) | the rest depends on the pass
+	//   meshes:       texture (16) | mesh (14) | LOD (2) | depth (24), nearest first
+	//   sprites:      draw order (20) | texture (16) | sequence (20), so equal keys keep their order
+	//   UI:           sequence (20), drawn in the order it was added
+	class RenderQueue
+	{
+	public:
+		// Passes draw in this order
+		enum Pass
+		{
+			EOpaque,
+			ESprites,
+			EUI,
+			ENumPasses
+		};
+
+		RenderQueue();
+
+		void Clear();
+		// Depth is the distance from the camera, and farDepth the largest that gets its own key
+		// lod picks which of the mesh's index ranges is drawn
+		void AddMesh(unsigned int shader, class Mesh* mesh, unsigned int lod, class Texture* texture,
+			const Matrix4& world, float depth, float farDepth);
+		// Unit quad ([-0.5, 0.5] on x/y) transformed by world (quads all use shader 0)
+		void AddQuad(Pass pass, class Texture* texture, const Matrix4& world, int drawOrder = 0);
+
+		// Make room for count commands (and their transforms) at the end,
+		// returns the index of the first one
+		// Fill them with SetMesh, each from any thread as long as no two write the same index
+		size_t Allocate(size_t count);
+		void SetMesh(size_t index, unsigned int shader, class Mesh* mesh, unsigned int lod,
+			class Texture* texture, const Matrix4& world, float depth, float farDepth);
+
+		// Radix sort the commands by key (stable)
+		void Sort();
+
+		// Sorted commands (after Sort)
+		const std::vector<RenderCommand>& GetCommands() const { return m_Commands; }
+		const Matrix4& GetTransform(const RenderCommand& command) const { return m_Transforms[command.m_Transform]; }
+		static Pass GetPass(const RenderCommand& command) { return static_cast<Pass>(command.m_Key >> 60); }
+		static unsigned int GetShader(const RenderCommand& command) { return static_cast<unsigned int>(command.m_Key >> 56) & 0xf; }
+		// Mesh commands only
+		static unsigned int GetLod(const RenderCommand& command) { return static_cast<unsigned int>(command.m_Key >> 24) & 0x3; }
+	private:
+		static uint64_t MakeMeshKey(unsigned int shader, class Mesh* mesh, unsigned int lod,
+			class Texture* texture, float depth, float farDepth);
+
+		std::vector<RenderCommand> m_Commands;
+		std::vector<Matrix4> m_Transforms;
+		// Sort buffers (key + command index)
+		struct SortEntry
+		{
+			uint64_t m_Key;
+			uint32_t m_Index;
+		};
+		std::vector<SortEntry> m_SortEntries;
+		std::vector<SortEntry> m_SortScratch;
+		std::vector<RenderCommand> m_SortedCommands;
+		// Quads added since Clear, keeps equal quad keys in the order they were added
+		uint32_t m_QuadSequence;
+	};
+}
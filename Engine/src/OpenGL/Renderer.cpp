@@ -7,16 +7,48 @@
 #include "VertexArray.h"
 #include "SpriteComponent.h"
 #include "MeshComponent.h"
+#include "MeshFile.h"
+#include "TextureFile.h"
+#include "JobSystem.h"
+#include "SpriteBatch.h"
+#include "TextureAtlas.h"
+#include "RenderQueue.h"
+#include "GLStateCache.h"
 #include <GL\glew.h>
 #include "Game.h"
 #include "UIScreen.h"
+#include "Actor.h"
 
 namespace Engine
 {
+	// Uniform buffer binding point of the FrameData block
+	static const GLuint FrameDataBinding = 0;
+	// Far plane of the projection
+	static const float FarPlane = 10000.0f;
+	// Shader field of mesh command keys
+	static const unsigned int MeshShaderKey = 0;
+
 	Renderer::Renderer(Game* game) :
+		m_MaxUploadsPerFrame(4),
 		m_Game(game),
 		m_SpriteShader(nullptr),
-		m_MeshShader(nullptr)
+		m_SpriteBatch(nullptr),
+		m_SpriteDrawCalls(0),
+		m_MeshShader(nullptr),
+		m_InstancedMeshShader(nullptr),
+		m_Culling(true),
+		m_MeshesTested(0),
+		m_MeshesCulled(0),
+		m_Lods(true),
+		m_MeshTriangles(0),
+		m_RenderQueue(nullptr),
+		m_GLState(nullptr),
+		m_NextMeshID(1),
+		m_InstanceBuffer(0),
+		m_InstanceBufferSize(0),
+		m_Instancing(true),
+		m_MeshDrawCalls(0),
+		m_FrameDataBuffer(0)
 	{
 	}
 
@@ -83,25 +115,46 @@ namespace Engine
 			return false;
 		}
 
-		// Create quad for drawing sprites
-		CreateSpriteVerts();
+		m_GLState = new GLStateCache();
+
+		// Sprites and UI all go through one batch
+		m_SpriteBatch = new SpriteBatch();
+		m_SpriteBatch->Initialize(m_GLState);
+		m_RenderQueue = new RenderQueue();
 
 		return true;
 	}
 
 	void Renderer::Shutdown()
 	{
-		delete m_SpriteVerts;
+		m_SpriteBatch->Shutdown();
+		delete m_SpriteBatch;
+		delete m_RenderQueue;
+		delete m_GLState;
 		m_SpriteShader->Unload();
 		delete m_SpriteShader;
 		m_MeshShader->Unload();
 		delete m_MeshShader;
+		m_InstancedMeshShader->Unload();
+		delete m_InstancedMeshShader;
+		glDeleteBuffers(1, &m_InstanceBuffer);
+		glDeleteBuffers(1, &m_FrameDataBuffer);
 		SDL_GL_DeleteContext(m_Context);
 		SDL_DestroyWindow(m_Window);
 	}
 
 	void Renderer::UnloadData()
 	{
+		// Let background loads finish before deleting what they write to
+		for (auto load : m_PendingLoads)
+		{
+			m_Game->GetJobSystem()->Wait(load->m_Counter);
+			delete load->m_TextureFile;
+			delete load->m_MeshFile;
+			delete load;
+		}
+		m_PendingLoads.clear();
+
 		for (auto i : m_Textures)
 		{
 			i.second->Unload();
@@ -109,6 +162,13 @@ namespace Engine
 		}
 		m_Textures.clear();
 
+		for (auto atlas : m_Atlases)
+		{
+			atlas->Unload();
+			delete atlas;
+		}
+		m_Atlases.clear();
+
 		for (auto i : m_Meshes)
 		{
 			i.second->Unload();
@@ -119,89 +179,81 @@ namespace Engine
 
 	void Renderer::Draw()
 	{
+		ProcessUploads();
+		// Loads and unloads bind/delete GL objects behind the cache's back
+		m_GLState->Invalidate();
+		m_GLState->ResetCounters();
+		UpdateFrameData();
+
 		glClearColor(0.86f, 0.86f, 0.86f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		// Draw Mesh Components
-		// Enable depth buffering/disable alpha blend
-		glEnable(GL_DEPTH_TEST);
-		glDisable(GL_BLEND);
-
-		m_MeshShader->SetActive();
-		m_MeshShader->SetMatrixUniform("uViewProj", m_View * m_Projection);
-		// Update light uniforms
-		SetLightUniforms(m_MeshShader);
-		for (auto mc : m_MeshComps)
-		{
-			if (mc->GetVisible()) mc->Draw(m_MeshShader);
-		}
-
-		// Draw all Sprite Components
-		// Enable alpha blending on the color buffer
-		glDisable(GL_DEPTH_TEST);
-		glEnable(GL_BLEND);
-		glBlendEquationSeparate(GL_FUNC_ADD, GL_FUNC_ADD);
-		glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ZERO);
-
-		m_SpriteShader->SetActive();
-		m_SpriteVerts->SetActive();
-
+		// Collect everything into the queue, then sort and draw it in one go
+		m_RenderQueue->Clear();
+		CullMeshes();
+		QueueMeshes();
 		for (auto sprite : m_Sprites)
 		{
-			sprite->Draw(m_SpriteShader);
+			sprite->Draw(m_RenderQueue);
 		}
-
-		// Draw any UI screens
+		// UI screens in the order they draw, on top of the sprites
 		for (auto ui : m_Game->GetUIStack())
 		{
-			ui->Draw(m_SpriteShader);
+			ui->Draw(m_RenderQueue);
 		}
+		m_RenderQueue->Sort();
+		SubmitCommands();
 
 		SDL_GL_SwapWindow(m_Window);
 	}
 
-	void Renderer::AddSprite(SpriteComponent* sprite)
+	int Renderer::GetStateChangesIssued() const
 	{
-		// Find the insertion point in the sorted vector
-		// (The first element with a higher draw order than me)
-		int myDrawOrder = sprite->GetDrawOrder();
-		auto iter = m_Sprites.begin();
-		for (; iter != m_Sprites.end(); ++iter)
-		{
-			if (myDrawOrder < (*iter)->GetDrawOrder())
-			{
-				break;
-			}
-		}
+		return m_GLState->GetIssuedChanges();
+	}
+
+	int Renderer::GetStateChangesSkipped() const
+	{
+		return m_GLState->GetSkippedChanges();
+	}
 
-		m_Sprites.insert(iter, sprite);
+	SlotHandle Renderer::AddSprite(SpriteComponent* sprite)
+	{
+		// Draw order is part of the sort key, so the list doesn't have to stay sorted
+		return m_Sprites.Insert(sprite);
 	}
 
-	void Renderer::RemoveSprite(SpriteComponent* sprite)
+	void Renderer::RemoveSprite(SlotHandle handle)
 	{
-		// We can't swap because it ruins ordering
-		auto iter = std::find(m_Sprites.begin(), m_Sprites.end(), sprite);
-		m_Sprites.erase(iter);
+		m_Sprites.Remove(handle);
 	}
 
-	void Renderer::AddMeshComp(MeshComponent* mesh)
+	SlotHandle Renderer::AddMeshComp(MeshComponent* mesh)
 	{
-		m_MeshComps.emplace_back(mesh);
+		return m_MeshComps.Insert(mesh);
 	}
 
-	void Renderer::RemoveMeshComp(MeshComponent* mesh)
+	void Renderer::RemoveMeshComp(SlotHandle handle)
 	{
-		auto iter = std::find(m_MeshComps.begin(), m_MeshComps.end(), mesh);
-		m_MeshComps.erase(iter);
+		m_MeshComps.Remove(handle);
 	}
 
 	Texture* Renderer::GetTexture(const std::string& fileName)
 	{
-		Texture* tex = nullptr;
+		Texture* tex = FindAtlasTexture(fileName);
+		if (tex)
+		{
+			return tex;
+		}
+
 		auto iter = m_Textures.find(fileName);
 		if (iter != m_Textures.end())
 		{
 			tex = iter->second;
+			if (!tex->IsLoaded())
+			{
+				FinishLoad(tex, nullptr);
+			}
 		}
 		else
 		{
@@ -220,6 +272,27 @@ namespace Engine
 		return tex;
 	}
 
+	bool Renderer::LoadAtlas(const std::vector<std::string>& fileNames, int pageSize)
+	{
+		TextureAtlas* atlas = new TextureAtlas(pageSize);
+		bool success = atlas->Build(fileNames);
+		m_Atlases.emplace_back(atlas);
+		return success;
+	}
+
+	Texture* Renderer::FindAtlasTexture(const std::string& fileName) const
+	{
+		for (auto atlas : m_Atlases)
+		{
+			Texture* tex = atlas->GetTexture(fileName);
+			if (tex)
+			{
+				return tex;
+			}
+		}
+		return nullptr;
+	}
+
 	Mesh* Renderer::GetMesh(const std::string& fileName)
 	{
 		Mesh* m = nullptr;
@@ -227,10 +300,15 @@ namespace Engine
 		if (iter != m_Meshes.end())
 		{
 			m = iter->second;
+			if (!m->IsLoaded())
+			{
+				FinishLoad(nullptr, m);
+			}
 		}
 		else
 		{
 			m = new Mesh();
+			m->SetSortID(m_NextMeshID++);
 			if (m->Load(fileName, this))
 			{
 				m_Meshes.emplace(fileName, m);
@@ -278,10 +356,7 @@ namespace Engine
 			return false;
 		}
 
-		m_SpriteShader->SetActive();
-		// Set the view-projection matrix
-		Matrix4 viewProj = Matrix4::CreateSimpleViewProj(m_ScreenWidth, m_ScreenHeight);
-		m_SpriteShader->SetMatrixUniform("uViewProj", viewProj);
+		m_SpriteViewProj = Matrix4::CreateSimpleViewProj(m_ScreenWidth, m_ScreenHeight);
 
 		m_MeshShader = new Shader();
 		if (!m_MeshShader->Load("src/Shaders/Phong.vert", "src/Shaders/Phong.frag"))
@@ -289,51 +364,485 @@ namespace Engine
 			return false;
 		}
 
-		m_MeshShader->SetActive();
 		m_View = Matrix4::CreateLookAt(Vector3::Zero, Vector3::UnitX, Vector3::UnitZ);
+		m_PrevView = m_View;
+		m_RenderView = m_View;
 		m_Projection = Matrix4::CreatePerspectiveFOV(
 			CustomMath::ToRadians(70.0f),		// Horizontal Field of View
 			m_ScreenWidth,			
 			m_ScreenHeight, 
 			25.0f,								// Near plane
-			10000.0f);							// Far plane
-		m_MeshShader->SetMatrixUniform("uViewProj", m_View * m_Projection);
+			FarPlane);							// Far plane
+
+		m_InstancedMeshShader = new Shader();
+		if (!m_InstancedMeshShader->Load("src/Shaders/PhongInstanced.vert", "src/Shaders/Phong.frag"))
+		{
+			return false;
+		}
+		glGenBuffers(1, &m_InstanceBuffer);
+
+		// View-projection and lighting live in one uniform buffer all the shaders share,
+		// so they're uploaded once per frame instead of once per shader
+		glGenBuffers(1, &m_FrameDataBuffer);
+		glBindBuffer(GL_UNIFORM_BUFFER, m_FrameDataBuffer);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), nullptr, GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_UNIFORM_BUFFER, FrameDataBinding, m_FrameDataBuffer);
+		m_SpriteShader->BindUniformBlock("FrameData", FrameDataBinding);
+		m_MeshShader->BindUniformBlock("FrameData", FrameDataBinding);
+		m_InstancedMeshShader->BindUniformBlock("FrameData", FrameDataBinding);
+		UpdateFrameData();
 
 		return true;
 	}
 
-	void Renderer::CreateSpriteVerts()
+	void Renderer::CullMeshes()
 	{
-		float vertices[] = {
-			-0.5f,  0.5f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, // top left
-			 0.5f,  0.5f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, // top right	
-			 0.5f, -0.5f, 0.f, 0.f, 0.f, 0.f, 1.f, 1.f, // bottom right
-			-0.5f, -0.5f, 0.f, 0.f, 0.f, 0.f, 0.f, 1.f  // bottom left
-		};
+		m_VisibleMeshes.clear();
+		m_CullCandidates.clear();
+		m_CullSpheres.Clear();
+		for (auto mc : m_MeshComps)
+		{
+			Mesh* mesh = mc->GetMesh();
+			if (!mc->GetVisible() || !mesh || !mesh->IsLoaded())
+			{
+				continue;
+			}
+			if (!m_Culling)
+			{
+				m_VisibleMeshes.emplace_back(mc);
+				continue;
+			}
 
-		unsigned int indices[] = {
-			0, 1, 2,
-			2, 3, 0
-		};
+			// Mesh radius is around the object's origin, scaled by the biggest axis
+			const Matrix4& world = mc->GetOwner()->GetRenderTransform();
+			Vector3 scale = world.GetScale();
+			float maxScale = CustomMath::Max(scale.x, CustomMath::Max(scale.y, scale.z));
+			m_CullCandidates.emplace_back(mc);
+			m_CullSpheres.Add(world.GetTranslation(), mesh->GetRadius() * maxScale);
+		}
+
+		m_MeshesTested = m_CullCandidates.size();
+		m_MeshesCulled = 0;
+		if (m_CullCandidates.empty())
+		{
+			return;
+		}
+
+		m_Frustum.Extract(m_RenderView * m_Projection);
+		m_CullResults.resize(m_CullCandidates.size());
+		m_Frustum.CullSpheres(m_CullSpheres, m_CullResults.data());
+
+		// Meshes whose sphere touches the frustum get a tighter test with their world box
+		// (the object box transformed, with extents from the absolute rotation/scale)
+		m_CullBoxes.Clear();
+		size_t survivors = 0;
+		for (size_t i = 0; i < m_CullCandidates.size(); i++)
+		{
+			if (!m_CullResults[i])
+			{
+				continue;
+			}
+			MeshComponent* mc = m_CullCandidates[i];
+			const AABB& box = mc->GetMesh()->GetBox();
+			const Matrix4& world = mc->GetOwner()->GetRenderTransform();
+			Vector3 center = Vector3::Transform((box.m_Min + box.m_Max) * 0.5f, world);
+			Vector3 halfSize = (box.m_Max - box.m_Min) * 0.5f;
+			Vector3 extents;
+			extents.x = CustomMath::Abs(world.mat[0][0]) * halfSize.x +
+				CustomMath::Abs(world.mat[1][0]) * halfSize.y + CustomMath::Abs(world.mat[2][0]) * halfSize.z;
+			extents.y = CustomMath::Abs(world.mat[0][1]) * halfSize.x +
+				CustomMath::Abs(world.mat[1][1]) * halfSize.y + CustomMath::Abs(world.mat[2][1]) * halfSize.z;
+			extents.z = CustomMath::Abs(world.mat[0][2]) * halfSize.x +
+				CustomMath::Abs(world.mat[1][2]) * halfSize.y + CustomMath::Abs(world.mat[2][2]) * halfSize.z;
+			m_CullBoxes.Add(center, extents);
+			m_CullCandidates[survivors++] = mc;
+		}
+		m_CullCandidates.resize(survivors);
+
+		m_Frustum.CullBoxes(m_CullBoxes, m_CullResults.data());
+		for (size_t i = 0; i < survivors; i++)
+		{
+			if (m_CullResults[i])
+			{
+				m_VisibleMeshes.emplace_back(m_CullCandidates[i]);
+			}
+		}
+		m_MeshesCulled = m_MeshesTested - m_VisibleMeshes.size();
+	}
+
+	void Renderer::QueueMeshes()
+	{
+		const size_t count = m_VisibleMeshes.size();
+		if (count == 0)
+		{
+			return;
+		}
+
+		// Each chunk fills its own slots, so building the commands can go wide
+		size_t first = m_RenderQueue->Allocate(count);
+		m_Game->GetJobSystem()->ParallelFor(count, 256, [this, first](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					MeshComponent* mc = m_VisibleMeshes[i];
+					Mesh* mesh = mc->GetMesh();
+					const Matrix4& world = mc->GetOwner()->GetRenderTransform();
+					// View space z is the distance in front of the camera
+					float depth = Vector3::Transform(world.GetTranslation(), m_RenderView).z;
+
+					size_t lod = 0;
+					if (m_Lods && mesh->GetLodCount() > 1)
+					{
+						// Projected bounding sphere diameter over the screen height
+						// (the projection scales y by cot(fov / 2), depth divides it)
+						Vector3 scale = world.GetScale();
+						float radius = mesh->GetRadius() * CustomMath::Max(scale.x, CustomMath::Max(scale.y, scale.z));
+						float screenSize = depth > 0.0f ? radius * m_Projection.mat[1][1] / depth : CustomMath::Infinity;
+						lod = mesh->SelectLod(screenSize, mc->GetLod());
+					}
+					// Only this chunk touches mc, so remembering the LOD is safe here
+					mc->SetLod(lod);
+					m_RenderQueue->SetMesh(first + i, MeshShaderKey, mesh, static_cast<unsigned int>(lod),
+						mc->GetTexture(), world, depth, FarPlane);
+				}
+			});
+	}
+
+	void Renderer::SubmitCommands()
+	{
+		const std::vector<RenderCommand>& commands = m_RenderQueue->GetCommands();
+		m_MeshDrawCalls = 0;
+		m_SpriteDrawCalls = 0;
+		m_MeshTriangles = 0;
+
+		size_t begin = 0;
+		while (begin < commands.size())
+		{
+			// Meshes come first, then every quad (sprites and UI share the same state)
+			bool meshes = RenderQueue::GetPass(commands[begin]) == RenderQueue::EOpaque;
+			size_t end = begin + 1;
+			while (end < commands.size() &&
+				(RenderQueue::GetPass(commands[end]) == RenderQueue::EOpaque) == meshes)
+			{
+				end++;
+			}
+
+			if (meshes)
+			{
+				// Enable depth buffering/disable alpha blend
+				m_GLState->SetDepthTest(true);
+				m_GLState->SetBlend(false);
+				if (m_Instancing)
+				{
+					DrawMeshesInstanced(begin, end);
+				}
+				else
+				{
+					DrawMeshes(begin, end);
+				}
+			}
+			else
+			{
+				// Enable alpha blending on the color buffer
+				m_GLState->SetDepthTest(false);
+				m_GLState->SetBlend(true);
+				m_GLState->SetBlendEquation(GL_FUNC_ADD, GL_FUNC_ADD);
+				m_GLState->SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ZERO);
+				DrawQuads(begin, end);
+			}
+			begin = end;
+		}
+	}
+
+	void Renderer::DrawMeshes(size_t begin, size_t end)
+	{
+		const std::vector<RenderCommand>& commands = m_RenderQueue->GetCommands();
+		m_MeshShader->SetActive(m_GLState);
+
+		Mesh* mesh = nullptr;
+		Texture* texture = nullptr;
+		for (size_t i = begin; i < end; i++)
+		{
+			const RenderCommand& command = commands[i];
+			// Commands are sorted by texture then mesh/LOD, so these rarely change
+			if (command.m_Texture != texture)
+			{
+				texture = command.m_Texture;
+				if (texture)
+				{
+					texture->SetActive(m_GLState);
+				}
+			}
+			if (command.m_Mesh != mesh)
+			{
+				mesh = command.m_Mesh;
+				m_MeshShader->SetFloatUniform("uSpecPower", mesh->GetSpecPower());
+				mesh->GetVertexArray()->SetActive(m_GLState);
+			}
+
+			m_MeshShader->SetMatrixUniform("uWorldTransform", m_RenderQueue->GetTransform(command));
+			const MeshLod& lod = mesh->GetLod(RenderQueue::GetLod(command));
+			glDrawElements(
+				GL_TRIANGLES,
+				lod.m_IndexCount,
+				GL_UNSIGNED_INT,
+				reinterpret_cast<void*>(lod.m_FirstIndex * sizeof(unsigned int))
+			);
+			m_MeshDrawCalls++;
+			m_MeshTriangles += lod.m_IndexCount / 3;
+		}
+	}
+
+	void Renderer::DrawMeshesInstanced(size_t begin, size_t end)
+	{
+		const std::vector<RenderCommand>& commands = m_RenderQueue->GetCommands();
+
+		// Each run of equal mesh/LOD/texture becomes a batch, transforms packed in batch order
+		m_MeshBatches.clear();
+		m_InstanceTransforms.clear();
+		for (size_t i = begin; i < end; i++)
+		{
+			const RenderCommand& command = commands[i];
+			unsigned int lod = RenderQueue::GetLod(command);
+			if (m_MeshBatches.empty() || m_MeshBatches.back().m_Mesh != command.m_Mesh ||
+				m_MeshBatches.back().m_Lod != lod || m_MeshBatches.back().m_Texture != command.m_Texture)
+			{
+				m_MeshBatches.emplace_back(MeshBatch{ command.m_Mesh, lod, command.m_Texture,
+					m_InstanceTransforms.size(), 0 });
+			}
+			m_InstanceTransforms.emplace_back(m_RenderQueue->GetTransform(command));
+			m_MeshBatches.back().m_Count++;
+		}
+
+		// One upload for every instance this frame
+		// (growing reallocates, otherwise orphan the old contents so we don't wait on the GPU)
+		size_t bytes = m_InstanceTransforms.size() * sizeof(Matrix4);
+		glBindBuffer(GL_ARRAY_BUFFER, m_InstanceBuffer);
+		if (bytes > m_InstanceBufferSize)
+		{
+			m_InstanceBufferSize = bytes * 2;
+		}
+		glBufferData(GL_ARRAY_BUFFER, m_InstanceBufferSize, nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, m_InstanceTransforms.data());
+
+		m_InstancedMeshShader->SetActive(m_GLState);
+
+		Mesh* mesh = nullptr;
+		Texture* texture = nullptr;
+		for (const auto& batch : m_MeshBatches)
+		{
+			if (batch.m_Texture != texture)
+			{
+				texture = batch.m_Texture;
+				if (texture)
+				{
+					texture->SetActive(m_GLState);
+				}
+			}
+			if (batch.m_Mesh != mesh)
+			{
+				mesh = batch.m_Mesh;
+				m_InstancedMeshShader->SetFloatUniform("uSpecPower", mesh->GetSpecPower());
+			}
+
+			VertexArray* va = batch.m_Mesh->GetVertexArray();
+			va->SetActive(m_GLState);
+			va->SetInstanceTransforms(m_InstanceBuffer, batch.m_First * sizeof(Matrix4));
+			const MeshLod& lod = batch.m_Mesh->GetLod(batch.m_Lod);
+			glDrawElementsInstanced(
+				GL_TRIANGLES,
+				lod.m_IndexCount,
+				GL_UNSIGNED_INT,
+				reinterpret_cast<void*>(lod.m_FirstIndex * sizeof(unsigned int)),
+				static_cast<GLsizei>(batch.m_Count)
+			);
+			m_MeshDrawCalls++;
+			m_MeshTriangles += lod.m_IndexCount / 3 * batch.m_Count;
+		}
+	}
+
+	void Renderer::DrawQuads(size_t begin, size_t end)
+	{
+		const std::vector<RenderCommand>& commands = m_RenderQueue->GetCommands();
+
+		// Already in draw order, so the batch keeps it
+		m_SpriteBatch->Begin(SpriteBatch::ESubmitOrder);
+		for (size_t i = begin; i < end; i++)
+		{
+			m_SpriteBatch->Draw(commands[i].m_Texture, m_RenderQueue->GetTransform(commands[i]));
+		}
+		m_SpriteBatch->End(m_SpriteShader);
+		m_SpriteDrawCalls += m_SpriteBatch->GetDrawCalls();
+	}
+
+	Texture* Renderer::GetTextureAsync(const std::string& fileName)
+	{
+		Texture* atlasTex = FindAtlasTexture(fileName);
+		if (atlasTex)
+		{
+			return atlasTex;
+		}
+
+		auto iter = m_Textures.find(fileName);
+		if (iter != m_Textures.end())
+		{
+			return iter->second;
+		}
+
+		// Draw with the default texture in the meantime
+		Texture* tex = new Texture();
+		tex->SetPlaceholder(GetTexture("src/Assets/3DGraphics/Default.png"));
+		m_Textures.emplace(fileName, tex);
+
+		PendingLoad* load = new PendingLoad();
+		load->m_FileName = fileName;
+		load->m_Texture = tex;
+		load->m_Mesh = nullptr;
+		load->m_TextureFile = new TextureFile();
+		load->m_MeshFile = nullptr;
+		load->m_Succeeded = false;
+		m_PendingLoads.emplace_back(load);
+
+		// Decode on a worker, the job only touches load
+		m_Game->GetJobSystem()->RunBackground([load]()
+			{
+				load->m_Succeeded = load->m_TextureFile->Load(load->m_FileName);
+			}, &load->m_Counter);
+		return tex;
+	}
+
+	Mesh* Renderer::GetMeshAsync(const std::string& fileName)
+	{
+		auto iter = m_Meshes.find(fileName);
+		if (iter != m_Meshes.end())
+		{
+			return iter->second;
+		}
+
+		// Mesh isn't drawn until it's loaded
+		Mesh* m = new Mesh();
+		m->SetSortID(m_NextMeshID++);
+		m_Meshes.emplace(fileName, m);
+
+		PendingLoad* load = new PendingLoad();
+		load->m_FileName = fileName;
+		load->m_Texture = nullptr;
+		load->m_Mesh = m;
+		load->m_TextureFile = nullptr;
+		load->m_MeshFile = new MeshFile();
+		load->m_Succeeded = false;
+		m_PendingLoads.emplace_back(load);
+
+		// Read/parse on a worker
+		m_Game->GetJobSystem()->RunBackground([load]()
+			{
+				load->m_Succeeded = load->m_MeshFile->Load(load->m_FileName);
+			}, &load->m_Counter);
+		return m;
+	}
+
+	void Renderer::ProcessUploads()
+	{
+		// Upload in request order, skipping loads still in flight
+		int uploads = 0;
+		auto iter = m_PendingLoads.begin();
+		while (iter != m_PendingLoads.end() && uploads < m_MaxUploadsPerFrame)
+		{
+			PendingLoad* load = *iter;
+			if (load->m_Counter.IsDone())
+			{
+				iter = m_PendingLoads.erase(iter);
+				CompleteLoad(load);
+				uploads++;
+			}
+			else
+			{
+				++iter;
+			}
+		}
+	}
+
+	void Renderer::FinishLoad(Texture* texture, Mesh* mesh)
+	{
+		for (auto iter = m_PendingLoads.begin(); iter != m_PendingLoads.end(); ++iter)
+		{
+			PendingLoad* load = *iter;
+			if ((texture && load->m_Texture == texture) || (mesh && load->m_Mesh == mesh))
+			{
+				m_PendingLoads.erase(iter);
+				m_Game->GetJobSystem()->Wait(load->m_Counter);
+				CompleteLoad(load);
+				return;
+			}
+		}
+	}
+
+	void Renderer::CompleteLoad(PendingLoad* load)
+	{
+		if (load->m_Texture)
+		{
+			if (load->m_Succeeded)
+			{
+				load->m_Texture->Upload(*load->m_TextureFile);
+			}
+			delete load->m_TextureFile;
+			// A failed texture keeps drawing as the placeholder
+		}
+		else if (load->m_Mesh)
+		{
+			if (load->m_Succeeded)
+			{
+				load->m_Mesh->Create(*load->m_MeshFile, this, true);
+			}
+			else
+			{
+				SDL_Log("Background load of mesh %s failed", load->m_FileName.c_str());
+			}
+			delete load->m_MeshFile;
+		}
+		delete load;
+	}
 
-		m_SpriteVerts = new VertexArray(vertices, 4, indices, 6);
+	void Renderer::InterpolateView(float alpha)
+	{
+		// Per-element blend, the view barely changes in one step
+		// so this stays close enough to a rigid transform
+		for (int i = 0; i < 4; i++)
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				m_RenderView.mat[i][j] = CustomMath::Lerp(m_PrevView.mat[i][j], m_View.mat[i][j], alpha);
+			}
+		}
 	}
 
-	void Renderer::SetLightUniforms(Shader* shader)
+	void Renderer::UpdateFrameData()
 	{
+		FrameData data;
+		data.m_ViewProj = m_RenderView * m_Projection;
+		data.m_SpriteViewProj = m_SpriteViewProj;
+
 		// Camera position is from inverted view
-		Matrix4 invView = m_View;
+		Matrix4 invView = m_RenderView;
 		invView.Invert();
 		// GetTranslation returns the first 3 components of the fourth row
 		// These correspond to the world space position of the camera
-		shader->SetVectorUniform("uCameraPos", invView.GetTranslation());
-		shader->SetVectorUniform("uAmbientLight", m_AmbientLight);
+		auto copy = [](float* dest, const Vector3& v)
+		{
+			dest[0] = v.x;
+			dest[1] = v.y;
+			dest[2] = v.z;
+			dest[3] = 0.0f;
+		};
+		copy(data.m_CameraPos, invView.GetTranslation());
+		copy(data.m_AmbientLight, m_AmbientLight);
 		// Directional light
-		shader->SetVectorUniform("uDirLight.m_Direction",
-			m_DirLight.m_Direction);
-		shader->SetVectorUniform("uDirLight.m_DiffuseColor",
-			m_DirLight.m_DiffuseColor);
-		shader->SetVectorUniform("uDirLight.m_SpecColor",
-			m_DirLight.m_SpecColor);
+		copy(data.m_LightDirection, m_DirLight.m_Direction);
+		copy(data.m_LightDiffuseColor, m_DirLight.m_DiffuseColor);
+		copy(data.m_LightSpecColor, m_DirLight.m_SpecColor);
+
+		// Matrix4 rows go in as they are, the block is row_major
+		glBindBuffer(GL_UNIFORM_BUFFER, m_FrameDataBuffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &data);
 	}
 }
\ No newline at end of file
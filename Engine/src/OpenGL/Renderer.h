@@ -4,6 +4,9 @@
 #include <unordered_map>
 #include <SDL.h>
 #include "CustomMath.h"
+#include "JobSystem.h"
+#include "Frustum.h"
+#include "SlotMap.h"
 
 struct DirectionalLight
 {
@@ -29,16 +32,50 @@ namespace Engine
 
 		void Draw();
 
-		void AddSprite(class SpriteComponent* sprite);
-		void RemoveSprite(class SpriteComponent* sprite);
+		// Register/unregister components to draw, removing is O(1) through the handle
+		SlotHandle AddSprite(class SpriteComponent* sprite);
+		void RemoveSprite(SlotHandle handle);
 
-		void AddMeshComp(class MeshComponent* mesh);
-		void RemoveMeshComp(class MeshComponent* mesh);
+		SlotHandle AddMeshComp(class MeshComponent* mesh);
+		void RemoveMeshComp(SlotHandle handle);
 
 		class Texture* GetTexture(const std::string& fileName);
+		// Pack these images into atlas pages, GetTexture then hands out regions of the pages
+		// (for sprites/UI only, meshes expect their UVs to cover the whole texture)
+		bool LoadAtlas(const std::vector<std::string>& fileNames, int pageSize = 2048);
 		class Mesh* GetMesh(const std::string& fileName);
+		// Load in the background, returns right away
+		// The texture/mesh works as a placeholder (default texture, mesh not drawn)
+		// until IsLoaded, asking for it with GetTexture/GetMesh finishes the load on the spot
+		class Texture* GetTextureAsync(const std::string& fileName);
+		class Mesh* GetMeshAsync(const std::string& fileName);
+		// Draw meshes in batches, one instanced draw call per mesh/texture pair
+		// (off draws every MeshComponent on its own)
+		void SetInstancing(bool value) { m_Instancing = value; }
+		// Draw calls issued for meshes/sprites and UI last frame
+		int GetMeshDrawCalls() const { return m_MeshDrawCalls; }
+		int GetSpriteDrawCalls() const { return m_SpriteDrawCalls; }
+		// Skip meshes outside the view frustum
+		void SetCulling(bool value) { m_Culling = value; }
+		// Meshes tested against the frustum/rejected by it last frame
+		size_t GetMeshesTested() const { return m_MeshesTested; }
+		size_t GetMeshesCulled() const { return m_MeshesCulled; }
+		// Draw coarser mesh LODs as meshes get smaller on screen (off always draws LOD 0)
+		void SetLods(bool value) { m_Lods = value; }
+		// Mesh triangles drawn last frame
+		size_t GetMeshTriangles() const { return m_MeshTriangles; }
+		// GL state changes made/skipped as redundant last frame
+		int GetStateChangesIssued() const;
+		int GetStateChangesSkipped() const;
+		// Most finished background loads uploaded to the GPU in one frame
+		void SetMaxUploadsPerFrame(int count) { m_MaxUploadsPerFrame = count; }
+		size_t GetPendingLoadCount() const { return m_PendingLoads.size(); }
 
 		void SetViewMatrix(const Matrix4& view) { m_View = view; }
+		// Remember the view before a simulation step changes it
+		void SavePreviousView() { m_PrevView = m_View; }
+		// Blend the previous and current view by alpha for drawing
+		void InterpolateView(float alpha);
 
 		void SetAmbientLight(const Vector3& ambient) { m_AmbientLight = ambient; }
 		DirectionalLight& GetDirectionalLight() { return m_DirLight; }
@@ -56,30 +93,132 @@ namespace Engine
 		float GetScreenHeight() const { return m_ScreenHeight; }
 	private:
 		bool LoadShaders();
-		void CreateSpriteVerts();
-		void SetLightUniforms(class Shader* shader);
+		class Texture* FindAtlasTexture(const std::string& fileName) const;
+		// Fill the per-frame uniform buffer every shader reads from
+		void UpdateFrameData();
+		// Fill m_VisibleMeshes with the loaded, visible meshes that are inside the frustum
+		void CullMeshes();
+		// Add a command for each visible mesh at the LOD its screen size calls for
+		// (split over the job system)
+		void QueueMeshes();
+		// Run the sorted render queue, one GL state setup per pass
+		void SubmitCommands();
+		// Draw the mesh commands in [begin, end), state only changes when the mesh/texture does
+		void DrawMeshes(size_t begin, size_t end);
+		// Same, but each run of commands with the same mesh/texture is one instanced draw call
+		void DrawMeshesInstanced(size_t begin, size_t end);
+		// Stream the quad commands in [begin, end) through the sprite batch
+		void DrawQuads(size_t begin, size_t end);
+
+		// A background load, from the file work on a worker to the upload here
+		struct PendingLoad
+		{
+			std::string m_FileName;
+			// One of these is set
+			class Texture* m_Texture;
+			class Mesh* m_Mesh;
+			// Filled in by the job
+			class TextureFile* m_TextureFile;
+			class MeshFile* m_MeshFile;
+			bool m_Succeeded;
+			// Done once the job finished
+			JobCounter m_Counter;
+		};
+		// Upload loads whose jobs are done, up to m_MaxUploadsPerFrame
+		void ProcessUploads();
+		// Wait for load's job and upload it now
+		void FinishLoad(class Texture* texture, class Mesh* mesh);
+		// GL side of a finished load (deletes load)
+		void CompleteLoad(PendingLoad* load);
 		
 		// Map of textures loaded
 		std::unordered_map<std::string, class Texture*> m_Textures;
 		// Loaded meshes
 		std::unordered_map<std::string, class Mesh*> m_Meshes;
-		// Sprite components drawn
-		std::vector<class SpriteComponent*> m_Sprites;
+		// Sprite components drawn (in no order, the render queue sorts them by draw order)
+		SlotMap<class SpriteComponent*> m_Sprites;
 		// Mesh components drawn
-		std::vector<class MeshComponent*> m_MeshComps;
+		SlotMap<class MeshComponent*> m_MeshComps;
+		// Background loads in the order they were asked for
+		std::vector<PendingLoad*> m_PendingLoads;
+		int m_MaxUploadsPerFrame;
 
 		class Game* m_Game;
 
 		// Sprite shader
 		class Shader* m_SpriteShader;
-		// Sprite vertex array
-		class VertexArray* m_SpriteVerts;
+		// Batches every sprite/UI quad into a few draw calls
+		class SpriteBatch* m_SpriteBatch;
+		int m_SpriteDrawCalls;
+		std::vector<class TextureAtlas*> m_Atlases;
 
 		// Mesh shader
 		class Shader* m_MeshShader;
+		// Mesh shader taking the world transform per instance
+		class Shader* m_InstancedMeshShader;
+
+		// Frustum culling
+		// Bounding spheres go first (cheap, all meshes), the survivors' world boxes second
+		Frustum m_Frustum;
+		SphereBoundsList m_CullSpheres;
+		BoxBoundsList m_CullBoxes;
+		std::vector<class MeshComponent*> m_CullCandidates;
+		std::vector<unsigned char> m_CullResults;
+		// Meshes to draw this frame
+		std::vector<class MeshComponent*> m_VisibleMeshes;
+		bool m_Culling;
+		size_t m_MeshesTested;
+		size_t m_MeshesCulled;
+		bool m_Lods;
+		size_t m_MeshTriangles;
+
+		// Commands for everything drawn this frame
+		class RenderQueue* m_RenderQueue;
+		// Shadows the bound GL state so redundant changes are skipped
+		class GLStateCache* m_GLState;
+		// Next Mesh sort id handed out
+		unsigned int m_NextMeshID;
+
+		// Instanced mesh drawing
+		struct MeshBatch
+		{
+			class Mesh* m_Mesh;
+			unsigned int m_Lod;
+			class Texture* m_Texture;
+			// Range in m_InstanceTransforms
+			size_t m_First;
+			size_t m_Count;
+		};
+		std::vector<MeshBatch> m_MeshBatches;
+		std::vector<Matrix4> m_InstanceTransforms;
+		// GL buffer the instance transforms are streamed into each frame
+		unsigned int m_InstanceBuffer;
+		size_t m_InstanceBufferSize;
+		bool m_Instancing;
+		int m_MeshDrawCalls;
+
+		// Per-frame uniforms, laid out like the std140 FrameData block in the shaders
+		// (vec3s take 16 bytes)
+		struct FrameData
+		{
+			Matrix4 m_ViewProj;
+			Matrix4 m_SpriteViewProj;
+			float m_CameraPos[4];
+			float m_AmbientLight[4];
+			float m_LightDirection[4];
+			float m_LightDiffuseColor[4];
+			float m_LightSpecColor[4];
+		};
+		// Uniform buffer holding FrameData, bound to FrameDataBinding
+		unsigned int m_FrameDataBuffer;
+		// Sprite/UI view-projection (screen space)
+		Matrix4 m_SpriteViewProj;
 
 		// View/projection for 3D shaders
 		Matrix4 m_View;
+		// View before the last simulation step, and the blend of the two that gets drawn
+		Matrix4 m_PrevView;
+		Matrix4 m_RenderView;
 		Matrix4 m_Projection;
 		// Width/height of screen
 		float m_ScreenWidth;
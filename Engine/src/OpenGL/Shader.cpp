@@ -1,8 +1,10 @@
 
 #include "Shader.h"
+#include "GLStateCache.h"
 #include <SDL.h>
 #include <fstream>
 #include <sstream>
+#include <cstring>
 
 namespace Engine
 {
@@ -41,6 +43,7 @@ namespace Engine
 			return false;
 		}
 
+		CacheUniformLocations();
 		return true;
 	}
 
@@ -51,16 +54,16 @@ namespace Engine
 		glDeleteShader(m_FragShader);
 	}
 
-	void Shader::SetActive()
+	void Shader::SetActive(GLStateCache* state)
 	{
-		glUseProgram(m_ShaderProgram);
+		state->UseProgram(m_ShaderProgram);
 	}
 
 	void Shader::SetMatrixUniform(const char* name, const Matrix4& matrix)
 	{
 		// Find the uniform by name
 		// `name` is the name of the variable in the shader
-		GLuint loc = glGetUniformLocation(m_ShaderProgram, name);
+		GLint loc = GetUniformLocation(name);
 		glUniformMatrix4fv(
 			loc,						// Uniform ID
 			1,							// Number of matrices
@@ -71,16 +74,79 @@ namespace Engine
 
 	void Shader::SetVectorUniform(const char* name, const Vector3& vector)
 	{
-		GLuint loc = glGetUniformLocation(m_ShaderProgram, name);
+		GLint loc = GetUniformLocation(name);
 		glUniform3fv(loc, 1, vector.GetAsFloatPtr());
 	}
 
 	void Shader::SetFloatUniform(const char* name, float value)
 	{
-		GLuint loc = glGetUniformLocation(m_ShaderProgram, name);
+		GLint loc = GetUniformLocation(name);
 		glUniform1f(loc, value);
 	}
 
+	GLint Shader::GetUniformLocation(const char* name) const
+	{
+		auto iter = m_UniformLocations.find(HashName(name));
+		return iter != m_UniformLocations.end() ? iter->second : -1;
+	}
+
+	void Shader::BindUniformBlock(const char* name, GLuint bindingPoint)
+	{
+		GLuint index = glGetUniformBlockIndex(m_ShaderProgram, name);
+		if (index != GL_INVALID_INDEX)
+		{
+			glUniformBlockBinding(m_ShaderProgram, index, bindingPoint);
+		}
+	}
+
+	void Shader::CacheUniformLocations()
+	{
+		m_UniformLocations.clear();
+
+		GLint count = 0;
+		glGetProgramiv(m_ShaderProgram, GL_ACTIVE_UNIFORMS, &count);
+		char name[256];
+		for (GLint i = 0; i < count; i++)
+		{
+			GLsizei length = 0;
+			GLint size = 0;
+			GLenum type = 0;
+			glGetActiveUniform(m_ShaderProgram, i, sizeof(name), &length, &size, &type, name);
+
+			// Uniforms inside a block don't have a location (they're set through the buffer)
+			GLint loc = glGetUniformLocation(m_ShaderProgram, name);
+			if (loc < 0)
+			{
+				continue;
+			}
+
+			// Arrays are reported as "name[0]", also allow just "name"
+			if (length > 3 && strcmp(name + length - 3, "[0]") == 0)
+			{
+				name[length - 3] = '\0';
+			}
+
+			uint32_t hash = HashName(name);
+			auto iter = m_UniformLocations.find(hash);
+			if (iter != m_UniformLocations.end() && iter->second != loc)
+			{
+				SDL_Log("Uniform name hash collision on %s", name);
+			}
+			m_UniformLocations[hash] = loc;
+		}
+	}
+
+	uint32_t Shader::HashName(const char* name)
+	{
+		uint32_t hash = 2166136261u;
+		for (; *name; name++)
+		{
+			hash ^= static_cast<uint8_t>(*name);
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
 	bool Shader::CompileShader(const std::string& fileName, GLenum shaderType, GLuint& outShader)
 	{
 		// Open file
@@ -2,6 +2,8 @@
 
 #include <GL\glew.h>
 #include <string>
+#include <unordered_map>
+#include <cstdint>
 #include "CustomMath.h"
 
 namespace Engine
@@ -16,14 +18,23 @@ namespace Engine
 		bool Load(const std::string& vertName, const std::string& fragName);
 		void Unload();
 		// Set this as the active shader program
-		void SetActive();
+		void SetActive(class GLStateCache* state);
 		// Sets a Matrix uniform
 		void SetMatrixUniform(const char* name, const Matrix4& matrix);
 		// Sets a Vector3 uniform
 		void SetVectorUniform(const char* name, const Vector3& vector);
 		// Sets a float uniform
 		void SetFloatUniform(const char* name, float value);
+		// Location of an active uniform (-1 if the program doesn't use it)
+		GLint GetUniformLocation(const char* name) const;
+		// Connect the uniform block called name to a uniform buffer binding point
+		void BindUniformBlock(const char* name, GLuint bindingPoint);
 	private:
+		// Fill the location cache with every active uniform (after linking)
+		void CacheUniformLocations();
+		// FNV-1a hash of a uniform name, so lookups don't build a std::string
+		static uint32_t HashName(const char* name);
+
 		//Tries to compile the specified shader
 		bool CompileShader(const std::string& fileName,
 						   GLenum shaderType,
@@ -38,5 +49,7 @@ namespace Engine
 		GLuint m_VertexShader;
 		GLuint m_FragShader;
 		GLuint m_ShaderProgram;
+		// Uniform name hash -> location
+		std::unordered_map<uint32_t, GLint> m_UniformLocations;
 	};
 }
\ No newline at end of file
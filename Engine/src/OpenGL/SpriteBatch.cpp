@@ -0,0 +1,205 @@
+#include "SpriteBatch.h"
+#include "Texture.h"
+#include "Shader.h"
+#include "GLStateCache.h"
+#include <algorithm>
+#include <cstddef>
+#include <GL\glew.h>
+
+namespace Engine
+{
+	SpriteBatch::SpriteBatch() :
+		m_SortMode(ESortDrawOrder),
+		m_State(nullptr),
+		m_VertexArray(0),
+		m_VertexBuffer(0),
+		m_IndexBuffer(0),
+		m_Capacity(0),
+		m_DrawCalls(0)
+	{
+	}
+
+	SpriteBatch::~SpriteBatch()
+	{
+	}
+
+	bool SpriteBatch::Initialize(GLStateCache* state)
+	{
+		m_State = state;
+		glGenVertexArrays(1, &m_VertexArray);
+		m_State->BindVertexArray(m_VertexArray);
+		glGenBuffers(1, &m_VertexBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, m_VertexBuffer);
+		glGenBuffers(1, &m_IndexBuffer);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexBuffer);
+
+		// Position is 3 floats
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+			reinterpret_cast<void*>(offsetof(Vertex, m_Position)));
+		// Texture coordinates is 2 floats
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+			reinterpret_cast<void*>(offsetof(Vertex, m_TexCoord)));
+
+		Reserve(256);
+		return true;
+	}
+
+	void SpriteBatch::Shutdown()
+	{
+		glDeleteBuffers(1, &m_VertexBuffer);
+		glDeleteBuffers(1, &m_IndexBuffer);
+		glDeleteVertexArrays(1, &m_VertexArray);
+		m_Capacity = 0;
+	}
+
+	void SpriteBatch::Begin(SortMode mode)
+	{
+		m_SortMode = mode;
+		m_Quads.clear();
+	}
+
+	void SpriteBatch::Draw(Texture* texture, const Matrix4& world, int drawOrder)
+	{
+		if (!texture)
+		{
+			return;
+		}
+
+		// Same unit quad as the renderer's sprite verts, corners clockwise from top left
+		static const float corners[4][2] = {
+			{ -0.5f,  0.5f },
+			{  0.5f,  0.5f },
+			{  0.5f, -0.5f },
+			{ -0.5f, -0.5f }
+		};
+		static const float cornerUVs[4][2] = {
+			{ 0.0f, 0.0f },
+			{ 1.0f, 0.0f },
+			{ 1.0f, 1.0f },
+			{ 0.0f, 1.0f }
+		};
+
+		m_Quads.emplace_back();
+		Quad& quad = m_Quads.back();
+		quad.m_DrawOrder = drawOrder;
+		quad.m_TextureID = texture->GetTextureID();
+		quad.m_Texture = texture;
+
+		const Vector2& uvMin = texture->GetUVMin();
+		const Vector2& uvMax = texture->GetUVMax();
+		for (int i = 0; i < 4; i++)
+		{
+			Vector3 pos = Vector3::Transform(Vector3(corners[i][0], corners[i][1], 0.0f), world);
+			Vertex& v = quad.m_Verts[i];
+			v.m_Position[0] = pos.x;
+			v.m_Position[1] = pos.y;
+			v.m_Position[2] = pos.z;
+			v.m_TexCoord[0] = CustomMath::Lerp(uvMin.x, uvMax.x, cornerUVs[i][0]);
+			v.m_TexCoord[1] = CustomMath::Lerp(uvMin.y, uvMax.y, cornerUVs[i][1]);
+		}
+	}
+
+	void SpriteBatch::End(Shader* shader)
+	{
+		m_DrawCalls = 0;
+		if (m_Quads.empty())
+		{
+			return;
+		}
+
+		m_Order.resize(m_Quads.size());
+		for (size_t i = 0; i < m_Order.size(); i++)
+		{
+			m_Order[i] = static_cast<unsigned int>(i);
+		}
+		if (m_SortMode == ESortDrawOrder)
+		{
+			// Stable, so quads with the same draw order and texture keep their order
+			std::stable_sort(m_Order.begin(), m_Order.end(),
+				[this](unsigned int a, unsigned int b)
+				{
+					const Quad& qa = m_Quads[a];
+					const Quad& qb = m_Quads[b];
+					if (qa.m_DrawOrder != qb.m_DrawOrder)
+					{
+						return qa.m_DrawOrder < qb.m_DrawOrder;
+					}
+					return qa.m_TextureID < qb.m_TextureID;
+				});
+		}
+
+		// One upload for the whole batch
+		m_Vertices.clear();
+		for (unsigned int index : m_Order)
+		{
+			const Quad& quad = m_Quads[index];
+			m_Vertices.insert(m_Vertices.end(), quad.m_Verts, quad.m_Verts + 4);
+		}
+		Reserve(m_Quads.size());
+		m_State->BindVertexArray(m_VertexArray);
+		glBindBuffer(GL_ARRAY_BUFFER, m_VertexBuffer);
+		// Orphan last frame's data so we don't wait on the GPU
+		glBufferData(GL_ARRAY_BUFFER, m_Capacity * 4 * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, m_Vertices.size() * sizeof(Vertex), m_Vertices.data());
+
+		shader->SetActive(m_State);
+
+		// A draw call per run of quads sharing a GL texture
+		size_t runStart = 0;
+		while (runStart < m_Order.size())
+		{
+			const Quad& first = m_Quads[m_Order[runStart]];
+			size_t runEnd = runStart + 1;
+			while (runEnd < m_Order.size() && m_Quads[m_Order[runEnd]].m_TextureID == first.m_TextureID)
+			{
+				runEnd++;
+			}
+
+			first.m_Texture->SetActive(m_State);
+			glDrawElements(
+				GL_TRIANGLES,
+				static_cast<GLsizei>((runEnd - runStart) * 6),
+				GL_UNSIGNED_INT,
+				reinterpret_cast<void*>(runStart * 6 * sizeof(unsigned int))
+			);
+			m_DrawCalls++;
+			runStart = runEnd;
+		}
+	}
+
+	void SpriteBatch::Reserve(size_t quadCount)
+	{
+		if (quadCount <= m_Capacity)
+		{
+			return;
+		}
+
+		// Double, so a growing batch only reallocates a few times
+		size_t capacity = m_Capacity > 0 ? m_Capacity : 256;
+		while (capacity < quadCount)
+		{
+			capacity *= 2;
+		}
+
+		// Indices never change, two triangles per quad
+		std::vector<unsigned int> indices(capacity * 6);
+		for (size_t i = 0; i < capacity; i++)
+		{
+			unsigned int base = static_cast<unsigned int>(i * 4);
+			indices[i * 6 + 0] = base + 0;
+			indices[i * 6 + 1] = base + 1;
+			indices[i * 6 + 2] = base + 2;
+			indices[i * 6 + 3] = base + 2;
+			indices[i * 6 + 4] = base + 3;
+			indices[i * 6 + 5] = base + 0;
+		}
+		m_State->BindVertexArray(m_VertexArray);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexBuffer);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
+			indices.data(), GL_STATIC_DRAW);
+
+		m_Capacity = capacity;
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <vector>
+#include "CustomMath.h"
+
+namespace Engine
+{
+	// Collects textured quads for a frame and draws them in as few draw calls as possible
+	// Quads are transformed on the CPU and streamed into one vertex buffer,
+	// then consecutive quads sharing a GL texture (or atlas page) go out in one glDrawElements
+	class SpriteBatch
+	{
+	public:
+		enum SortMode
+		{
+			// Sort by draw order, then texture (sprites)
+			ESortDrawOrder,
+			// Keep the order quads were added in (UI, where later draws go on top)
+			ESubmitOrder
+		};
+
+		SpriteBatch();
+		~SpriteBatch();
+
+		// GL binds go through state (owned by the renderer)
+		bool Initialize(class GLStateCache* state);
+		void Shutdown();
+
+		// Start collecting quads
+		void Begin(SortMode mode);
+		// Add the unit quad ([-0.5, 0.5] on x/y) transformed by world, textured with texture
+		// (uses the texture's atlas region if it has one)
+		void Draw(class Texture* texture, const Matrix4& world, int drawOrder = 0);
+		// Sort and draw everything since Begin with shader (expects the FrameData uniform buffer to be filled)
+		void End(class Shader* shader);
+
+		// Draw calls issued by the last End
+		int GetDrawCalls() const { return m_DrawCalls; }
+	private:
+		struct Vertex
+		{
+			float m_Position[3];
+			float m_TexCoord[2];
+		};
+
+		struct Quad
+		{
+			int m_DrawOrder;
+			// GL texture the quad samples from (shared by every region of an atlas page)
+			unsigned int m_TextureID;
+			class Texture* m_Texture;
+			Vertex m_Verts[4];
+		};
+
+		// Grow the GL buffers to hold at least quadCount quads
+		void Reserve(size_t quadCount);
+
+		std::vector<Quad> m_Quads;
+		// Sorted order of m_Quads
+		std::vector<unsigned int> m_Order;
+		std::vector<Vertex> m_Vertices;
+		SortMode m_SortMode;
+
+		class GLStateCache* m_State;
+		unsigned int m_VertexArray;
+		unsigned int m_VertexBuffer;
+		unsigned int m_IndexBuffer;
+		// Quads the GL buffers have room for
+		size_t m_Capacity;
+		int m_DrawCalls;
+	};
+}
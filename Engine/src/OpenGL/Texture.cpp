@@ -1,5 +1,6 @@
 
 #include "Texture.h"
+#include "GLStateCache.h"
 // Simple OpenGL Image Library
 #include "SOIL\SOIL.h"
 
@@ -10,7 +11,13 @@ namespace Engine
 	Texture::Texture() :
 		m_TextureID(0),
 		m_Width(0),
-		m_Height(0)
+		m_Height(0),
+		m_IsLoaded(false),
+		m_Page(nullptr),
+		m_UVMin(0.0f, 0.0f),
+		m_UVMax(1.0f, 1.0f),
+		m_LevelCount(0),
+		m_Compressed(false)
 	{
 	}
 
@@ -20,21 +27,55 @@ namespace Engine
 
 	bool Texture::Load(const std::string& fileName)
 	{
-		int channels = 0;
+		TextureFile file;
+		if (!file.Load(fileName))
+		{
+			return false;
+		}
+
+		// Once you have copied the image data to OpenGL, file frees it
+		return Upload(file);
+	}
+
+	void Texture::Unload()
+	{
+		// Placeholders and atlas regions don't own their texture
+		if (m_IsLoaded && !m_Page)
+		{
+			glDeleteTextures(1, &m_TextureID);
+		}
+		m_TextureID = 0;
+		m_IsLoaded = false;
+		m_Page = nullptr;
+	}
+
+	unsigned char* Texture::DecodeImage(const std::string& fileName, int& outWidth,
+		int& outHeight, int& outChannels)
+	{
 		unsigned char* image = SOIL_load_image(
 			fileName.c_str(),		// Name of file
-			&m_Width,				// Stores width
-			&m_Height,				// Stores height
-			&channels,				// Stores number of channels
+			&outWidth,				// Stores width
+			&outHeight,				// Stores height
+			&outChannels,			// Stores number of channels
 			SOIL_LOAD_AUTO			// Type of image file, or auto for any
 		);
 
 		if (image == nullptr)
 		{
 			SDL_Log("SOIL failed to load image %s: %s", fileName.c_str(), SOIL_last_result());
-			SOIL_free_image_data(image);
-			return false;
 		}
+		return image;
+	}
+
+	void Texture::FreeImage(unsigned char* pixels)
+	{
+		SOIL_free_image_data(pixels);
+	}
+
+	void Texture::Upload(const unsigned char* pixels, int width, int height, int channels)
+	{
+		m_Width = width;
+		m_Height = height;
 
 		int format = GL_RGB;
 		if (channels == 4)
@@ -51,28 +92,162 @@ namespace Engine
 			GL_TEXTURE_2D,		// Texture target
 			0,					// Level of detail (for now, assume 0)
 			format,				// Color format OpenGL should use
-			m_Width,			
+			m_Width,
 			m_Height,
 			0,					// Border "this value must be 0"
 			format,				// Color format of input data
 			GL_UNSIGNED_BYTE,	// Bit depth of input data
 								// Unsigned byte specifies 8-bit channels
-			image				// Pointer to image data
+			pixels				// Pointer to image data
 		);
 
-		// Once you have copied the image data to OpenGL, free the image from memory
-		SOIL_free_image_data(image);
+		m_LevelCount = 1;
+		m_Compressed = false;
+		m_IsLoaded = true;
+		ApplySampler();
+	}
 
-		// Enable bilinear filtering
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	bool Texture::Upload(const TextureFile& file)
+	{
+		const std::vector<TextureFile::Level>& levels = file.GetLevels();
+		if (levels.empty())
+		{
+			return false;
+		}
+
+		GLenum internalFormat = GL_RGBA;
+		GLenum format = GL_RGBA;
+		bool supported = true;
+		switch (file.GetFormat())
+		{
+		case TextureFile::ERGB8:
+			internalFormat = GL_RGB;
+			format = GL_RGB;
+			break;
+		case TextureFile::ERGBA8:
+			break;
+		case TextureFile::EBC1:
+			internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+			supported = GLEW_EXT_texture_compression_s3tc != 0;
+			break;
+		case TextureFile::EBC2:
+			internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+			supported = GLEW_EXT_texture_compression_s3tc != 0;
+			break;
+		case TextureFile::EBC3:
+			internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			supported = GLEW_EXT_texture_compression_s3tc != 0;
+			break;
+		case TextureFile::EBC4:
+			// RGTC is core since GL 3.0
+			internalFormat = GL_COMPRESSED_RED_RGTC1;
+			break;
+		case TextureFile::EBC5:
+			internalFormat = GL_COMPRESSED_RG_RGTC2;
+			break;
+		case TextureFile::EBC7:
+			internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM;
+			supported = GLEW_ARB_texture_compression_bptc != 0;
+			break;
+		}
+		if (!supported)
+		{
+			SDL_Log("This GPU can't sample the compressed format of a %dx%d texture",
+				file.GetWidth(), file.GetHeight());
+			return false;
+		}
+
+		m_Width = file.GetWidth();
+		m_Height = file.GetHeight();
+		m_Compressed = file.IsCompressed();
+		m_LevelCount = static_cast<int>(levels.size());
 
+		glGenTextures(1, &m_TextureID);
+		glBindTexture(GL_TEXTURE_2D, m_TextureID);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, file.GetRowAlignment());
+		for (int i = 0; i < m_LevelCount; i++)
+		{
+			const TextureFile::Level& level = levels[i];
+			if (m_Compressed)
+			{
+				glCompressedTexImage2D(GL_TEXTURE_2D, i, internalFormat, level.m_Width, level.m_Height,
+					0, static_cast<GLsizei>(level.m_Size), level.m_Data);
+			}
+			else
+			{
+				glTexImage2D(GL_TEXTURE_2D, i, internalFormat, level.m_Width, level.m_Height,
+					0, format, GL_UNSIGNED_BYTE, level.m_Data);
+			}
+		}
+		// Back to the GL default
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		// Only sample the levels we have (a file's chain can stop before 1x1)
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_LevelCount - 1);
+
+		m_IsLoaded = true;
+		ApplySampler();
 		return true;
 	}
 
-	void Texture::Unload()
+	void Texture::SetSampler(const SamplerSettings& sampler)
 	{
-		glDeleteTextures(1, &m_TextureID);
+		m_Sampler = sampler;
+		if (m_IsLoaded && !m_Page)
+		{
+			glBindTexture(GL_TEXTURE_2D, m_TextureID);
+			ApplySampler();
+		}
+	}
+
+	void Texture::ApplySampler()
+	{
+		// Build the mip chain if we want one and the file didn't come with it
+		if (m_Sampler.m_Mipmaps && m_LevelCount == 1 && !m_Compressed)
+		{
+			glGenerateMipmap(GL_TEXTURE_2D);
+			int size = m_Width > m_Height ? m_Width : m_Height;
+			while (size > 1)
+			{
+				size /= 2;
+				m_LevelCount++;
+			}
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_LevelCount - 1);
+		}
+
+		// Trilinear when there are mips to blend between, bilinear otherwise
+		bool mipmapped = m_Sampler.m_Mipmaps && m_LevelCount > 1;
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		GLint wrap = GL_REPEAT;
+		if (m_Sampler.m_Wrap == SamplerSettings::EClamp)
+		{
+			wrap = GL_CLAMP_TO_EDGE;
+		}
+		else if (m_Sampler.m_Wrap == SamplerSettings::EMirror)
+		{
+			wrap = GL_MIRRORED_REPEAT;
+		}
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+
+		if (GLEW_EXT_texture_filter_anisotropic)
+		{
+			float maxAnisotropy = 1.0f;
+			glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
+			glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT,
+				CustomMath::Clamp(m_Sampler.m_Anisotropy, 1.0f, maxAnisotropy));
+		}
+	}
+
+	void Texture::SetPlaceholder(const Texture* placeholder)
+	{
+		if (placeholder && !m_IsLoaded)
+		{
+			m_TextureID = placeholder->m_TextureID;
+			m_Width = placeholder->m_Width;
+			m_Height = placeholder->m_Height;
+		}
 	}
 
 	void Texture::CreateFromSurface(SDL_Surface* surface)
@@ -89,10 +264,25 @@ namespace Engine
 		// Use linear filtering
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		m_IsLoaded = true;
 	}
 
-	void Texture::SetActive()
+	void Texture::SetAtlasRegion(const Texture* page, int x, int y, int width, int height)
 	{
-		glBindTexture(GL_TEXTURE_2D, m_TextureID);
+		m_Page = page;
+		m_TextureID = page->m_TextureID;
+		m_Width = width;
+		m_Height = height;
+		float invWidth = 1.0f / static_cast<float>(page->m_Width);
+		float invHeight = 1.0f / static_cast<float>(page->m_Height);
+		m_UVMin = Vector2(x * invWidth, y * invHeight);
+		m_UVMax = Vector2((x + width) * invWidth, (y + height) * invHeight);
+		m_IsLoaded = true;
+	}
+
+	void Texture::SetActive(GLStateCache* state, unsigned int unit)
+	{
+		state->BindTexture(unit, m_TextureID);
 	}
 }
\ No newline at end of file
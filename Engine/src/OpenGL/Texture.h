@@ -2,6 +2,8 @@
 
 #include <string>
 #include "SDL.h"
+#include "CustomMath.h"
+#include "TextureFile.h"
 
 namespace Engine
 {
@@ -11,18 +13,64 @@ namespace Engine
 		Texture();
 		~Texture();
 
+		// Load an image (png and friends, or .dds/.ktx with their compressed mip chains)
 		bool Load(const std::string& fileName);
 		void Unload();
 		void CreateFromSurface(SDL_Surface* surface);
 
-		void SetActive();
+		// Load split in two, for loading in the background
+		// Decode the image file (no GL calls, so any thread can do it)
+		// Returns pixels to free with FreeImage, or nullptr on failure
+		static unsigned char* DecodeImage(const std::string& fileName, int& outWidth,
+			int& outHeight, int& outChannels);
+		static void FreeImage(unsigned char* pixels);
+		// Create the GL texture from decoded pixels (main thread)
+		void Upload(const unsigned char* pixels, int width, int height, int channels);
+		// Create the GL texture from every level in file (main thread)
+		// Returns false if the driver can't sample the file's format
+		bool Upload(const TextureFile& file);
+
+		// Filtering/wrap settings, applied right away if the texture is loaded, or when it is
+		// (placeholders and atlas regions don't own their GL texture, so they ignore this)
+		void SetSampler(const SamplerSettings& sampler);
+		const SamplerSettings& GetSampler() const { return m_Sampler; }
+
+		// Draw with another texture until this one is uploaded
+		void SetPlaceholder(const Texture* placeholder);
+		bool IsLoaded() const { return m_IsLoaded; }
+
+		// Make this texture a width x height region of an atlas page, at x/y in pixels
+		// SetActive binds the page, and sprite drawing uses the region's UVs
+		void SetAtlasRegion(const Texture* page, int x, int y, int width, int height);
+
+		unsigned int GetTextureID() const { return m_TextureID; }
+		// Part of the GL texture this texture covers (0 to 1 unless it's an atlas region)
+		const Vector2& GetUVMin() const { return m_UVMin; }
+		const Vector2& GetUVMax() const { return m_UVMax; }
+
+		// Bind to a texture unit (through the renderer's state cache)
+		void SetActive(class GLStateCache* state, unsigned int unit = 0);
 		
 		int GetWidth() const { return m_Width; }
 		int GetHeight() const { return m_Height; }
 	private:
+		// Set the GL sampling parameters from m_Sampler (texture has to be bound)
+		void ApplySampler();
+
 		// OpenGL ID of this texture
 		unsigned int m_TextureID;
 		int m_Width;
 		int m_Height;
+		// False while m_TextureID is borrowed from a placeholder
+		bool m_IsLoaded;
+		// Atlas page this is a region of (the page owns m_TextureID)
+		const Texture* m_Page;
+		Vector2 m_UVMin;
+		Vector2 m_UVMax;
+		SamplerSettings m_Sampler;
+		// Mip levels in the GL texture
+		int m_LevelCount;
+		// Block compressed textures can't generate their own mipmaps
+		bool m_Compressed;
 	};
 }
\ No newline at end of file
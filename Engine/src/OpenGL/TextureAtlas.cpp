@@ -0,0 +1,210 @@
+#include "TextureAtlas.h"
+#include "Texture.h"
+#include <algorithm>
+#include <SDL_log.h>
+
+namespace Engine
+{
+	// Pixels around each image copied from its edge,
+	// so bilinear filtering never picks up the neighbor
+	static const int AtlasPadding = 1;
+
+	TextureAtlas::TextureAtlas(int pageSize) :
+		m_PageSize(pageSize)
+	{
+	}
+
+	TextureAtlas::~TextureAtlas()
+	{
+		Unload();
+	}
+
+	bool TextureAtlas::Build(const std::vector<std::string>& fileNames)
+	{
+		struct Image
+		{
+			std::string m_FileName;
+			unsigned char* m_Pixels;
+			int m_Width;
+			int m_Height;
+			int m_Channels;
+		};
+
+		std::vector<Image> images;
+		for (const auto& fileName : fileNames)
+		{
+			if (m_Regions.find(fileName) != m_Regions.end())
+			{
+				continue;
+			}
+			Image image;
+			image.m_FileName = fileName;
+			image.m_Pixels = Texture::DecodeImage(fileName, image.m_Width, image.m_Height, image.m_Channels);
+			if (image.m_Pixels)
+			{
+				images.emplace_back(image);
+			}
+		}
+
+		// Tallest first packs shelves much tighter
+		std::sort(images.begin(), images.end(), [](const Image& a, const Image& b)
+			{
+				return a.m_Height > b.m_Height;
+			});
+
+		// Where each image went
+		struct Placement
+		{
+			size_t m_Image;
+			size_t m_Page;
+			int m_X;
+			int m_Y;
+		};
+
+		const int pageBytes = m_PageSize * m_PageSize * 4;
+		const size_t firstNewPage = m_Pages.size();
+		std::vector<Placement> placements;
+		for (size_t i = 0; i < images.size(); i++)
+		{
+			const Image& image = images[i];
+			int paddedWidth = image.m_Width + AtlasPadding * 2;
+			int paddedHeight = image.m_Height + AtlasPadding * 2;
+			if (paddedWidth > m_PageSize || paddedHeight > m_PageSize)
+			{
+				SDL_Log("%s is too big for a %d atlas page", image.m_FileName.c_str(), m_PageSize);
+				continue;
+			}
+
+			// First page with room, or a new one
+			int x = 0;
+			int y = 0;
+			size_t pageIndex = firstNewPage;
+			while (pageIndex < m_Pages.size() && !Pack(m_Pages[pageIndex], paddedWidth, paddedHeight, x, y))
+			{
+				pageIndex++;
+			}
+			if (pageIndex == m_Pages.size())
+			{
+				m_Pages.emplace_back();
+				Page& page = m_Pages.back();
+				page.m_Pixels.assign(pageBytes, 0);
+				page.m_NextShelfY = 0;
+				page.m_Texture = nullptr;
+				Pack(page, paddedWidth, paddedHeight, x, y);
+			}
+
+			// Copy into the page as RGBA, clamping source coords to extrude the edges into the padding
+			Page& page = m_Pages[pageIndex];
+			for (int py = 0; py < paddedHeight; py++)
+			{
+				int srcY = std::min(std::max(py - AtlasPadding, 0), image.m_Height - 1);
+				unsigned char* dest = &page.m_Pixels[((y + py) * m_PageSize + x) * 4];
+				for (int px = 0; px < paddedWidth; px++)
+				{
+					int srcX = std::min(std::max(px - AtlasPadding, 0), image.m_Width - 1);
+					const unsigned char* src = &image.m_Pixels[(srcY * image.m_Width + srcX) * image.m_Channels];
+					dest[0] = src[0];
+					dest[1] = image.m_Channels > 1 ? src[1] : src[0];
+					dest[2] = image.m_Channels > 2 ? src[2] : src[0];
+					dest[3] = image.m_Channels == 4 ? src[3] : (image.m_Channels == 2 ? src[1] : 255);
+					dest += 4;
+				}
+			}
+
+			// Region is the image itself, inside the padding
+			placements.emplace_back(Placement{ i, pageIndex, x + AtlasPadding, y + AtlasPadding });
+		}
+
+		// Upload the new pages, then point the regions at them
+		// (no mipmaps, smaller levels would blend neighboring images together)
+		SamplerSettings pageSampler;
+		pageSampler.m_Mipmaps = false;
+		pageSampler.m_Wrap = SamplerSettings::EClamp;
+		for (size_t i = firstNewPage; i < m_Pages.size(); i++)
+		{
+			Page& page = m_Pages[i];
+			page.m_Texture = new Texture();
+			page.m_Texture->SetSampler(pageSampler);
+			page.m_Texture->Upload(page.m_Pixels.data(), m_PageSize, m_PageSize, 4);
+		}
+		for (const auto& placement : placements)
+		{
+			const Image& image = images[placement.m_Image];
+			Texture* region = new Texture();
+			region->SetAtlasRegion(m_Pages[placement.m_Page].m_Texture, placement.m_X, placement.m_Y,
+				image.m_Width, image.m_Height);
+			m_Regions[image.m_FileName] = region;
+		}
+		for (const auto& image : images)
+		{
+			Texture::FreeImage(image.m_Pixels);
+		}
+
+		// Pages only need their pixels until they're uploaded
+		for (size_t i = firstNewPage; i < m_Pages.size(); i++)
+		{
+			std::vector<unsigned char>().swap(m_Pages[i].m_Pixels);
+		}
+
+		SDL_Log("Packed %d images into %d atlas pages", static_cast<int>(placements.size()),
+			static_cast<int>(m_Pages.size() - firstNewPage));
+		return placements.size() == fileNames.size();
+	}
+
+	void TextureAtlas::Unload()
+	{
+		for (auto& region : m_Regions)
+		{
+			region.second->Unload();
+			delete region.second;
+		}
+		m_Regions.clear();
+
+		for (auto& page : m_Pages)
+		{
+			if (page.m_Texture)
+			{
+				page.m_Texture->Unload();
+				delete page.m_Texture;
+			}
+		}
+		m_Pages.clear();
+	}
+
+	Texture* TextureAtlas::GetTexture(const std::string& fileName) const
+	{
+		auto iter = m_Regions.find(fileName);
+		return iter != m_Regions.end() ? iter->second : nullptr;
+	}
+
+	bool TextureAtlas::Pack(Page& page, int width, int height, int& outX, int& outY)
+	{
+		// Shelf that wastes the least height and still has room
+		Shelf* best = nullptr;
+		for (auto& shelf : page.m_Shelves)
+		{
+			if (shelf.m_Height >= height && m_PageSize - shelf.m_X >= width &&
+				(!best || shelf.m_Height < best->m_Height))
+			{
+				best = &shelf;
+			}
+		}
+
+		// Otherwise start a new shelf
+		if (!best)
+		{
+			if (m_PageSize - page.m_NextShelfY < height)
+			{
+				return false;
+			}
+			page.m_Shelves.emplace_back(Shelf{ page.m_NextShelfY, height, 0 });
+			page.m_NextShelfY += height;
+			best = &page.m_Shelves.back();
+		}
+
+		outX = best->m_X;
+		outY = best->m_Y;
+		best->m_X += width;
+		return true;
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace Engine
+{
+	// Packs many small images into a few big textures (pages), so sprites and UI
+	// that use different images can still share a texture and be drawn together
+	// Each packed image gets a Texture that is a region of its page
+	class TextureAtlas
+	{
+	public:
+		TextureAtlas(int pageSize = 2048);
+		~TextureAtlas();
+
+		// Decode and pack every file in fileNames (main thread, creates GL textures)
+		// Images that don't fit on a page are left out
+		bool Build(const std::vector<std::string>& fileNames);
+		void Unload();
+
+		// Region for fileName, nullptr if it isn't in the atlas
+		class Texture* GetTexture(const std::string& fileName) const;
+		size_t GetPageCount() const { return m_Pages.size(); }
+	private:
+		// Row of images of about the same height
+		struct Shelf
+		{
+			int m_Y;
+			int m_Height;
+			// Where the next image on the shelf goes
+			int m_X;
+		};
+
+		struct Page
+		{
+			std::vector<unsigned char> m_Pixels;
+			std::vector<Shelf> m_Shelves;
+			// Top of the space no shelf uses yet
+			int m_NextShelfY;
+			class Texture* m_Texture;
+		};
+
+		// Find room for a width x height image on page, returns false if it's full
+		bool Pack(Page& page, int width, int height, int& outX, int& outY);
+
+		int m_PageSize;
+		std::vector<Page> m_Pages;
+		std::unordered_map<std::string, class Texture*> m_Regions;
+	};
+}
@@ -0,0 +1,350 @@
+#include "TextureFile.h"
+#include "Texture.h"
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <SDL_log.h>
+
+namespace Engine
+{
+	static bool HasExtension(const std::string& fileName, const char* ext)
+	{
+		size_t length = strlen(ext);
+		if (fileName.size() < length)
+		{
+			return false;
+		}
+		for (size_t i = 0; i < length; i++)
+		{
+			char c = fileName[fileName.size() - length + i];
+			if (c >= 'A' && c <= 'Z')
+			{
+				c = c - 'A' + 'a';
+			}
+			if (c != ext[i])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static uint32_t ReadU32(const unsigned char* data)
+	{
+		uint32_t value;
+		memcpy(&value, data, sizeof(uint32_t));
+		return value;
+	}
+
+	static uint32_t MakeFourCC(const char* code)
+	{
+		return static_cast<uint32_t>(code[0]) | (static_cast<uint32_t>(code[1]) << 8) |
+			(static_cast<uint32_t>(code[2]) << 16) | (static_cast<uint32_t>(code[3]) << 24);
+	}
+
+	TextureFile::TextureFile() :
+		m_Format(ERGBA8),
+		m_RowAlignment(1),
+		m_Pixels(nullptr)
+	{
+	}
+
+	TextureFile::~TextureFile()
+	{
+		Unload();
+	}
+
+	bool TextureFile::Load(const std::string& fileName)
+	{
+		Unload();
+		if (HasExtension(fileName, ".dds"))
+		{
+			return LoadDDS(fileName);
+		}
+		if (HasExtension(fileName, ".ktx"))
+		{
+			return LoadKTX(fileName);
+		}
+		return LoadWithSOIL(fileName);
+	}
+
+	void TextureFile::Unload()
+	{
+		if (m_Pixels)
+		{
+			Texture::FreeImage(m_Pixels);
+			m_Pixels = nullptr;
+		}
+		std::vector<unsigned char>().swap(m_FileData);
+		m_Levels.clear();
+	}
+
+	bool TextureFile::LoadWithSOIL(const std::string& fileName)
+	{
+		int width = 0;
+		int height = 0;
+		int channels = 0;
+		m_Pixels = Texture::DecodeImage(fileName, width, height, channels);
+		if (!m_Pixels)
+		{
+			return false;
+		}
+
+		m_Format = channels == 4 ? ERGBA8 : ERGB8;
+		// SOIL packs rows tightly
+		m_RowAlignment = 1;
+		m_Levels.emplace_back(Level{ width, height, m_Pixels,
+			static_cast<size_t>(width) * height * (channels == 4 ? 4 : 3) });
+		return true;
+	}
+
+	bool TextureFile::ReadFile(const std::string& fileName)
+	{
+		std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+		if (!file.is_open())
+		{
+			SDL_Log("File not found: Texture %s", fileName.c_str());
+			return false;
+		}
+		std::streamsize size = file.tellg();
+		file.seekg(0, std::ios::beg);
+		m_FileData.resize(static_cast<size_t>(size));
+		return size > 0 && file.read(reinterpret_cast<char*>(m_FileData.data()), size).good();
+	}
+
+	bool TextureFile::LoadDDS(const std::string& fileName)
+	{
+		if (!ReadFile(fileName))
+		{
+			return false;
+		}
+
+		// "DDS " then a 124 byte DDS_HEADER
+		const size_t headerSize = 4 + 124;
+		const unsigned char* data = m_FileData.data();
+		if (m_FileData.size() < headerSize || memcmp(data, "DDS ", 4) != 0 || ReadU32(data + 4) != 124)
+		{
+			SDL_Log("Texture %s is not a DDS file", fileName.c_str());
+			Unload();
+			return false;
+		}
+
+		const uint32_t flags = ReadU32(data + 8);
+		const int height = static_cast<int>(ReadU32(data + 12));
+		const int width = static_cast<int>(ReadU32(data + 16));
+		// DDSD_MIPMAPCOUNT
+		const uint32_t mipCount = (flags & 0x20000) ? ReadU32(data + 28) : 1;
+		const uint32_t fourCC = ReadU32(data + 84);
+
+		size_t offset = headerSize;
+		bool known = true;
+		if (fourCC == MakeFourCC("DXT1"))
+		{
+			m_Format = EBC1;
+		}
+		else if (fourCC == MakeFourCC("DXT2") || fourCC == MakeFourCC("DXT3"))
+		{
+			m_Format = EBC2;
+		}
+		else if (fourCC == MakeFourCC("DXT4") || fourCC == MakeFourCC("DXT5"))
+		{
+			m_Format = EBC3;
+		}
+		else if (fourCC == MakeFourCC("ATI1") || fourCC == MakeFourCC("BC4U"))
+		{
+			m_Format = EBC4;
+		}
+		else if (fourCC == MakeFourCC("ATI2") || fourCC == MakeFourCC("BC5U"))
+		{
+			m_Format = EBC5;
+		}
+		else if (fourCC == MakeFourCC("DX10") && m_FileData.size() >= headerSize + 20)
+		{
+			// Extended header says the format as a DXGI_FORMAT
+			offset += 20;
+			switch (ReadU32(data + headerSize))
+			{
+			case 70: case 71:
+				m_Format = EBC1;
+				break;
+			case 73: case 74:
+				m_Format = EBC2;
+				break;
+			case 76: case 77:
+				m_Format = EBC3;
+				break;
+			case 79: case 80:
+				m_Format = EBC4;
+				break;
+			case 82: case 83:
+				m_Format = EBC5;
+				break;
+			case 97: case 98:
+				m_Format = EBC7;
+				break;
+			default:
+				known = false;
+				break;
+			}
+		}
+		else
+		{
+			known = false;
+		}
+
+		if (!known)
+		{
+			SDL_Log("Texture %s uses a DDS format we don't support (only BC1-5 and BC7)", fileName.c_str());
+			Unload();
+			return false;
+		}
+
+		return AddCompressedLevels(fileName, offset, width, height,
+			static_cast<int>(mipCount > 0 ? mipCount : 1));
+	}
+
+	bool TextureFile::LoadKTX(const std::string& fileName)
+	{
+		if (!ReadFile(fileName))
+		{
+			return false;
+		}
+
+		// 12 byte identifier then 13 uint32s
+		static const unsigned char identifier[12] = {
+			0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'
+		};
+		const size_t headerSize = 12 + 13 * 4;
+		const unsigned char* data = m_FileData.data();
+		if (m_FileData.size() < headerSize || memcmp(data, identifier, 12) != 0 ||
+			ReadU32(data + 12) != 0x04030201)
+		{
+			SDL_Log("Texture %s is not a little endian KTX 1 file", fileName.c_str());
+			Unload();
+			return false;
+		}
+
+		const uint32_t glType = ReadU32(data + 16);
+		const uint32_t glFormat = ReadU32(data + 24);
+		const uint32_t glInternalFormat = ReadU32(data + 28);
+		const int width = static_cast<int>(ReadU32(data + 36));
+		const int height = static_cast<int>(ReadU32(data + 40));
+		const uint32_t faces = ReadU32(data + 52);
+		const uint32_t mipCount = ReadU32(data + 56);
+		const uint32_t keyValueBytes = ReadU32(data + 60);
+		if (faces != 1 || height == 0)
+		{
+			SDL_Log("Texture %s is not a 2D KTX texture", fileName.c_str());
+			Unload();
+			return false;
+		}
+
+		bool known = true;
+		switch (glInternalFormat)
+		{
+		// GL_COMPRESSED_RGB/RGBA_S3TC_DXT1_EXT
+		case 0x83F0: case 0x83F1:
+			m_Format = EBC1;
+			break;
+		// GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+		case 0x83F2:
+			m_Format = EBC2;
+			break;
+		// GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+		case 0x83F3:
+			m_Format = EBC3;
+			break;
+		// GL_COMPRESSED_RED_RGTC1
+		case 0x8DBB:
+			m_Format = EBC4;
+			break;
+		// GL_COMPRESSED_RG_RGTC2
+		case 0x8DBD:
+			m_Format = EBC5;
+			break;
+		// GL_COMPRESSED_RGBA_BPTC_UNORM
+		case 0x8E8C:
+			m_Format = EBC7;
+			break;
+		// GL_RGB8/GL_RGBA8 as GL_RGB/GL_RGBA of GL_UNSIGNED_BYTE
+		case 0x8051:
+			m_Format = ERGB8;
+			known = glFormat == 0x1907 && glType == 0x1401;
+			break;
+		case 0x8058:
+			m_Format = ERGBA8;
+			known = glFormat == 0x1908 && glType == 0x1401;
+			break;
+		default:
+			known = false;
+			break;
+		}
+		if (!known)
+		{
+			SDL_Log("Texture %s uses a KTX format we don't support", fileName.c_str());
+			Unload();
+			return false;
+		}
+
+		// Each level is its size, then the data padded to 4 bytes
+		size_t offset = headerSize + keyValueBytes;
+		int levelCount = static_cast<int>(mipCount > 0 ? mipCount : 1);
+		int levelWidth = width;
+		int levelHeight = height;
+		m_RowAlignment = 4;
+		for (int i = 0; i < levelCount; i++)
+		{
+			if (offset + 4 > m_FileData.size())
+			{
+				break;
+			}
+			size_t size = ReadU32(data + offset);
+			offset += 4;
+			if (offset + size > m_FileData.size())
+			{
+				break;
+			}
+			m_Levels.emplace_back(Level{ levelWidth, levelHeight, data + offset, size });
+			offset += (size + 3) & ~static_cast<size_t>(3);
+			levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+			levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+		}
+
+		if (static_cast<int>(m_Levels.size()) != levelCount)
+		{
+			SDL_Log("Texture %s is truncated", fileName.c_str());
+			Unload();
+			return false;
+		}
+		return true;
+	}
+
+	bool TextureFile::AddCompressedLevels(const std::string& fileName, size_t offset,
+		int width, int height, int levelCount)
+	{
+		const size_t blockSize = GetBlockSize(m_Format);
+		for (int i = 0; i < levelCount; i++)
+		{
+			size_t blocksWide = (static_cast<size_t>(width) + 3) / 4;
+			size_t blocksHigh = (static_cast<size_t>(height) + 3) / 4;
+			size_t size = (blocksWide > 0 ? blocksWide : 1) * (blocksHigh > 0 ? blocksHigh : 1) * blockSize;
+			if (offset + size > m_FileData.size())
+			{
+				SDL_Log("Texture %s is truncated", fileName.c_str());
+				Unload();
+				return false;
+			}
+			m_Levels.emplace_back(Level{ width, height, m_FileData.data() + offset, size });
+			offset += size;
+			width = width > 1 ? width / 2 : 1;
+			height = height > 1 ? height / 2 : 1;
+		}
+		return true;
+	}
+
+	size_t TextureFile::GetBlockSize(Format format)
+	{
+		// Bytes per 4x4 block
+		return (format == EBC1 || format == EBC4) ? 8 : 16;
+	}
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstddef>
+
+namespace Engine
+{
+	// How a texture is sampled
+	struct SamplerSettings
+	{
+		enum WrapMode
+		{
+			ERepeat,
+			EClamp,
+			EMirror
+		};
+
+		SamplerSettings() :
+			m_Wrap(ERepeat),
+			m_Mipmaps(true),
+			m_Anisotropy(1.0f)
+		{
+		}
+
+		WrapMode m_Wrap;
+		// Trilinear filtering over the mip chain (generated if the file doesn't have one)
+		bool m_Mipmaps;
+		// 1 is off, clamped to what the driver supports
+		float m_Anisotropy;
+	};
+
+	// CPU side contents of an image file, every mip level it has
+	// .dds and .ktx keep their block compressed data as it is in the file (and their mip chain),
+	// anything else is decoded by SOIL into a single RGB/RGBA level
+	// No GL calls, so any thread can load one
+	class TextureFile
+	{
+	public:
+		enum Format
+		{
+			ERGB8,
+			ERGBA8,
+			// 4x4 block compressed formats
+			EBC1,
+			EBC2,
+			EBC3,
+			EBC4,
+			EBC5,
+			EBC7
+		};
+
+		struct Level
+		{
+			int m_Width;
+			int m_Height;
+			const unsigned char* m_Data;
+			size_t m_Size;
+		};
+
+		TextureFile();
+		~TextureFile();
+
+		bool Load(const std::string& fileName);
+		void Unload();
+
+		Format GetFormat() const { return m_Format; }
+		bool IsCompressed() const { return m_Format >= EBC1; }
+		const std::vector<Level>& GetLevels() const { return m_Levels; }
+		// Bytes each row of uncompressed data is padded to
+		int GetRowAlignment() const { return m_RowAlignment; }
+		int GetWidth() const { return m_Levels.empty() ? 0 : m_Levels[0].m_Width; }
+		int GetHeight() const { return m_Levels.empty() ? 0 : m_Levels[0].m_Height; }
+	private:
+		bool LoadDDS(const std::string& fileName);
+		bool LoadKTX(const std::string& fileName);
+		bool LoadWithSOIL(const std::string& fileName);
+		bool ReadFile(const std::string& fileName);
+		// Fill m_Levels from levelCount back to back compressed levels starting at offset
+		bool AddCompressedLevels(const std::string& fileName, size_t offset,
+			int width, int height, int levelCount);
+		static size_t GetBlockSize(Format format);
+
+		Format m_Format;
+		std::vector<Level> m_Levels;
+		int m_RowAlignment;
+		// Whole file (dds/ktx), levels point into it
+		std::vector<unsigned char> m_FileData;
+		// SOIL decoded pixels (everything else)
+		unsigned char* m_Pixels;
+	};
+}
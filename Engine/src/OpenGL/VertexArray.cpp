@@ -1,5 +1,6 @@
 
 #include "VertexArray.h"
+#include "GLStateCache.h"
 #include <GL\glew.h>
 
 namespace Engine
@@ -71,8 +72,27 @@ namespace Engine
 		glDeleteVertexArrays(1, &m_VertexArray);
 	}
 
-	void VertexArray::SetActive()
+	void VertexArray::SetActive(GLStateCache* state)
 	{
-		glBindVertexArray(m_VertexArray);
+		state->BindVertexArray(m_VertexArray);
+	}
+
+	void VertexArray::SetInstanceTransforms(unsigned int buffer, size_t byteOffset)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+		// A mat4 attribute is 4 vec4s, one per location, advancing once per instance
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			glEnableVertexAttribArray(3 + i);
+			glVertexAttribPointer(
+				3 + i,
+				4,
+				GL_FLOAT,
+				GL_FALSE,
+				sizeof(float) * 16,
+				reinterpret_cast<void*>(byteOffset + sizeof(float) * 4 * i)
+			);
+			glVertexAttribDivisor(3 + i, 1);
+		}
 	}
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 
 namespace Engine
 {
@@ -10,7 +11,11 @@ namespace Engine
 		~VertexArray();
 
 		// Activate this vertex array (so we can draw it)
-		void SetActive();
+		void SetActive(class GLStateCache* state);
+		// Point the per instance world transform attributes (locations 3 to 6)
+		// at the Matrix4s in buffer starting at byteOffset
+		// The vertex array has to be active
+		void SetInstanceTransforms(unsigned int buffer, size_t byteOffset);
 
 		unsigned int GetNumIndices() const { return m_NumIndices; }
 		unsigned int GetNumVerts() const { return m_NumVerts; }
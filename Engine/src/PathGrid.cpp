@@ -0,0 +1,133 @@
+#include "PathGrid.h"
+
+namespace Engine
+{
+	static const float DiagonalCost = 1.41421356f;
+
+	PathGrid::PathGrid() :
+		m_Width(0),
+		m_Height(0),
+		m_CellSize(1.0f),
+		m_Origin(Vector2::Zero),
+		m_Diagonal(false),
+		m_Version(0)
+	{
+	}
+
+	PathGrid::PathGrid(int width, int height, float cellSize, const Vector2& origin) :
+		m_Width(0),
+		m_Height(0),
+		m_CellSize(cellSize),
+		m_Origin(origin),
+		m_Diagonal(false),
+		m_Version(0)
+	{
+		Resize(width, height);
+	}
+
+	void PathGrid::Resize(int width, int height)
+	{
+		m_Width = width > 0 ? width : 0;
+		m_Height = height > 0 ? height : 0;
+		m_Costs.assign(static_cast<size_t>(m_Width) * m_Height, 1);
+		m_Version++;
+	}
+
+	void PathGrid::SetCost(int index, uint8_t cost)
+	{
+		if (m_Costs[index] != cost)
+		{
+			m_Costs[index] = cost;
+			m_Version++;
+		}
+	}
+
+	int PathGrid::GetNeighbors(int index, int* outCells, float* outCosts) const
+	{
+		const int x = GetX(index);
+		const int y = GetY(index);
+		int count = 0;
+
+		// Up, down, left, right
+		static const int Offsets[4][2] = { { 0, -1 }, { 0, 1 }, { -1, 0 }, { 1, 0 } };
+		for (const auto& offset : Offsets)
+		{
+			int nx = x + offset[0];
+			int ny = y + offset[1];
+			if (IsInside(nx, ny))
+			{
+				int n = GetIndex(nx, ny);
+				if (!IsBlocked(n))
+				{
+					outCells[count] = n;
+					outCosts[count] = static_cast<float>(m_Costs[n]);
+					count++;
+				}
+			}
+		}
+
+		if (m_Diagonal)
+		{
+			static const int Diagonals[4][2] = { { -1, -1 }, { 1, -1 }, { -1, 1 }, { 1, 1 } };
+			for (const auto& offset : Diagonals)
+			{
+				int nx = x + offset[0];
+				int ny = y + offset[1];
+				// Both cells beside the diagonal have to be open, no cutting corners
+				if (IsInside(nx, ny) && !IsBlocked(GetIndex(nx, y)) && !IsBlocked(GetIndex(x, ny)))
+				{
+					int n = GetIndex(nx, ny);
+					if (!IsBlocked(n))
+					{
+						outCells[count] = n;
+						outCosts[count] = m_Costs[n] * DiagonalCost;
+						count++;
+					}
+				}
+			}
+		}
+		return count;
+	}
+
+	float PathGrid::GetStepCost(int from, int to) const
+	{
+		bool diagonal = GetX(from) != GetX(to) && GetY(from) != GetY(to);
+		return diagonal ? m_Costs[to] * DiagonalCost : static_cast<float>(m_Costs[to]);
+	}
+
+	float PathGrid::Heuristic(int a, int b) const
+	{
+		// Every step costs at least 1 (per cell moved)
+		int dx = GetX(a) - GetX(b);
+		int dy = GetY(a) - GetY(b);
+		dx = dx < 0 ? -dx : dx;
+		dy = dy < 0 ? -dy : dy;
+		if (!m_Diagonal)
+		{
+			return static_cast<float>(dx + dy);
+		}
+		// Octile distance: diagonal steps for the shorter axis, straight for the rest
+		int diagonal = dx < dy ? dx : dy;
+		int straight = (dx > dy ? dx : dy) - diagonal;
+		return straight + diagonal * DiagonalCost;
+	}
+
+	Vector2 PathGrid::GetCellCenter(int index) const
+	{
+		return Vector2(m_Origin.x + (GetX(index) + 0.5f) * m_CellSize,
+			m_Origin.y + (GetY(index) + 0.5f) * m_CellSize);
+	}
+
+	int PathGrid::GetCellAt(const Vector2& pos) const
+	{
+		float fx = (pos.x - m_Origin.x) / m_CellSize;
+		float fy = (pos.y - m_Origin.y) / m_CellSize;
+		if (fx < 0.0f || fy < 0.0f)
+		{
+			return -1;
+		}
+		int x = static_cast<int>(fx);
+		int y = static_cast<int>(fy);
+		return IsInside(x, y) ? GetIndex(x, y) : -1;
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "CustomMath.h"
+
+namespace Engine
+{
+	// Flat grid of cells to find paths on, kept apart from any actors
+	// Each cell has a cost to enter it (1 is normal, 0 is blocked).
+	// Cells are numbered row by row: index = y * width + x
+	class PathGrid
+	{
+	public:
+		static const uint8_t Blocked = 0;
+
+		PathGrid();
+		// origin is the world position of the corner of cell (0, 0)
+		PathGrid(int width, int height, float cellSize, const Vector2& origin = Vector2::Zero);
+
+		// Every cell goes back to cost 1
+		void Resize(int width, int height);
+		void SetCellSize(float cellSize) { m_CellSize = cellSize; }
+		void SetOrigin(const Vector2& origin) { m_Origin = origin; }
+		// Allow moving diagonally (not past the corner of a blocked cell)
+		void SetDiagonal(bool value) { m_Diagonal = value; }
+
+		int GetWidth() const { return m_Width; }
+		int GetHeight() const { return m_Height; }
+		int GetCellCount() const { return m_Width * m_Height; }
+		float GetCellSize() const { return m_CellSize; }
+		bool GetDiagonal() const { return m_Diagonal; }
+
+		int GetIndex(int x, int y) const { return y * m_Width + x; }
+		int GetX(int index) const { return index % m_Width; }
+		int GetY(int index) const { return index / m_Width; }
+		bool IsInside(int x, int y) const { return x >= 0 && y >= 0 && x < m_Width && y < m_Height; }
+
+		uint8_t GetCost(int index) const { return m_Costs[index]; }
+		bool IsBlocked(int index) const { return m_Costs[index] == Blocked; }
+		void SetCost(int index, uint8_t cost);
+		void SetBlocked(int index, bool blocked) { SetCost(index, blocked ? Blocked : 1); }
+
+		// Neighbours of index that can be walked into, with the cost of the step
+		// Returns how many were written (at most 8)
+		int GetNeighbors(int index, int* outCells, float* outCosts) const;
+		// Cost of stepping from a cell into one of its neighbours
+		float GetStepCost(int from, int to) const;
+		// Lower bound on the cost from a to b (admissible for A*)
+		float Heuristic(int a, int b) const;
+
+		Vector2 GetCellCenter(int index) const;
+		// Cell containing a world position, -1 if it's outside the grid
+		int GetCellAt(const Vector2& pos) const;
+
+		// Goes up by one every time a cost changes, so cached paths can tell they're out of date
+		uint32_t GetVersion() const { return m_Version; }
+	private:
+		std::vector<uint8_t> m_Costs;
+		int m_Width;
+		int m_Height;
+		float m_CellSize;
+		Vector2 m_Origin;
+		bool m_Diagonal;
+		uint32_t m_Version;
+	};
+}
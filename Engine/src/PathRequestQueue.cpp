@@ -0,0 +1,288 @@
+#include "PathRequestQueue.h"
+#include <algorithm>
+#include <SDL_timer.h>
+
+namespace Engine
+{
+	// Guess for how long a search takes, until some have been timed
+	static const float InitialSearchMicroseconds = 100.0f;
+
+	PathRequestQueue::PathRequestQueue(NavMesh* mesh, JobSystem* jobs) :
+		m_Mesh(mesh),
+		m_Jobs(jobs),
+		m_Merging(true),
+		m_BatchSize(0),
+		m_NextTicket(1),
+		m_AverageSearch(InitialSearchMicroseconds),
+		m_Queries(1),
+		m_Stats{ 0, 0, 0, 0 }
+	{
+		// Jobs only get picked up by workers, so with none the game thread does the searching
+		if (m_Jobs && m_Jobs->GetThreadCount() > 1)
+		{
+			m_BatchSize = m_Jobs->GetThreadCount() * 4;
+		}
+	}
+
+	PathRequestQueue::~PathRequestQueue()
+	{
+		if (!m_Batch.empty())
+		{
+			m_Jobs->Wait(m_BatchCounter);
+		}
+		for (Search* search : m_Batch)
+		{
+			delete search;
+		}
+		for (Search* search : m_Pending)
+		{
+			delete search;
+		}
+	}
+
+	PathRequestQueue::Ticket PathRequestQueue::Request(const Vector3& start, const Vector3& goal, Callback callback)
+	{
+		Ticket ticket = m_NextTicket++;
+		if (m_NextTicket == NoTicket)
+		{
+			m_NextTicket = 1;
+		}
+		m_Stats.m_Requests++;
+
+		// Same polygons at both ends means the same corridor
+		Search* search = nullptr;
+		bool mergeable = false;
+		uint64_t key = 0;
+		if (m_Merging)
+		{
+			int startPoly = m_Mesh->FindPathPoly(start);
+			int endPoly = m_Mesh->FindPathPoly(goal);
+			if (startPoly >= 0 && endPoly >= 0)
+			{
+				mergeable = true;
+				key = MakeKey(startPoly, endPoly);
+				auto iter = m_PendingByKey.find(key);
+				if (iter != m_PendingByKey.end())
+				{
+					search = iter->second;
+					m_Stats.m_Merged++;
+				}
+			}
+		}
+		if (!search)
+		{
+			search = new Search();
+			search->m_Key = key;
+			search->m_Found = false;
+			search->m_InFlight = false;
+			search->m_Microseconds = 0.0f;
+			m_Pending.emplace_back(search);
+			if (mergeable)
+			{
+				m_PendingByKey.emplace(key, search);
+			}
+		}
+		search->m_Listeners.emplace_back(Listener{ ticket, start, goal, std::move(callback), std::vector<Vector3>() });
+		m_Tickets.emplace(ticket, search);
+		return ticket;
+	}
+
+	void PathRequestQueue::Cancel(Ticket ticket)
+	{
+		auto iter = m_Tickets.find(ticket);
+		if (iter == m_Tickets.end())
+		{
+			return;
+		}
+		Search* search = iter->second;
+		m_Tickets.erase(iter);
+		m_Stats.m_Cancelled++;
+
+		// A worker may be reading its listeners, Deliver skips the ticket instead
+		if (search->m_InFlight)
+		{
+			return;
+		}
+
+		auto& listeners = search->m_Listeners;
+		listeners.erase(std::remove_if(listeners.begin(), listeners.end(),
+			[ticket](const Listener& listener)
+			{
+				return listener.m_Ticket == ticket;
+			}), listeners.end());
+
+		// Nobody wants it any more, so don't merge into it (the queue drops it when it comes up)
+		if (listeners.empty())
+		{
+			ForgetPending(search);
+		}
+	}
+
+	void PathRequestQueue::Update(float budgetMicroseconds)
+	{
+		const Uint64 start = SDL_GetPerformanceCounter();
+		const double ticksPerMicrosecond = static_cast<double>(SDL_GetPerformanceFrequency()) / 1000000.0;
+
+		if (!m_Batch.empty() && m_BatchCounter.IsDone())
+		{
+			FinishBatch();
+		}
+
+		if (m_BatchSize > 0)
+		{
+			// The next batch goes out once the last one is back
+			if (m_Batch.empty())
+			{
+				StartBatch(budgetMicroseconds);
+			}
+			return;
+		}
+
+		// No workers: search here, one whole search at a time, until the budget runs out
+		while (static_cast<double>(SDL_GetPerformanceCounter() - start) / ticksPerMicrosecond < budgetMicroseconds)
+		{
+			Search* search = PopPending();
+			if (!search)
+			{
+				break;
+			}
+			RunSearch(search, m_Queries[0]);
+			m_Stats.m_Searches++;
+			AddSearchTime(search->m_Microseconds);
+			Deliver(search);
+		}
+	}
+
+	void PathRequestQueue::Flush()
+	{
+		if (!m_Batch.empty())
+		{
+			m_Jobs->Wait(m_BatchCounter);
+			FinishBatch();
+		}
+		while (Search* search = PopPending())
+		{
+			RunSearch(search, m_Queries[0]);
+			m_Stats.m_Searches++;
+			AddSearchTime(search->m_Microseconds);
+			Deliver(search);
+		}
+	}
+
+	uint64_t PathRequestQueue::MakeKey(int startPoly, int endPoly)
+	{
+		return (static_cast<uint64_t>(static_cast<uint32_t>(startPoly)) << 32) | static_cast<uint32_t>(endPoly);
+	}
+
+	PathRequestQueue::Search* PathRequestQueue::PopPending()
+	{
+		while (!m_Pending.empty())
+		{
+			Search* search = m_Pending.front();
+			m_Pending.pop_front();
+			if (search->m_Listeners.empty())
+			{
+				// Every ticket was cancelled
+				delete search;
+				continue;
+			}
+			// Being searched now, later requests can't merge into it
+			ForgetPending(search);
+			return search;
+		}
+		return nullptr;
+	}
+
+	void PathRequestQueue::ForgetPending(Search* search)
+	{
+		// Unmergeable searches share key 0 with nothing, so check it's this one
+		auto iter = m_PendingByKey.find(search->m_Key);
+		if (iter != m_PendingByKey.end() && iter->second == search)
+		{
+			m_PendingByKey.erase(iter);
+		}
+	}
+
+	void PathRequestQueue::RunSearch(Search* search, NavMesh::Query& query) const
+	{
+		const Uint64 start = SDL_GetPerformanceCounter();
+
+		Listener& first = search->m_Listeners[0];
+		search->m_Found = m_Mesh->FindPath(first.m_Start, first.m_Goal, first.m_Path, query);
+		if (search->m_Found)
+		{
+			for (size_t i = 1; i < search->m_Listeners.size(); i++)
+			{
+				Listener& listener = search->m_Listeners[i];
+				m_Mesh->FindPathAlong(listener.m_Start, listener.m_Goal, query, listener.m_Path);
+			}
+		}
+
+		search->m_Microseconds = static_cast<float>(static_cast<double>(SDL_GetPerformanceCounter() - start) *
+			1000000.0 / static_cast<double>(SDL_GetPerformanceFrequency()));
+	}
+
+	void PathRequestQueue::StartBatch(float budgetMicroseconds)
+	{
+		// As many searches as should fit in the budget, going by recent ones
+		int count = static_cast<int>(budgetMicroseconds / CustomMath::Max(m_AverageSearch, 1.0f));
+		count = CustomMath::Clamp(count, 1, m_BatchSize);
+		while (static_cast<int>(m_Batch.size()) < count)
+		{
+			Search* search = PopPending();
+			if (!search)
+			{
+				break;
+			}
+			search->m_InFlight = true;
+			m_Batch.emplace_back(search);
+		}
+		if (m_Queries.size() < m_Batch.size())
+		{
+			m_Queries.resize(m_Batch.size());
+		}
+
+		// Each search gets its own query, the mesh itself is only read
+		for (size_t i = 0; i < m_Batch.size(); i++)
+		{
+			m_Jobs->Run([this, i]()
+				{
+					RunSearch(m_Batch[i], m_Queries[i]);
+				}, &m_BatchCounter);
+		}
+	}
+
+	void PathRequestQueue::FinishBatch()
+	{
+		// Callbacks can queue more requests, so take the batch first
+		std::vector<Search*> batch;
+		batch.swap(m_Batch);
+		for (Search* search : batch)
+		{
+			m_Stats.m_Searches++;
+			AddSearchTime(search->m_Microseconds);
+			Deliver(search);
+		}
+	}
+
+	void PathRequestQueue::Deliver(Search* search)
+	{
+		// Take the listeners, a callback could cancel one that hasn't been called yet
+		std::vector<Listener> listeners;
+		listeners.swap(search->m_Listeners);
+		for (Listener& listener : listeners)
+		{
+			if (m_Tickets.erase(listener.m_Ticket) > 0)
+			{
+				listener.m_Callback(listener.m_Ticket, search->m_Found, listener.m_Path);
+			}
+		}
+		delete search;
+	}
+
+	void PathRequestQueue::AddSearchTime(float microseconds)
+	{
+		// Leans on the last few dozen searches
+		m_AverageSearch += (microseconds - m_AverageSearch) * 0.05f;
+	}
+}
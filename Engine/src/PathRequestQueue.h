@@ -0,0 +1,111 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include "CustomMath.h"
+#include "NavMesh.h"
+#include "JobSystem.h"
+
+namespace Engine
+{
+	// Nav mesh path requests, answered a few at a time instead of all in the frame they're made
+	// Callers get a ticket back, and their callback runs from Update (on the game thread)
+	// once the path is done. A request that starts and ends in the same polygons as one
+	// still waiting shares its search: the polygon corridor is found once, and every
+	// requester gets its own corners, from its own start to its own goal, along it.
+	// Each Update starts about budgetMicroseconds worth of searching. Without workers it
+	// runs the searches itself; with them it hands them out as a batch and delivers the
+	// results in a later Update (sized by how long recent searches took).
+	class PathRequestQueue
+	{
+	public:
+		typedef uint32_t Ticket;
+		static const Ticket NoTicket = 0;
+		// found is false (and path empty) if there's no way to the goal
+		typedef std::function<void(Ticket ticket, bool found, const std::vector<Vector3>& path)> Callback;
+
+		PathRequestQueue(NavMesh* mesh, JobSystem* jobs = nullptr);
+		~PathRequestQueue();
+
+		Ticket Request(const Vector3& start, const Vector3& goal, Callback callback);
+		// The callback won't run (fine to call after it already has)
+		void Cancel(Ticket ticket);
+
+		// Deliver finished paths and start about budgetMicroseconds of searching
+		void Update(float budgetMicroseconds);
+		// Finish everything now (e.g. before the nav mesh is rebuilt)
+		void Flush();
+
+		// Share searches between requests with the same start and end polygons (on by default)
+		void SetMerging(bool merge) { m_Merging = merge; }
+		// Most searches handed to the workers at once (0 runs them all on the game thread)
+		void SetBatchSize(int size) { m_BatchSize = size; }
+
+		// Searches waiting to run (merged requests count once)
+		int GetPendingCount() const { return static_cast<int>(m_Pending.size()); }
+		// Running average of how long one search takes
+		float GetAverageSearchMicroseconds() const { return m_AverageSearch; }
+		struct Stats
+		{
+			int m_Requests;
+			int m_Merged;
+			int m_Searches;
+			int m_Cancelled;
+		};
+		const Stats& GetStats() const { return m_Stats; }
+	private:
+		struct Listener
+		{
+			Ticket m_Ticket;
+			Vector3 m_Start;
+			Vector3 m_Goal;
+			Callback m_Callback;
+			std::vector<Vector3> m_Path;
+		};
+		// One corridor search, shared by every listener merged into it
+		struct Search
+		{
+			// Start and end polygons (only meaningful if it can be merged into)
+			uint64_t m_Key;
+			std::vector<Listener> m_Listeners;
+			bool m_Found;
+			// Handed to a worker, so its listeners are left alone until it's delivered
+			bool m_InFlight;
+			float m_Microseconds;
+		};
+
+		static uint64_t MakeKey(int startPoly, int endPoly);
+		Search* PopPending();
+		void ForgetPending(Search* search);
+		// Corridor for the first listener, then everyone's corners along it
+		void RunSearch(Search* search, NavMesh::Query& query) const;
+		void StartBatch(float budgetMicroseconds);
+		void FinishBatch();
+		void Deliver(Search* search);
+		void AddSearchTime(float microseconds);
+
+		NavMesh* m_Mesh;
+		JobSystem* m_Jobs;
+		bool m_Merging;
+		int m_BatchSize;
+		Ticket m_NextTicket;
+		float m_AverageSearch;
+
+		// Oldest first (searches with every ticket cancelled are skipped)
+		std::deque<Search*> m_Pending;
+		// Pending searches that can still be merged into, by key
+		std::unordered_map<uint64_t, Search*> m_PendingByKey;
+		// Which search each live ticket is waiting on
+		std::unordered_map<Ticket, Search*> m_Tickets;
+
+		// Searches running on the workers, each with its own query
+		// (the game thread uses the first query when it searches itself)
+		std::vector<Search*> m_Batch;
+		std::vector<NavMesh::Query> m_Queries;
+		JobCounter m_BatchCounter;
+
+		Stats m_Stats;
+	};
+}
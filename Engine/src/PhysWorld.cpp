@@ -8,35 +8,35 @@ namespace Engine
 {
 	PhysWorld::PhysWorld(Game* game)
 		:m_Game(game)
+		, m_BVH(10.0f)
 	{
 	}
 
 	bool PhysWorld::SegmentCast(const LineSegment& l, CollisionInfo& outColl)
 	{
 		bool collided = false;
-		// Initialize closestT to infinity, so first
-		// intersection will always update closestT
-		float closestT = CustomMath::Infinity;
 		Vector3 norm;
-		// Test against all boxes
-		for (auto box : m_Boxes)
-		{
-			float t;
-			// Does the segment intersect with the box?
-			if (Intersect(l, box->GetWorldBox(), t, norm))
+		// Only test boxes whose BVH nodes the segment goes through,
+		// nearest first (closestT starts at infinity and is lowered on each hit)
+		m_BVH.SegmentCast(l, [&](int proxyId, float& closestT)
 			{
-				// Is this closer than previous intersection?
-				if (t < closestT)
+				BoxComponent* box = static_cast<BoxComponent*>(m_BVH.GetUserData(proxyId));
+				float t;
+				// Does the segment intersect with the box?
+				if (Intersect(l, box->GetWorldBox(), t, norm))
 				{
-					closestT = t;
-					outColl.m_Point = l.PointOnSegment(t);
-					outColl.m_Normal = norm;
-					outColl.m_Box = box;
-					outColl.m_Actor = box->GetOwner();
-					collided = true;
+					// Is this closer than previous intersection?
+					if (t < closestT)
+					{
+						closestT = t;
+						outColl.m_Point = l.PointOnSegment(t);
+						outColl.m_Normal = norm;
+						outColl.m_Box = box;
+						outColl.m_Actor = box->GetOwner();
+						collided = true;
+					}
 				}
-			}
-		}
+			});
 		return collided;
 	}
 
@@ -59,52 +59,49 @@ namespace Engine
 		}
 	}
 
-	void PhysWorld::TestSweepAndPrune(std::function<void(Actor*, Actor*)> f)
+	void PhysWorld::UpdateOverlaps()
 	{
-		// Sort by min.x
-		std::sort(m_Boxes.begin(), m_Boxes.end(),
-			[](BoxComponent* a, BoxComponent* b)
-			{
-				return a->GetWorldBox().m_Min.x <
-					b->GetWorldBox().m_Min.x;
-			});
+		// The pairs are already up to date (boxes are resorted as they move),
+		// this only turns them into begin/stay/end events
+		m_SAP.UpdatePairs(m_SAPEvents);
 
-		for (size_t i = 0; i < m_Boxes.size(); i++)
+		m_OverlapEvents.clear();
+		for (const auto& e : m_SAPEvents)
 		{
-			// Get max.x for current box
-			BoxComponent* a = m_Boxes[i];
-			float max = a->GetWorldBox().m_Max.x;
-			for (size_t j = i + 1; j < m_Boxes.size(); j++)
-			{
-				BoxComponent* b = m_Boxes[j];
-				// If AABB[j] min is past the max bounds of AABB[i],
-				// then there aren't any other possible intersections
-				// against AABB[i]
-				if (b->GetWorldBox().m_Min.x > max)
-				{
-					break;
-				}
-				else if (Intersect(a->GetWorldBox(), b->GetWorldBox()))
-				{
-					f(a->GetOwner(), b->GetOwner());
-				}
-			}
+			OverlapEvent overlap;
+			overlap.m_Type = e.m_Type;
+			overlap.m_A = static_cast<BoxComponent*>(m_SAP.GetUserData(e.m_ProxyA));
+			overlap.m_B = static_cast<BoxComponent*>(m_SAP.GetUserData(e.m_ProxyB));
+			m_OverlapEvents.emplace_back(overlap);
 		}
 	}
 
 	void PhysWorld::AddBox(BoxComponent* box)
 	{
-		m_Boxes.emplace_back(box);
+		box->SetPhysHandle(m_Boxes.Insert(box));
+		box->SetProxyId(m_BVH.CreateProxy(box->GetWorldBox(), box));
+		box->SetSAPProxyId(m_SAP.AddProxy(box->GetWorldBox(), box));
 	}
 
 	void PhysWorld::RemoveBox(BoxComponent* box)
 	{
-		auto iter = std::find(m_Boxes.begin(), m_Boxes.end(), box);
-		if (iter != m_Boxes.end())
-		{
-			// Swap to end of vector and pop off (avoid erase copies)
-			std::iter_swap(iter, m_Boxes.end() - 1);
-			m_Boxes.pop_back();
-		}
+		// Swaps the last box into its spot
+		m_Boxes.Remove(box->GetPhysHandle());
+		box->SetPhysHandle(SlotHandle());
+		m_BVH.DestroyProxy(box->GetProxyId());
+		box->SetProxyId(AABBTree::NullNode);
+		m_SAP.RemoveProxy(box->GetSAPProxyId());
+		box->SetSAPProxyId(-1);
+	}
+
+	void PhysWorld::UpdateBox(BoxComponent* box)
+	{
+		m_BVH.MoveProxy(box->GetProxyId(), box->GetWorldBox());
+		m_SAP.MoveProxy(box->GetSAPProxyId(), box->GetWorldBox());
+	}
+
+	void PhysWorld::RebuildBVH()
+	{
+		m_BVH.Rebuild();
 	}
 }
\ No newline at end of file
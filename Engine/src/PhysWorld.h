@@ -4,6 +4,9 @@
 #include <functional>
 #include "CustomMath.h"
 #include "Collision.h"
+#include "AABBTree.h"
+#include "SweepAndPrune.h"
+#include "SlotMap.h"
 
 namespace Engine
 {
@@ -31,15 +34,36 @@ namespace Engine
 
 		// Tests collisions using naive pairwise
 		void TestPairwise(std::function<void(class Actor*, class Actor*)> f);
-		// Test collisions using sweep and prune
-		void TestSweepAndPrune(std::function<void(class Actor*, class Actor*)> f);
+
+		// Overlap between two boxes, reported by the sweep and prune broadphase
+		struct OverlapEvent
+		{
+			// Began, still overlapping, or ended since the last update
+			SweepAndPrune::OverlapEvent::Type m_Type;
+			class BoxComponent* m_A;
+			class BoxComponent* m_B;
+		};
+
+		// Collect the overlap events since the last call (once per frame)
+		void UpdateOverlaps();
+		const std::vector<OverlapEvent>& GetOverlapEvents() const { return m_OverlapEvents; }
 
 		// Add/remove box components from world
 		void AddBox(class BoxComponent* box);
 		void RemoveBox(class BoxComponent* box);
+		// Let the BVH and sweep and prune know a box moved
+		void UpdateBox(class BoxComponent* box);
+		// Rebuild the BVH from scratch (after loading a lot of static geometry)
+		void RebuildBVH();
 	private:
 		class Game* m_Game;
-		std::vector<class BoxComponent*> m_Boxes;
+		SlotMap<class BoxComponent*> m_Boxes;
+		// Bounding volume hierarchy of every box, for segment casts
+		AABBTree m_BVH;
+		// Persistent broadphase for box vs box overlaps
+		SweepAndPrune m_SAP;
+		std::vector<SweepAndPrune::OverlapEvent> m_SAPEvents;
+		std::vector<OverlapEvent> m_OverlapEvents;
 	};
 }
 
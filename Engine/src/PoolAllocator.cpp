@@ -0,0 +1,164 @@
+#include "PoolAllocator.h"
+#include <new>
+#include <SDL_log.h>
+
+namespace Engine
+{
+	BlockPool::BlockPool() :
+		m_FreeList(nullptr),
+		m_BlockSize(0),
+		m_BlocksPerSlab(0)
+	{
+	}
+
+	BlockPool::~BlockPool()
+	{
+		if (m_Stats.m_Live > 0)
+		{
+			SDL_Log("BlockPool of %u byte blocks destroyed with %u still allocated",
+				static_cast<unsigned int>(m_BlockSize), static_cast<unsigned int>(m_Stats.m_Live));
+		}
+		for (auto slab : m_Slabs)
+		{
+			::operator delete(slab);
+		}
+	}
+
+	void BlockPool::Initialize(size_t blockSize, size_t blocksPerSlab)
+	{
+		// Big enough to hold the free list link, and keeps every block aligned
+		const size_t alignment = PoolAllocator::Alignment;
+		if (blockSize < sizeof(FreeBlock))
+		{
+			blockSize = sizeof(FreeBlock);
+		}
+		m_BlockSize = (blockSize + alignment - 1) / alignment * alignment;
+		m_BlocksPerSlab = blocksPerSlab > 0 ? blocksPerSlab : 1;
+	}
+
+	void* BlockPool::Allocate()
+	{
+		if (!m_FreeList)
+		{
+			AddSlab();
+		}
+
+		FreeBlock* block = m_FreeList;
+		m_FreeList = block->m_Next;
+
+		m_Stats.m_Allocations++;
+		m_Stats.m_Live++;
+		if (m_Stats.m_Live > m_Stats.m_PeakLive)
+		{
+			m_Stats.m_PeakLive = m_Stats.m_Live;
+		}
+		return block;
+	}
+
+	void BlockPool::Free(void* block)
+	{
+		if (!block)
+		{
+			return;
+		}
+		// Most recently freed goes out first, it's the likeliest to still be in cache
+		FreeBlock* freed = static_cast<FreeBlock*>(block);
+		freed->m_Next = m_FreeList;
+		m_FreeList = freed;
+
+		m_Stats.m_Frees++;
+		m_Stats.m_Live--;
+	}
+
+	void BlockPool::AddSlab()
+	{
+		// operator new memory is aligned for any fundamental type (16 bytes on x64)
+		size_t bytes = m_BlockSize * m_BlocksPerSlab;
+		unsigned char* slab = static_cast<unsigned char*>(::operator new(bytes));
+		m_Slabs.emplace_back(slab);
+		m_Stats.m_Slabs++;
+		m_Stats.m_BytesReserved += bytes;
+
+		// Thread the new blocks onto the free list in address order
+		for (size_t i = m_BlocksPerSlab; i > 0; i--)
+		{
+			FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + (i - 1) * m_BlockSize);
+			block->m_Next = m_FreeList;
+			m_FreeList = block;
+		}
+	}
+
+	PoolAllocator::PoolAllocator(size_t slabBytes) :
+		m_Fallbacks(0),
+		m_FallbackFrees(0)
+	{
+		for (size_t i = 0; i < MaxSize / Alignment; i++)
+		{
+			size_t blockSize = (i + 1) * Alignment;
+			m_Pools[i].Initialize(blockSize, slabBytes / blockSize);
+		}
+	}
+
+	void* PoolAllocator::Allocate(size_t size)
+	{
+		if (size == 0)
+		{
+			size = 1;
+		}
+		if (size > MaxSize)
+		{
+			m_Fallbacks++;
+			return ::operator new(size);
+		}
+		return m_Pools[GetSizeClass(size)].Allocate();
+	}
+
+	void PoolAllocator::Free(void* ptr, size_t size)
+	{
+		if (!ptr)
+		{
+			return;
+		}
+		if (size == 0)
+		{
+			size = 1;
+		}
+		if (size > MaxSize)
+		{
+			m_FallbackFrees++;
+			::operator delete(ptr);
+			return;
+		}
+		m_Pools[GetSizeClass(size)].Free(ptr);
+	}
+
+	PoolStats PoolAllocator::GetStats() const
+	{
+		PoolStats total;
+		for (const auto& pool : m_Pools)
+		{
+			const PoolStats& stats = pool.GetStats();
+			total.m_Allocations += stats.m_Allocations;
+			total.m_Frees += stats.m_Frees;
+			total.m_Live += stats.m_Live;
+			// Sum of the per class peaks (they needn't have happened at the same time)
+			total.m_PeakLive += stats.m_PeakLive;
+			total.m_Slabs += stats.m_Slabs;
+			total.m_BytesReserved += stats.m_BytesReserved;
+		}
+		total.m_Allocations += m_Fallbacks;
+		total.m_Frees += m_FallbackFrees;
+		total.m_Live += m_Fallbacks - m_FallbackFrees;
+		total.m_Fallbacks = m_Fallbacks;
+		return total;
+	}
+
+	const PoolStats* PoolAllocator::GetSizeClassStats(size_t size) const
+	{
+		if (size == 0)
+		{
+			size = 1;
+		}
+		return size > MaxSize ? nullptr : &m_Pools[GetSizeClass(size)].GetStats();
+	}
+}
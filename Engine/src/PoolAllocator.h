@@ -0,0 +1,92 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+namespace Engine
+{
+	// Counters for a PoolAllocator (or one of its size classes)
+	struct PoolStats
+	{
+		PoolStats() :
+			m_Allocations(0),
+			m_Frees(0),
+			m_Live(0),
+			m_PeakLive(0),
+			m_Slabs(0),
+			m_BytesReserved(0),
+			m_Fallbacks(0)
+		{
+		}
+
+		size_t m_Allocations;
+		size_t m_Frees;
+		// Blocks handed out and not freed yet, and the most there ever were
+		size_t m_Live;
+		size_t m_PeakLive;
+		size_t m_Slabs;
+		// Slab memory, used or not
+		size_t m_BytesReserved;
+		// Allocations too big for any size class (went to the heap)
+		size_t m_Fallbacks;
+	};
+
+	// Fixed size blocks carved out of big slabs
+	// Freed blocks go on a free list (the link is stored in the block itself)
+	// and are handed out again before a new slab is made.
+	// Slabs are only released when the pool is destroyed.
+	class BlockPool
+	{
+	public:
+		BlockPool();
+		~BlockPool();
+
+		// blockSize is rounded up to the pool alignment
+		void Initialize(size_t blockSize, size_t blocksPerSlab);
+		void* Allocate();
+		void Free(void* block);
+
+		size_t GetBlockSize() const { return m_BlockSize; }
+		const PoolStats& GetStats() const { return m_Stats; }
+	private:
+		void AddSlab();
+
+		struct FreeBlock
+		{
+			FreeBlock* m_Next;
+		};
+		FreeBlock* m_FreeList;
+		std::vector<void*> m_Slabs;
+		size_t m_BlockSize;
+		size_t m_BlocksPerSlab;
+		PoolStats m_Stats;
+	};
+
+	// Allocations sorted into size classes (multiples of Alignment up to MaxSize),
+	// each its own BlockPool, so same size objects share slabs
+	// Bigger requests fall back to the heap.
+	// Not thread-safe: allocate and free from one thread
+	class PoolAllocator
+	{
+	public:
+		// Every block is aligned to this
+		static const size_t Alignment = 16;
+		static const size_t MaxSize = 512;
+
+		PoolAllocator(size_t slabBytes = 64 * 1024);
+
+		void* Allocate(size_t size);
+		// size has to be what was passed to Allocate
+		void Free(void* ptr, size_t size);
+
+		// Totals over every size class
+		PoolStats GetStats() const;
+		// Stats of the size class size falls in (nullptr if it's too big for one)
+		const PoolStats* GetSizeClassStats(size_t size) const;
+	private:
+		static size_t GetSizeClass(size_t size) { return (size + Alignment - 1) / Alignment - 1; }
+
+		BlockPool m_Pools[MaxSize / Alignment];
+		size_t m_Fallbacks;
+		size_t m_FallbackFrees;
+	};
+}
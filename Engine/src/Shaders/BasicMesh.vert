@@ -5,7 +5,30 @@
 // Uniforms are global variable that typically stay the same between numerous invocations of the shader program
 // 4xt matrices are needed for a 3D space with homogeneous coordinates
 uniform mat4 uWorldTransform;
-uniform mat4 uViewProj;
+
+// Per-frame data shared by every shader, filled once a frame by the renderer
+// (must match Renderer::FrameData, and be the same in every shader that declares it)
+struct DirectionalLight
+{
+	// Direction of light
+	vec3 m_Direction;
+	// Diffuse Color
+	vec3 m_DiffuseColor;
+	// Specular Color
+	vec3 m_SpecColor;
+};
+layout(std140, row_major) uniform FrameData
+{
+	mat4 uViewProj;
+	// View-projection for sprites/UI (screen space)
+	mat4 uSpriteViewProj;
+	// Camera position (in world space)
+	vec3 uCameraPos;
+	// Ambient light level
+	vec3 uAmbientLight;
+	// Directional Light
+	DirectionalLight uDirLight;
+};
 
 // Vertex attributes for each vertex
 // Corresponds to the data stored for each vertex in the vertex buffer (vertex attributes)
@@ -16,7 +16,9 @@ out vec4 outColor;
 // in the shader corresponds to the active texture
 uniform sampler2D uTexture;
 
-struct DirectionalLight 
+// Per-frame data shared by every shader, filled once a frame by the renderer
+// (must match Renderer::FrameData, and be the same in every shader that declares it)
+struct DirectionalLight
 {
 	// Direction of light
 	vec3 m_Direction;
@@ -25,17 +27,22 @@ struct DirectionalLight
 	// Specular Color
 	vec3 m_SpecColor;
 };
+layout(std140, row_major) uniform FrameData
+{
+	mat4 uViewProj;
+	// View-projection for sprites/UI (screen space)
+	mat4 uSpriteViewProj;
+	// Camera position (in world space)
+	vec3 uCameraPos;
+	// Ambient light level
+	vec3 uAmbientLight;
+	// Directional Light
+	DirectionalLight uDirLight;
+};
 
 // Uniforms for lighting
-// Camera position (in world space)
-uniform vec3 uCameraPos;
 // Specular power for this surface
 uniform float uSpecPower;
-// Ambient light level
-uniform vec3 uAmbientLight;
-
-// Directional Light
-uniform DirectionalLight uDirLight;
 
 void main() 
 {
@@ -0,0 +1,57 @@
+// Request GLSL 3.3
+#version 330
+
+// Same as Phong.vert, but the world transform comes from the instance buffer
+// so one draw call can draw every instance of a mesh
+// Per-frame data shared by every shader, filled once a frame by the renderer
+// (must match Renderer::FrameData, and be the same in every shader that declares it)
+struct DirectionalLight
+{
+	// Direction of light
+	vec3 m_Direction;
+	// Diffuse Color
+	vec3 m_DiffuseColor;
+	// Specular Color
+	vec3 m_SpecColor;
+};
+layout(std140, row_major) uniform FrameData
+{
+	mat4 uViewProj;
+	// View-projection for sprites/UI (screen space)
+	mat4 uSpriteViewProj;
+	// Camera position (in world space)
+	vec3 uCameraPos;
+	// Ambient light level
+	vec3 uAmbientLight;
+	// Directional Light
+	DirectionalLight uDirLight;
+};
+
+// Vertex attributes for each vertex
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inTexCoord;
+// Per instance world transform (takes locations 3 to 6)
+// Each row of the engine's Matrix4 arrives as one column here,
+// so the multiplications below go in the opposite order from Phong.vert
+layout(location = 3) in mat4 inWorldTransform;
+
+out vec2 fragTexCoord;
+// Normal (in world space)
+out vec3 fragNormal;
+// Position (in world space)
+out vec3 fragWorldPos;
+
+void main()
+{
+	// Transform position to world space
+	vec4 pos = inWorldTransform * vec4(inPosition, 1.0);
+	fragWorldPos = pos.xyz;
+	// Transform to clip space
+	gl_Position = pos * uViewProj;
+
+	// Transform normal into world space (w = 0 so translation is ignored)
+	fragNormal = (inWorldTransform * vec4(inNormal, 0.0f)).xyz;
+
+	fragTexCoord = inTexCoord;
+}
@@ -1,18 +1,36 @@
-
 // Request GLSL 3.3
 #version 330
 
-// Uniforms are global variable that typically stay the same between numerous invocations of the shader program
-// 4xt matrices are needed for a 3D space with homogeneous coordinates
-uniform mat4 uWorldTransform;
-uniform mat4 uViewProj;
+// Per-frame data shared by every shader, filled once a frame by the renderer
+// (must match Renderer::FrameData, and be the same in every shader that declares it)
+struct DirectionalLight
+{
+	// Direction of light
+	vec3 m_Direction;
+	// Diffuse Color
+	vec3 m_DiffuseColor;
+	// Specular Color
+	vec3 m_SpecColor;
+};
+layout(std140, row_major) uniform FrameData
+{
+	mat4 uViewProj;
+	// View-projection for sprites/UI (screen space)
+	mat4 uSpriteViewProj;
+	// Camera position (in world space)
+	vec3 uCameraPos;
+	// Ambient light level
+	vec3 uAmbientLight;
+	// Directional Light
+	DirectionalLight uDirLight;
+};
 
 // Vertex attributes for each vertex
 // Corresponds to the data stored for each vertex in the vertex buffer (vertex attributes)
 // Attribute 0 is position, 1 is tex coords
+// The SpriteBatch already moved the positions into world space
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
-layout(location = 2) in vec2 inTexCoord;
+layout(location = 1) in vec2 inTexCoord;
 
 // The fragment shader needs to know the texture coordinates to determine the color
 // at the pixel
@@ -21,8 +39,8 @@ out vec2 fragTexCoord;
 void main()
 {
 	vec4 pos = vec4(inPosition, 1.0);
-	gl_Position = pos * uWorldTransform * uViewProj;
+	gl_Position = pos * uSpriteViewProj;
 
 	// Pass along the texture coordinates to frag shader
 	fragTexCoord = inTexCoord;
-}
\ No newline at end of file
+}
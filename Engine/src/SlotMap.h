@@ -0,0 +1,157 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Engine
+{
+	// Handle to a value in a SlotMap
+	// The generation changes every time a slot is reused, so a handle to something
+	// that was removed stops resolving instead of pointing at whatever took its place
+	struct SlotHandle
+	{
+		SlotHandle() :
+			m_Index(0),
+			m_Generation(0)
+		{
+		}
+		SlotHandle(uint32_t index, uint32_t generation) :
+			m_Index(index),
+			m_Generation(generation)
+		{
+		}
+
+		// False for a default constructed handle (it may still be stale)
+		bool IsSet() const { return m_Generation != 0; }
+		bool operator==(const SlotHandle& other) const { return m_Index == other.m_Index && m_Generation == other.m_Generation; }
+		bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+
+		uint32_t m_Index;
+		uint32_t m_Generation;
+	};
+
+	// Values packed in a dense array (for iterating), found through stable handles
+	// Insert and Remove are O(1): removing moves the last value into the hole,
+	// so the dense order changes, but every handle keeps pointing at its value.
+	// Same slot/dense indirection as the TransformStore, for a single array.
+	template <typename T>
+	class SlotMap
+	{
+	public:
+		SlotMap() :
+			m_FreeHead(NoSlot)
+		{
+		}
+
+		SlotHandle Insert(const T& value)
+		{
+			uint32_t slot;
+			if (m_FreeHead != NoSlot)
+			{
+				// Reuse a slot, its generation was already bumped by Remove
+				slot = m_FreeHead;
+				m_FreeHead = m_Slots[slot].m_Dense;
+			}
+			else
+			{
+				slot = static_cast<uint32_t>(m_Slots.size());
+				m_Slots.emplace_back(Slot{ 0, 1 });
+			}
+
+			m_Slots[slot].m_Dense = static_cast<uint32_t>(m_Values.size());
+			m_Values.emplace_back(value);
+			m_DenseToSlot.emplace_back(slot);
+			return SlotHandle(slot, m_Slots[slot].m_Generation);
+		}
+
+		// Returns false if the handle was stale
+		bool Remove(SlotHandle handle)
+		{
+			if (!Contains(handle))
+			{
+				return false;
+			}
+
+			// Move the last value into the hole
+			uint32_t dense = m_Slots[handle.m_Index].m_Dense;
+			uint32_t last = static_cast<uint32_t>(m_Values.size() - 1);
+			if (dense != last)
+			{
+				m_Values[dense] = m_Values[last];
+				m_DenseToSlot[dense] = m_DenseToSlot[last];
+				m_Slots[m_DenseToSlot[dense]].m_Dense = dense;
+			}
+			m_Values.pop_back();
+			m_DenseToSlot.pop_back();
+
+			// Invalidate outstanding handles (skipping 0, which means "not set")
+			Slot& slot = m_Slots[handle.m_Index];
+			slot.m_Generation = slot.m_Generation + 1 != 0 ? slot.m_Generation + 1 : 1;
+			slot.m_Dense = m_FreeHead;
+			m_FreeHead = handle.m_Index;
+			return true;
+		}
+
+		bool Contains(SlotHandle handle) const
+		{
+			return handle.m_Index < m_Slots.size() && handle.m_Generation != 0 &&
+				m_Slots[handle.m_Index].m_Generation == handle.m_Generation;
+		}
+
+		// nullptr if the handle is stale
+		T* Get(SlotHandle handle)
+		{
+			return Contains(handle) ? &m_Values[m_Slots[handle.m_Index].m_Dense] : nullptr;
+		}
+		const T* Get(SlotHandle handle) const
+		{
+			return Contains(handle) ? &m_Values[m_Slots[handle.m_Index].m_Dense] : nullptr;
+		}
+
+		// Handle of the value at a dense index
+		SlotHandle GetHandle(size_t dense) const
+		{
+			uint32_t slot = m_DenseToSlot[dense];
+			return SlotHandle(slot, m_Slots[slot].m_Generation);
+		}
+
+		void Clear()
+		{
+			// Every live slot goes to the free list with a new generation
+			for (size_t i = 0; i < m_DenseToSlot.size(); i++)
+			{
+				Slot& slot = m_Slots[m_DenseToSlot[i]];
+				slot.m_Generation = slot.m_Generation + 1 != 0 ? slot.m_Generation + 1 : 1;
+				slot.m_Dense = m_FreeHead;
+				m_FreeHead = m_DenseToSlot[i];
+			}
+			m_Values.clear();
+			m_DenseToSlot.clear();
+		}
+
+		// Dense access, in no particular order
+		size_t size() const { return m_Values.size(); }
+		bool empty() const { return m_Values.empty(); }
+		T& operator[](size_t dense) { return m_Values[dense]; }
+		const T& operator[](size_t dense) const { return m_Values[dense]; }
+		T& back() { return m_Values.back(); }
+		typename std::vector<T>::iterator begin() { return m_Values.begin(); }
+		typename std::vector<T>::iterator end() { return m_Values.end(); }
+		typename std::vector<T>::const_iterator begin() const { return m_Values.begin(); }
+		typename std::vector<T>::const_iterator end() const { return m_Values.end(); }
+	private:
+		static const uint32_t NoSlot = 0xffffffff;
+
+		struct Slot
+		{
+			// Dense index while in use, next free slot while free
+			uint32_t m_Dense;
+			uint32_t m_Generation;
+		};
+
+		std::vector<T> m_Values;
+		std::vector<uint32_t> m_DenseToSlot;
+		std::vector<Slot> m_Slots;
+		uint32_t m_FreeHead;
+	};
+}
@@ -0,0 +1,285 @@
+#include "SpatialHash.h"
+#include "CircleComponent.h"
+
+namespace Engine
+{
+	// Circle not in m_Entries yet
+	static const unsigned int NoEntry = 0xFFFFFFFF;
+
+	SpatialHash::SpatialHash(float cellSize)
+		:m_CellSize(cellSize)
+		, m_InvCellSize(1.0f / cellSize)
+		, m_BucketMask(0)
+		, m_MinX(0.0f)
+		, m_MinY(0.0f)
+		, m_MaxX(0.0f)
+		, m_MaxY(0.0f)
+		, m_MaxRadius(0.0f)
+		, m_Dirty(true)
+	{
+	}
+
+	void SpatialHash::SetCellSize(float cellSize)
+	{
+		m_CellSize = cellSize;
+		m_InvCellSize = 1.0f / cellSize;
+		m_Dirty = true;
+	}
+
+	void SpatialHash::Add(CircleComponent* circle)
+	{
+		circle->SetHashIndex(static_cast<int>(m_Circles.size()));
+		m_Circles.emplace_back(circle);
+		m_CircleEntry.emplace_back(NoEntry);
+	}
+
+	void SpatialHash::Remove(CircleComponent* circle)
+	{
+		int index = circle->GetHashIndex();
+
+		// Its entry stays where it is, but with no layer no query matches it
+		unsigned int entry = m_CircleEntry[index];
+		if (entry != NoEntry)
+		{
+			m_Entries[entry].m_Layer = 0;
+			m_Entries[entry].m_Circle = nullptr;
+		}
+
+		// Swap to end of vector and pop off (avoid erase copies)
+		m_Circles[index] = m_Circles.back();
+		m_Circles[index]->SetHashIndex(index);
+		m_Circles.pop_back();
+		m_CircleEntry[index] = m_CircleEntry.back();
+		m_CircleEntry.pop_back();
+		circle->SetHashIndex(-1);
+	}
+
+	void SpatialHash::Rebuild()
+	{
+		m_Dirty = false;
+
+		// Power of two table, about two buckets per circle
+		const size_t count = m_Circles.size();
+		size_t tableSize = 16;
+		while (tableSize < count * 2)
+		{
+			tableSize *= 2;
+		}
+		m_BucketMask = tableSize - 1;
+
+		// Count the circles in each bucket
+		m_BucketStart.assign(tableSize + 1, 0);
+		m_EntryBucket.resize(count);
+		m_MaxRadius = 0.0f;
+		m_MinX = m_MinY = CustomMath::Infinity;
+		m_MaxX = m_MaxY = CustomMath::NegInfinity;
+		for (size_t i = 0; i < count; i++)
+		{
+			const Vector3& center = m_Circles[i]->GetCenter();
+			unsigned int bucket = static_cast<unsigned int>(Bucket(CellCoord(center.x), CellCoord(center.y)));
+			m_EntryBucket[i] = bucket;
+			m_BucketStart[bucket]++;
+
+			m_MaxRadius = CustomMath::Max(m_MaxRadius, m_Circles[i]->GetRadius());
+			m_MinX = CustomMath::Min(m_MinX, center.x);
+			m_MinY = CustomMath::Min(m_MinY, center.y);
+			m_MaxX = CustomMath::Max(m_MaxX, center.x);
+			m_MaxY = CustomMath::Max(m_MaxY, center.y);
+		}
+
+		// Turn the counts into start offsets
+		unsigned int offset = 0;
+		for (size_t b = 0; b <= tableSize; b++)
+		{
+			unsigned int bucketCount = m_BucketStart[b];
+			m_BucketStart[b] = offset;
+			offset += bucketCount;
+		}
+
+		// Copy each circle into its bucket's range
+		m_BucketCursor.assign(m_BucketStart.begin(), m_BucketStart.end() - 1);
+		m_Entries.resize(count);
+		m_CircleEntry.resize(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			CircleComponent* circle = m_Circles[i];
+			m_CircleEntry[i] = m_BucketCursor[m_EntryBucket[i]]++;
+			Entry& entry = m_Entries[m_CircleEntry[i]];
+			entry.m_Center = circle->GetCenter();
+			entry.m_Radius = circle->GetRadius();
+			entry.m_Layer = circle->GetLayer();
+			entry.m_CellX = CellCoord(entry.m_Center.x);
+			entry.m_CellY = CellCoord(entry.m_Center.y);
+			entry.m_Circle = circle;
+		}
+	}
+
+	template <typename Func>
+	void SpatialHash::ForEachInArea(float minX, float minY, float maxX, float maxY, Func f)
+	{
+		// Nothing can be outside the bounds of the centers
+		minX = CustomMath::Max(minX, m_MinX);
+		minY = CustomMath::Max(minY, m_MinY);
+		maxX = CustomMath::Min(maxX, m_MaxX);
+		maxY = CustomMath::Min(maxY, m_MaxY);
+		if (minX > maxX || minY > maxY)
+		{
+			return;
+		}
+
+		int x0 = CellCoord(minX);
+		int y0 = CellCoord(minY);
+		int x1 = CellCoord(maxX);
+		int y1 = CellCoord(maxY);
+
+		// Covering more cells than there are circles, just look at all of them
+		double cellCount = (static_cast<double>(x1) - x0 + 1.0) * (static_cast<double>(y1) - y0 + 1.0);
+		if (cellCount > static_cast<double>(m_Entries.size()))
+		{
+			for (size_t i = 0; i < m_Entries.size(); i++)
+			{
+				f(i);
+			}
+			return;
+		}
+
+		for (int y = y0; y <= y1; y++)
+		{
+			for (int x = x0; x <= x1; x++)
+			{
+				size_t bucket = Bucket(x, y);
+				for (size_t i = m_BucketStart[bucket]; i < m_BucketStart[bucket + 1]; i++)
+				{
+					// Other cells can hash to the same bucket
+					if (m_Entries[i].m_CellX == x && m_Entries[i].m_CellY == y)
+					{
+						f(i);
+					}
+				}
+			}
+		}
+	}
+
+	void SpatialHash::QueryRadius(const Vector3& center, float radius, unsigned int layerMask,
+		std::vector<CircleComponent*>& outCircles)
+	{
+		EnsureBuilt();
+		outCircles.clear();
+
+		float reach = radius + m_MaxRadius;
+		ForEachInArea(center.x - reach, center.y - reach, center.x + reach, center.y + reach,
+			[&](size_t i)
+			{
+				const Entry& entry = m_Entries[i];
+				if (!(entry.m_Layer & layerMask))
+				{
+					return;
+				}
+				// Same test as CircleComponent::Intersect
+				float radii = radius + entry.m_Radius;
+				if ((entry.m_Center - center).LengthSq() <= radii * radii)
+				{
+					outCircles.emplace_back(entry.m_Circle);
+				}
+			});
+	}
+
+	CircleComponent* SpatialHash::QueryNearest(const Vector3& pos, float maxDist, unsigned int layerMask,
+		const CircleComponent* ignore)
+	{
+		EnsureBuilt();
+		if (m_Entries.empty())
+		{
+			return nullptr;
+		}
+
+		CircleComponent* nearest = nullptr;
+		float nearestDistSq = maxDist * maxDist;
+		// Search a growing square around pos, until the nearest circle found
+		// is closer than anything outside the square could be
+		float searchDist = m_CellSize;
+		while (true)
+		{
+			searchDist = CustomMath::Min(searchDist, maxDist);
+			ForEachInArea(pos.x - searchDist, pos.y - searchDist, pos.x + searchDist, pos.y + searchDist,
+				[&](size_t i)
+				{
+					const Entry& entry = m_Entries[i];
+					if (!(entry.m_Layer & layerMask) || entry.m_Circle == ignore)
+					{
+						return;
+					}
+					float distSq = (entry.m_Center - pos).LengthSq();
+					if (distSq <= nearestDistSq)
+					{
+						nearestDistSq = distSq;
+						nearest = entry.m_Circle;
+					}
+				});
+
+			bool coversAll = pos.x - searchDist <= m_MinX && pos.y - searchDist <= m_MinY &&
+				pos.x + searchDist >= m_MaxX && pos.y + searchDist >= m_MaxY;
+			if ((nearest && nearestDistSq <= searchDist * searchDist) ||
+				searchDist >= maxDist || coversAll)
+			{
+				break;
+			}
+			searchDist *= 2.0f;
+		}
+		return nearest;
+	}
+
+	void SpatialHash::QueryOverlaps(unsigned int layerA, unsigned int layerB,
+		std::vector<std::pair<CircleComponent*, CircleComponent*>>& outPairs)
+	{
+		EnsureBuilt();
+		outPairs.clear();
+
+		for (size_t i = 0; i < m_Entries.size(); i++)
+		{
+			const Entry& a = m_Entries[i];
+			if (!(a.m_Layer & layerA))
+			{
+				continue;
+			}
+
+			float reach = a.m_Radius + m_MaxRadius;
+			ForEachInArea(a.m_Center.x - reach, a.m_Center.y - reach, a.m_Center.x + reach, a.m_Center.y + reach,
+				[&](size_t j)
+				{
+					const Entry& b = m_Entries[j];
+					if (j == i || !(b.m_Layer & layerB))
+					{
+						return;
+					}
+					// If the pair also matches the other way around,
+					// only report it from the lower index
+					if ((b.m_Layer & layerA) && (a.m_Layer & layerB) && j < i)
+					{
+						return;
+					}
+					float radii = a.m_Radius + b.m_Radius;
+					if ((a.m_Center - b.m_Center).LengthSq() <= radii * radii)
+					{
+						outPairs.emplace_back(a.m_Circle, b.m_Circle);
+					}
+				});
+		}
+	}
+
+	size_t SpatialHash::Bucket(int cellX, int cellY) const
+	{
+		// Large primes to spread neighbouring cells over the table
+		unsigned int h = (static_cast<unsigned int>(cellX) * 73856093u) ^
+			(static_cast<unsigned int>(cellY) * 19349663u);
+		return h & m_BucketMask;
+	}
+
+	void SpatialHash::EnsureBuilt()
+	{
+		if (m_Dirty)
+		{
+			Rebuild();
+		}
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include "CustomMath.h"
+
+namespace Engine
+{
+	// Uniform grid over the x/y plane for CircleComponent queries
+	// Cells are hashed into a flat table that is rebuilt once per frame with
+	// a counting sort, so each bucket's circles sit next to each other in memory.
+	// Queries look at the cells around the query area (grown by the biggest
+	// radius in the grid, so circles larger than a cell are still found).
+	class SpatialHash
+	{
+	public:
+		SpatialHash(float cellSize);
+
+		void SetCellSize(float cellSize);
+		float GetCellSize() const { return m_CellSize; }
+
+		// Register/unregister circles (done by CircleComponent)
+		void Add(class CircleComponent* circle);
+		void Remove(class CircleComponent* circle);
+
+		// Put every circle in its current cell (once per frame)
+		// Queries see positions as of the last rebuild, and circles added
+		// since then show up after the next one (removed ones are gone right away)
+		void Rebuild();
+
+		// Circles (in layerMask) overlapping the circle at center with radius
+		void QueryRadius(const Vector3& center, float radius, unsigned int layerMask,
+			std::vector<class CircleComponent*>& outCircles);
+		// Circle (in layerMask) whose center is nearest to pos, within maxDist
+		// Returns nullptr if there isn't one
+		class CircleComponent* QueryNearest(const Vector3& pos, float maxDist, unsigned int layerMask,
+			const class CircleComponent* ignore = nullptr);
+		// Every overlapping pair with one circle in layerA and the other in layerB
+		void QueryOverlaps(unsigned int layerA, unsigned int layerB,
+			std::vector<std::pair<class CircleComponent*, class CircleComponent*>>& outPairs);
+	private:
+		struct Entry
+		{
+			Vector3 m_Center;
+			float m_Radius;
+			unsigned int m_Layer;
+			int m_CellX;
+			int m_CellY;
+			class CircleComponent* m_Circle;
+		};
+
+		int CellCoord(float value) const { return static_cast<int>(std::floor(value * m_InvCellSize)); }
+		size_t Bucket(int cellX, int cellY) const;
+		// Rebuild if there's nothing built yet (or the cell size changed)
+		void EnsureBuilt();
+		// Calls f(entryIndex) for every entry in the cells touching [min, max]
+		template <typename Func>
+		void ForEachInArea(float minX, float minY, float maxX, float maxY, Func f);
+
+		float m_CellSize;
+		float m_InvCellSize;
+
+		// Registered circles (CircleComponent keeps its index for removal)
+		std::vector<class CircleComponent*> m_Circles;
+		// Entry of each registered circle, NoEntry if it was added after the last rebuild
+		std::vector<unsigned int> m_CircleEntry;
+
+		// Entries sorted by bucket, bucket b is [m_BucketStart[b], m_BucketStart[b + 1])
+		std::vector<Entry> m_Entries;
+		std::vector<unsigned int> m_BucketStart;
+		size_t m_BucketMask;
+		// Scratch for the counting sort (bucket of each circle, write position of each bucket)
+		std::vector<unsigned int> m_EntryBucket;
+		std::vector<unsigned int> m_BucketCursor;
+		// Bounds of all the centers, and the biggest radius
+		float m_MinX, m_MinY, m_MaxX, m_MaxY;
+		float m_MaxRadius;
+		bool m_Dirty;
+	};
+}
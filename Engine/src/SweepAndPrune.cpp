@@ -0,0 +1,358 @@
+#include "SweepAndPrune.h"
+#include <utility>
+#include <algorithm>
+
+namespace Engine
+{
+	// Endpoint owner once its proxy is removed
+	static const int DeadProxy = -1;
+
+	SweepAndPrune::SweepAndPrune() :
+		m_DeadEndpoints(0)
+	{
+	}
+
+	int SweepAndPrune::AddProxy(const AABB& box, void* userData)
+	{
+		int proxyId;
+		if (!m_FreeProxies.empty())
+		{
+			proxyId = m_FreeProxies.back();
+			m_FreeProxies.pop_back();
+		}
+		else
+		{
+			proxyId = static_cast<int>(m_Proxies.size());
+			m_Proxies.emplace_back();
+		}
+		m_Proxies[proxyId].m_UserData = userData;
+
+		// Add the endpoints at the end of each axis and sort them into place
+		const float* boxMin = &box.m_Min.x;
+		const float* boxMax = &box.m_Max.x;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			std::vector<Endpoint>& endpoints = m_Endpoints[axis];
+			int index = static_cast<int>(endpoints.size());
+			endpoints.emplace_back(Endpoint{ boxMin[axis], proxyId, false });
+			endpoints.emplace_back(Endpoint{ boxMax[axis], proxyId, true });
+			m_Proxies[proxyId].m_Min[axis] = index;
+			m_Proxies[proxyId].m_Max[axis] = index + 1;
+
+			// Only the last axis needs to look for pairs,
+			// by then the other two are already in their final order
+			bool updatePairs = axis == 2;
+			SortMinDown(axis, m_Proxies[proxyId].m_Min[axis], updatePairs);
+			SortMaxDown(axis, m_Proxies[proxyId].m_Max[axis], updatePairs);
+		}
+
+		return proxyId;
+	}
+
+	void SweepAndPrune::RemoveProxy(int proxyId)
+	{
+		// Drop every pair with this proxy
+		// (the owner is going away, so nobody should get an end event for it)
+		Proxy& proxy = m_Proxies[proxyId];
+		while (!proxy.m_Paired.empty())
+		{
+			int other = proxy.m_Paired.back();
+			m_Pairs.erase(PairKey(proxyId, other));
+			UnlinkPair(proxyId, other);
+		}
+
+		// Leave the endpoints where they are (still in order) until the next compact
+		for (int axis = 0; axis < 3; axis++)
+		{
+			m_Endpoints[axis][proxy.m_Min[axis]].m_Proxy = DeadProxy;
+			m_Endpoints[axis][proxy.m_Max[axis]].m_Proxy = DeadProxy;
+		}
+		m_DeadEndpoints += 2;
+
+		proxy.m_UserData = nullptr;
+		m_FreeProxies.emplace_back(proxyId);
+	}
+
+	void SweepAndPrune::MoveProxy(int proxyId, const AABB& box)
+	{
+		const float* boxMin = &box.m_Min.x;
+		const float* boxMax = &box.m_Max.x;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			std::vector<Endpoint>& endpoints = m_Endpoints[axis];
+			Proxy& proxy = m_Proxies[proxyId];
+			Endpoint& minPoint = endpoints[proxy.m_Min[axis]];
+			Endpoint& maxPoint = endpoints[proxy.m_Max[axis]];
+			float oldMin = minPoint.m_Value;
+			float oldMax = maxPoint.m_Value;
+			minPoint.m_Value = boxMin[axis];
+			maxPoint.m_Value = boxMax[axis];
+
+			// Grow first, then shrink, so the min never has to pass its own max
+			if (boxMin[axis] < oldMin)
+			{
+				SortMinDown(axis, proxy.m_Min[axis], true);
+			}
+			if (boxMax[axis] > oldMax)
+			{
+				SortMaxUp(axis, proxy.m_Max[axis], true);
+			}
+			if (boxMin[axis] > oldMin)
+			{
+				SortMinUp(axis, proxy.m_Min[axis], true);
+			}
+			if (boxMax[axis] < oldMax)
+			{
+				SortMaxDown(axis, proxy.m_Max[axis], true);
+			}
+		}
+	}
+
+	void SweepAndPrune::UpdatePairs(std::vector<OverlapEvent>& outEvents)
+	{
+		outEvents.clear();
+		auto iter = m_Pairs.begin();
+		while (iter != m_Pairs.end())
+		{
+			Pair& pair = iter->second;
+			if (pair.m_Removed)
+			{
+				outEvents.emplace_back(OverlapEvent{ OverlapEvent::EEnd, pair.m_ProxyA, pair.m_ProxyB });
+				UnlinkPair(pair.m_ProxyA, pair.m_ProxyB);
+				iter = m_Pairs.erase(iter);
+				continue;
+			}
+
+			if (pair.m_New)
+			{
+				outEvents.emplace_back(OverlapEvent{ OverlapEvent::EBegin, pair.m_ProxyA, pair.m_ProxyB });
+				pair.m_New = false;
+			}
+			else
+			{
+				outEvents.emplace_back(OverlapEvent{ OverlapEvent::EStay, pair.m_ProxyA, pair.m_ProxyB });
+			}
+			++iter;
+		}
+
+		// Dead endpoints only cost a few extra swaps, so let them pile up to a
+		// quarter of the list (keeps each removal O(1) on average)
+		if (m_DeadEndpoints * 4 > static_cast<int>(m_Endpoints[0].size()))
+		{
+			CompactEndpoints();
+		}
+	}
+
+	void SweepAndPrune::CompactEndpoints()
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			std::vector<Endpoint>& endpoints = m_Endpoints[axis];
+			endpoints.erase(std::remove_if(endpoints.begin(), endpoints.end(),
+				[](const Endpoint& endpoint)
+				{
+					return endpoint.m_Proxy == DeadProxy;
+				}), endpoints.end());
+			for (int i = 0; i < static_cast<int>(endpoints.size()); i++)
+			{
+				Proxy& proxy = m_Proxies[endpoints[i].m_Proxy];
+				if (endpoints[i].m_IsMax)
+				{
+					proxy.m_Max[axis] = i;
+				}
+				else
+				{
+					proxy.m_Min[axis] = i;
+				}
+			}
+		}
+		m_DeadEndpoints = 0;
+	}
+
+	void SweepAndPrune::SortMinDown(int axis, int index, bool updatePairs)
+	{
+		std::vector<Endpoint>& endpoints = m_Endpoints[axis];
+		while (index > 0 && endpoints[index - 1].m_Value > endpoints[index].m_Value)
+		{
+			// Min moving left past a max: overlap starts on this axis
+			const Endpoint& prev = endpoints[index - 1];
+			if (updatePairs && prev.m_IsMax && prev.m_Proxy != DeadProxy)
+			{
+				int proxy = endpoints[index].m_Proxy;
+				if (TestOverlapOtherAxes(proxy, prev.m_Proxy, axis))
+				{
+					AddPair(proxy, prev.m_Proxy);
+				}
+			}
+			SwapEndpoints(axis, index - 1, index);
+			index--;
+		}
+	}
+
+	void SweepAndPrune::SortMinUp(int axis, int index, bool updatePairs)
+	{
+		std::vector<Endpoint>& endpoints = m_Endpoints[axis];
+		int last = static_cast<int>(endpoints.size()) - 1;
+		while (index < last && endpoints[index + 1].m_Value < endpoints[index].m_Value)
+		{
+			// Min moving right past a max: overlap ends on this axis
+			const Endpoint& next = endpoints[index + 1];
+			if (updatePairs && next.m_IsMax && next.m_Proxy != DeadProxy)
+			{
+				RemovePair(endpoints[index].m_Proxy, next.m_Proxy);
+			}
+			SwapEndpoints(axis, index, index + 1);
+			index++;
+		}
+	}
+
+	void SweepAndPrune::SortMaxDown(int axis, int index, bool updatePairs)
+	{
+		std::vector<Endpoint>& endpoints = m_Endpoints[axis];
+		while (index > 0 && endpoints[index - 1].m_Value > endpoints[index].m_Value)
+		{
+			// Max moving left past a min: overlap ends on this axis
+			const Endpoint& prev = endpoints[index - 1];
+			if (updatePairs && !prev.m_IsMax && prev.m_Proxy != DeadProxy)
+			{
+				RemovePair(endpoints[index].m_Proxy, prev.m_Proxy);
+			}
+			SwapEndpoints(axis, index - 1, index);
+			index--;
+		}
+	}
+
+	void SweepAndPrune::SortMaxUp(int axis, int index, bool updatePairs)
+	{
+		std::vector<Endpoint>& endpoints = m_Endpoints[axis];
+		int last = static_cast<int>(endpoints.size()) - 1;
+		while (index < last && endpoints[index + 1].m_Value < endpoints[index].m_Value)
+		{
+			// Max moving right past a min: overlap starts on this axis
+			const Endpoint& next = endpoints[index + 1];
+			if (updatePairs && !next.m_IsMax && next.m_Proxy != DeadProxy)
+			{
+				int proxy = endpoints[index].m_Proxy;
+				if (TestOverlapOtherAxes(proxy, next.m_Proxy, axis))
+				{
+					AddPair(proxy, next.m_Proxy);
+				}
+			}
+			SwapEndpoints(axis, index, index + 1);
+			index++;
+		}
+	}
+
+	void SweepAndPrune::SwapEndpoints(int axis, int a, int b)
+	{
+		std::vector<Endpoint>& endpoints = m_Endpoints[axis];
+		std::swap(endpoints[a], endpoints[b]);
+
+		// Let both proxies know where their endpoints went (dead ones have no proxy)
+		const int moved[2] = { a, b };
+		for (int index : moved)
+		{
+			const Endpoint& endpoint = endpoints[index];
+			if (endpoint.m_Proxy == DeadProxy)
+			{
+				continue;
+			}
+			Proxy& proxy = m_Proxies[endpoint.m_Proxy];
+			if (endpoint.m_IsMax)
+			{
+				proxy.m_Max[axis] = index;
+			}
+			else
+			{
+				proxy.m_Min[axis] = index;
+			}
+		}
+	}
+
+	bool SweepAndPrune::TestOverlapOtherAxes(int a, int b, int axis) const
+	{
+		// Compare endpoint order instead of values,
+		// so touching boxes agree with what the sorted lists say
+		const Proxy& proxyA = m_Proxies[a];
+		const Proxy& proxyB = m_Proxies[b];
+		for (int i = 0; i < 3; i++)
+		{
+			if (i == axis)
+			{
+				continue;
+			}
+			if (proxyA.m_Max[i] < proxyB.m_Min[i] || proxyB.m_Max[i] < proxyA.m_Min[i])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void SweepAndPrune::AddPair(int a, int b)
+	{
+		if (a == b)
+		{
+			return;
+		}
+
+		auto iter = m_Pairs.find(PairKey(a, b));
+		if (iter != m_Pairs.end())
+		{
+			// Ended and began again since the last update, so it just stays
+			iter->second.m_Removed = false;
+		}
+		else
+		{
+			Pair pair;
+			pair.m_ProxyA = a < b ? a : b;
+			pair.m_ProxyB = a < b ? b : a;
+			pair.m_New = true;
+			pair.m_Removed = false;
+			m_Pairs.emplace(PairKey(a, b), pair);
+			m_Proxies[a].m_Paired.emplace_back(b);
+			m_Proxies[b].m_Paired.emplace_back(a);
+		}
+	}
+
+	void SweepAndPrune::RemovePair(int a, int b)
+	{
+		auto iter = m_Pairs.find(PairKey(a, b));
+		if (iter == m_Pairs.end())
+		{
+			return;
+		}
+
+		// Began and ended since the last update, nobody needs to hear about it
+		if (iter->second.m_New)
+		{
+			m_Pairs.erase(iter);
+			UnlinkPair(a, b);
+		}
+		else
+		{
+			iter->second.m_Removed = true;
+		}
+	}
+
+	void SweepAndPrune::UnlinkPair(int a, int b)
+	{
+		// Swap with the last one and pop, order doesn't matter
+		std::vector<int>& pairedA = m_Proxies[a].m_Paired;
+		auto iterA = std::find(pairedA.begin(), pairedA.end(), b);
+		*iterA = pairedA.back();
+		pairedA.pop_back();
+
+		std::vector<int>& pairedB = m_Proxies[b].m_Paired;
+		auto iterB = std::find(pairedB.begin(), pairedB.end(), a);
+		*iterB = pairedB.back();
+		pairedB.pop_back();
+	}
+
+	uint64_t SweepAndPrune::PairKey(int a, int b)
+	{
+		uint32_t lo = static_cast<uint32_t>(a < b ? a : b);
+		uint32_t hi = static_cast<uint32_t>(a < b ? b : a);
+		return (static_cast<uint64_t>(lo) << 32) | hi;
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "Collision.h"
+
+namespace Engine
+{
+	// Persistent sweep and prune broadphase on all three axes
+	// Every axis keeps a sorted list of box endpoints that survives between
+	// frames. Moving a box only shifts its endpoints with insertion sort
+	// (few swaps, since boxes move a little each frame), and every swap
+	// of a min past a max starts/stops an overlap on that axis.
+	// Removing a box only marks its endpoints dead (they stay sorted where
+	// they are), and UpdatePairs squeezes them out once enough pile up.
+	class SweepAndPrune
+	{
+	public:
+		struct OverlapEvent
+		{
+			enum Type
+			{
+				EBegin,
+				EStay,
+				EEnd
+			};
+
+			Type m_Type;
+			int m_ProxyA;
+			int m_ProxyB;
+		};
+
+		SweepAndPrune();
+
+		// Add/remove a box, userData is handed back by GetUserData
+		// Removing a proxy drops its pairs without end events
+		int AddProxy(const AABB& box, void* userData);
+		void RemoveProxy(int proxyId);
+		// Update the box of a proxy (its pairs are updated right away)
+		void MoveProxy(int proxyId, const AABB& box);
+
+		void* GetUserData(int proxyId) const { return m_Proxies[proxyId].m_UserData; }
+
+		// Fill outEvents with the pairs that began, stayed or ended overlapping
+		// since the last call
+		void UpdatePairs(std::vector<OverlapEvent>& outEvents);
+	private:
+		struct Endpoint
+		{
+			float m_Value;
+			// -1 once the proxy is removed
+			int m_Proxy;
+			bool m_IsMax;
+		};
+
+		struct Proxy
+		{
+			// Index of the min/max endpoint on each axis
+			int m_Min[3];
+			int m_Max[3];
+			void* m_UserData;
+			// Other proxy of each of its pairs, so removing it doesn't look at every pair
+			std::vector<int> m_Paired;
+		};
+
+		struct Pair
+		{
+			int m_ProxyA;
+			int m_ProxyB;
+			// Began overlapping since the last UpdatePairs
+			bool m_New;
+			// Stopped overlapping since the last UpdatePairs
+			bool m_Removed;
+		};
+
+		// Move one endpoint along an axis until it is sorted again
+		void SortMinDown(int axis, int index, bool updatePairs);
+		void SortMinUp(int axis, int index, bool updatePairs);
+		void SortMaxDown(int axis, int index, bool updatePairs);
+		void SortMaxUp(int axis, int index, bool updatePairs);
+		void SwapEndpoints(int axis, int a, int b);
+
+		// Overlap of the sorted intervals on the two other axes
+		bool TestOverlapOtherAxes(int a, int b, int axis) const;
+
+		void AddPair(int a, int b);
+		void RemovePair(int a, int b);
+		// Forget the pair in both proxies' m_Paired (it's being erased from m_Pairs)
+		void UnlinkPair(int a, int b);
+		// Drop the dead endpoints and fix the indices of the rest
+		void CompactEndpoints();
+		static uint64_t PairKey(int a, int b);
+
+		std::vector<Endpoint> m_Endpoints[3];
+		std::vector<Proxy> m_Proxies;
+		std::vector<int> m_FreeProxies;
+		// Dead endpoints on each axis (two per removed proxy)
+		int m_DeadEndpoints;
+		std::unordered_map<uint64_t, Pair> m_Pairs;
+	};
+}
@@ -0,0 +1,212 @@
+#include "TransformStore.h"
+#include "Actor.h"
+
+namespace Engine
+{
+	TransformStore::TransformStore()
+	{
+	}
+
+	TransformHandle TransformStore::Add(Actor* owner)
+	{
+		// Reuse a free handle if there is one
+		TransformHandle handle;
+		if (!m_FreeSlots.empty())
+		{
+			handle = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+		}
+		else
+		{
+			handle = static_cast<TransformHandle>(m_SlotToDense.size());
+			m_SlotToDense.emplace_back(0);
+		}
+
+		// New entries always go at the end of the dense arrays
+		m_SlotToDense[handle] = static_cast<unsigned int>(m_Positions.size());
+		m_Positions.emplace_back(Vector3::Zero);
+		m_Rotations.emplace_back(Quaternion::Identity);
+		m_Scales.emplace_back(1.0f);
+		m_Dirty.emplace_back(1);
+		m_WorldTransforms.emplace_back(Matrix4::Identity);
+		m_PrevPositions.emplace_back(Vector3::Zero);
+		m_PrevRotations.emplace_back(Quaternion::Identity);
+		m_PrevScales.emplace_back(1.0f);
+		m_HasPrev.emplace_back(0);
+		m_RenderTransforms.emplace_back(Matrix4::Identity);
+		m_Owners.emplace_back(owner);
+		m_DenseToSlot.emplace_back(handle);
+		m_MovedIndex.emplace_back(-1);
+		// Drawn where it is until it has been through a step
+		MarkMoved(m_SlotToDense[handle]);
+
+		return handle;
+	}
+
+	void TransformStore::Remove(TransformHandle handle)
+	{
+		unsigned int i = m_SlotToDense[handle];
+		unsigned int last = static_cast<unsigned int>(m_Positions.size()) - 1;
+
+		// Take it out of the moved list (swapping the list's last one into its spot)
+		int moved = m_MovedIndex[i];
+		if (moved >= 0)
+		{
+			m_Moved[moved] = m_Moved.back();
+			m_MovedIndex[m_Moved[moved]] = moved;
+			m_Moved.pop_back();
+			m_MovedIndex[i] = -1;
+		}
+
+		// Move the last entry into the hole (avoid erase copies)
+		if (i != last)
+		{
+			m_Positions[i] = m_Positions[last];
+			m_Rotations[i] = m_Rotations[last];
+			m_Scales[i] = m_Scales[last];
+			m_Dirty[i] = m_Dirty[last];
+			m_WorldTransforms[i] = m_WorldTransforms[last];
+			m_PrevPositions[i] = m_PrevPositions[last];
+			m_PrevRotations[i] = m_PrevRotations[last];
+			m_PrevScales[i] = m_PrevScales[last];
+			m_HasPrev[i] = m_HasPrev[last];
+			m_RenderTransforms[i] = m_RenderTransforms[last];
+			m_Owners[i] = m_Owners[last];
+			m_DenseToSlot[i] = m_DenseToSlot[last];
+			m_SlotToDense[m_DenseToSlot[i]] = i;
+			m_MovedIndex[i] = m_MovedIndex[last];
+			if (m_MovedIndex[i] >= 0)
+			{
+				m_Moved[m_MovedIndex[i]] = i;
+			}
+		}
+
+		m_Positions.pop_back();
+		m_Rotations.pop_back();
+		m_Scales.pop_back();
+		m_Dirty.pop_back();
+		m_WorldTransforms.pop_back();
+		m_PrevPositions.pop_back();
+		m_PrevRotations.pop_back();
+		m_PrevScales.pop_back();
+		m_HasPrev.pop_back();
+		m_RenderTransforms.pop_back();
+		m_Owners.pop_back();
+		m_DenseToSlot.pop_back();
+		m_MovedIndex.pop_back();
+
+		m_FreeSlots.emplace_back(handle);
+	}
+
+	bool TransformStore::ComputeWorldTransform(TransformHandle handle)
+	{
+		unsigned int i = m_SlotToDense[handle];
+		if (m_Dirty[i])
+		{
+			m_Dirty[i] = 0;
+			Compose(m_Positions[i], m_Rotations[i], m_Scales[i], m_WorldTransforms[i]);
+			MarkMoved(i);
+			return true;
+		}
+		return false;
+	}
+
+	void TransformStore::ComputeWorldTransforms()
+	{
+		// First pass only touches the transform arrays
+		m_Recomputed.clear();
+		const size_t count = m_Positions.size();
+		for (size_t i = 0; i < count; i++)
+		{
+			if (m_Dirty[i])
+			{
+				m_Dirty[i] = 0;
+				Compose(m_Positions[i], m_Rotations[i], m_Scales[i], m_WorldTransforms[i]);
+				m_Recomputed.emplace_back(static_cast<unsigned int>(i));
+				MarkMoved(static_cast<unsigned int>(i));
+			}
+		}
+
+		// Second pass lets components (like BoxComponent) react
+		for (unsigned int i : m_Recomputed)
+		{
+			m_Owners[i]->OnWorldTransformUpdated();
+		}
+	}
+
+	void TransformStore::SavePreviousState()
+	{
+		// Entries that didn't move already have previous == current,
+		// and their render transform is their world transform
+		for (unsigned int i : m_Moved)
+		{
+			m_PrevPositions[i] = m_Positions[i];
+			m_PrevRotations[i] = m_Rotations[i];
+			m_PrevScales[i] = m_Scales[i];
+			m_HasPrev[i] = 1;
+			// Done blending, so it rests at where the step left it
+			m_RenderTransforms[i] = m_WorldTransforms[i];
+			m_MovedIndex[i] = -1;
+		}
+		m_Moved.clear();
+	}
+
+	void TransformStore::ComputeRenderTransforms(float alpha)
+	{
+		for (unsigned int i : m_Moved)
+		{
+			// Created since the last step, just draw it where it is
+			if (!m_HasPrev[i])
+			{
+				Compose(m_Positions[i], m_Rotations[i], m_Scales[i], m_RenderTransforms[i]);
+				continue;
+			}
+
+			Vector3 pos = Vector3::Lerp(m_PrevPositions[i], m_Positions[i], alpha);
+			float scale = CustomMath::Lerp(m_PrevScales[i], m_Scales[i], alpha);
+			// Blend toward whichever of q/-q is closer, so we take the short way around
+			Quaternion to = m_Rotations[i];
+			if (Quaternion::Dot(m_PrevRotations[i], to) < 0.0f)
+			{
+				to = Quaternion(-to.x, -to.y, -to.z, -to.w);
+			}
+			Quaternion rot = Quaternion::Lerp(m_PrevRotations[i], to, alpha);
+			Compose(pos, rot, scale, m_RenderTransforms[i]);
+		}
+	}
+
+	void TransformStore::MarkMoved(unsigned int i)
+	{
+		if (m_MovedIndex[i] < 0)
+		{
+			m_MovedIndex[i] = static_cast<int>(m_Moved.size());
+			m_Moved.emplace_back(i);
+		}
+	}
+
+	void TransformStore::Compose(const Vector3& pos, const Quaternion& q, float scale, Matrix4& out)
+	{
+		// Same result as CreateScale(scale) * CreateFromQuaternion(q) * CreateTranslation(pos),
+		// but without building and multiplying the intermediate matrices.
+		// The uniform scale multiplies the rotation rows, the translation is the last row
+		out.mat[0][0] = (1.0f - 2.0f * q.y * q.y - 2.0f * q.z * q.z) * scale;
+		out.mat[0][1] = (2.0f * q.x * q.y + 2.0f * q.w * q.z) * scale;
+		out.mat[0][2] = (2.0f * q.x * q.z - 2.0f * q.w * q.y) * scale;
+		out.mat[0][3] = 0.0f;
+
+		out.mat[1][0] = (2.0f * q.x * q.y - 2.0f * q.w * q.z) * scale;
+		out.mat[1][1] = (1.0f - 2.0f * q.x * q.x - 2.0f * q.z * q.z) * scale;
+		out.mat[1][2] = (2.0f * q.y * q.z + 2.0f * q.w * q.x) * scale;
+		out.mat[1][3] = 0.0f;
+
+		out.mat[2][0] = (2.0f * q.x * q.z + 2.0f * q.w * q.y) * scale;
+		out.mat[2][1] = (2.0f * q.y * q.z - 2.0f * q.w * q.x) * scale;
+		out.mat[2][2] = (1.0f - 2.0f * q.x * q.x - 2.0f * q.y * q.y) * scale;
+		out.mat[2][3] = 0.0f;
+
+		out.mat[3][0] = pos.x;
+		out.mat[3][1] = pos.y;
+		out.mat[3][2] = pos.z;
+		out.mat[3][3] = 1.0f;
+	}
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "CustomMath.h"
+
+namespace Engine
+{
+	// Handle to an entry in the TransformStore
+	// Stays valid for the lifetime of the owning actor, even if entries move around
+	typedef unsigned int TransformHandle;
+
+	// Structure-of-arrays storage for every actor transform in the game
+	// Positions, rotations, scales, dirty flags and world matrices are each kept
+	// in their own contiguous array, so the world transform pass is a linear sweep
+	class TransformStore
+	{
+	public:
+		TransformStore();
+
+		// Create/destroy the transform of an actor
+		TransformHandle Add(class Actor* owner);
+		void Remove(TransformHandle handle);
+
+		const Vector3& GetPosition(TransformHandle handle) const { return m_Positions[m_SlotToDense[handle]]; }
+		void SetPosition(TransformHandle handle, const Vector3& pos)
+		{
+			unsigned int i = m_SlotToDense[handle];
+			m_Positions[i] = pos;
+			m_Dirty[i] = 1;
+		}
+		float GetScale(TransformHandle handle) const { return m_Scales[m_SlotToDense[handle]]; }
+		void SetScale(TransformHandle handle, float scale)
+		{
+			unsigned int i = m_SlotToDense[handle];
+			m_Scales[i] = scale;
+			m_Dirty[i] = 1;
+		}
+		const Quaternion& GetRotation(TransformHandle handle) const { return m_Rotations[m_SlotToDense[handle]]; }
+		void SetRotation(TransformHandle handle, const Quaternion& rotation)
+		{
+			unsigned int i = m_SlotToDense[handle];
+			m_Rotations[i] = rotation;
+			m_Dirty[i] = 1;
+		}
+		const Matrix4& GetWorldTransform(TransformHandle handle) const { return m_WorldTransforms[m_SlotToDense[handle]]; }
+		// World transform blended between the last two simulation steps (what gets drawn)
+		const Matrix4& GetRenderTransform(TransformHandle handle) const { return m_RenderTransforms[m_SlotToDense[handle]]; }
+
+		// Recompute a single world transform
+		// Returns true if it was dirty (and so had to be recomputed)
+		bool ComputeWorldTransform(TransformHandle handle);
+		// Recompute every dirty world transform in one sweep,
+		// then let the owning actors know their transform changed
+		void ComputeWorldTransforms();
+
+		// Keep the current state as the previous one (call before each simulation step)
+		// Only touches the entries that moved during the last step, the rest already match
+		void SavePreviousState();
+		// Blend the previous and current state by alpha (0 = previous, 1 = current)
+		// into the render transforms of the entries that moved this step
+		// (everything else already has its world transform as its render transform)
+		void ComputeRenderTransforms(float alpha);
+
+		size_t GetCount() const { return m_Positions.size(); }
+	private:
+		// Builds scale * rotation * translation directly into out
+		static void Compose(const Vector3& pos, const Quaternion& q, float scale, Matrix4& out);
+		// Remember that entry i changed since the last SavePreviousState
+		void MarkMoved(unsigned int i);
+
+		// Dense arrays (index i in each array belongs to the same actor)
+		std::vector<Vector3> m_Positions;
+		std::vector<Quaternion> m_Rotations;
+		std::vector<float> m_Scales;
+		std::vector<uint8_t> m_Dirty;
+		std::vector<Matrix4> m_WorldTransforms;
+		// State as of the start of the last simulation step
+		std::vector<Vector3> m_PrevPositions;
+		std::vector<Quaternion> m_PrevRotations;
+		std::vector<float> m_PrevScales;
+		// 0 until the entry has been through a step (nothing to blend from yet)
+		std::vector<uint8_t> m_HasPrev;
+		std::vector<Matrix4> m_RenderTransforms;
+		std::vector<class Actor*> m_Owners;
+		// Which handle owns each dense entry (needed when swapping on removal)
+		std::vector<TransformHandle> m_DenseToSlot;
+
+		// Handle -> dense index indirection
+		std::vector<unsigned int> m_SlotToDense;
+		std::vector<TransformHandle> m_FreeSlots;
+
+		// Dense indices recomputed by the last sweep
+		std::vector<unsigned int> m_Recomputed;
+		// Dense indices added or recomputed since the last SavePreviousState,
+		// and where each entry is in that list (-1 if it isn't)
+		std::vector<unsigned int> m_Moved;
+		std::vector<int> m_MovedIndex;
+	};
+}
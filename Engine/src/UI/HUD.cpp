@@ -1,6 +1,6 @@
 #include "HUD.h"
 #include "Texture.h"
-#include "Shader.h"
+#include "RenderQueue.h"
 #include "Game.h"
 #include "Renderer.h"
 #include "PhysWorld.h"
@@ -37,37 +37,35 @@ namespace Engine
 		UpdateRadar(deltaTime);
 	}
 
-	void HUD::Draw(Shader* shader)
+	void HUD::Draw(RenderQueue* queue)
 	{
 		// Crosshair
 		Texture* cross = m_TargetEnemy ? m_CrosshairEnemy : m_Crosshair;
-		DrawTexture(shader, cross, Vector2::Zero, 2.0f);
+		DrawTexture(queue, cross, Vector2::Zero, 2.0f);
 
 		// Radar
 		const Vector2 cRadarPos(-390.0f, 275.0f);
-		DrawTexture(shader, m_Radar, cRadarPos, 1.0f);
+		DrawTexture(queue, m_Radar, cRadarPos, 1.0f);
 		// Blips
 		for (Vector2& blip : m_Blips)
 		{
-			DrawTexture(shader, m_BlipTex, cRadarPos + blip, 1.0f);
+			DrawTexture(queue, m_BlipTex, cRadarPos + blip, 1.0f);
 		}
 		// Radar arrow
-		DrawTexture(shader, m_RadarArrow, cRadarPos);
+		DrawTexture(queue, m_RadarArrow, cRadarPos);
 
 		//// Health bar
-		//DrawTexture(shader, mHealthBar, Vector2(-350.0f, -350.0f));
+		//DrawTexture(queue, mHealthBar, Vector2(-350.0f, -350.0f));
 	}
 
-	void HUD::AddTargetComponent(TargetComponent* tc)
+	SlotHandle HUD::AddTargetComponent(TargetComponent* tc)
 	{
-		m_TargetComps.emplace_back(tc);
+		return m_TargetComps.Insert(tc);
 	}
 
-	void HUD::RemoveTargetComponent(TargetComponent* tc)
+	void HUD::RemoveTargetComponent(SlotHandle handle)
 	{
-		auto iter = std::find(m_TargetComps.begin(), m_TargetComps.end(),
-			tc);
-		m_TargetComps.erase(iter);
+		m_TargetComps.Remove(handle);
 	}
 
 	void HUD::UpdateCrosshair(float deltaTime)
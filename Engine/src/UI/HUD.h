@@ -1,6 +1,7 @@
 #pragma once
 #include "UIScreen.h"
 #include <vector>
+#include "SlotMap.h"
 
 namespace Engine
 {
@@ -12,10 +13,10 @@ namespace Engine
 		~HUD();
 
 		void Update(float deltaTime) override;
-		void Draw(class Shader* shader) override;
+		void Draw(class RenderQueue* queue) override;
 
-		void AddTargetComponent(class TargetComponent* tc);
-		void RemoveTargetComponent(class TargetComponent* tc);
+		SlotHandle AddTargetComponent(class TargetComponent* tc);
+		void RemoveTargetComponent(SlotHandle handle);
 	protected:
 		void UpdateCrosshair(float deltaTime);
 		void UpdateRadar(float deltaTime);
@@ -28,7 +29,7 @@ namespace Engine
 		class Texture* m_RadarArrow;
 
 		// All the target components in the game
-		std::vector<class TargetComponent*> m_TargetComps;
+		SlotMap<class TargetComponent*> m_TargetComps;
 		// 2D offsets of blips relative to radar
 		std::vector<Vector2> m_Blips;
 		// Adjust range of radar and radius
@@ -1,6 +1,6 @@
 #include "UIScreen.h"
 #include "Texture.h"
-#include "Shader.h"
+#include "RenderQueue.h"
 #include "Game.h"
 #include "Renderer.h"
 #include "Font.h"
@@ -43,26 +43,26 @@ namespace Engine
 
 	}
 
-	void UIScreen::Draw(Shader* shader)
+	void UIScreen::Draw(RenderQueue* queue)
 	{
 		// Draw background (if exists)
 		if (m_Background)
 		{
-			DrawTexture(shader, m_Background, m_BGPos);
+			DrawTexture(queue, m_Background, m_BGPos);
 		}
 		// Draw title (if exists)
 		if (m_Title)
 		{
-			DrawTexture(shader, m_Title, m_TitlePos);
+			DrawTexture(queue, m_Title, m_TitlePos);
 		}
 		// Draw buttons
 		for (auto b : m_Buttons)
 		{
 			// Draw background of button
 			Texture* tex = b->GetHighlighted() ? m_ButtonOn : m_ButtonOff;
-			DrawTexture(shader, tex, b->GetPosition());
+			DrawTexture(queue, tex, b->GetPosition());
 			// Draw text of button
-			DrawTexture(shader, b->GetNameTex(), b->GetPosition());
+			DrawTexture(queue, b->GetNameTex(), b->GetPosition());
 		}
 		// Override in subclasses to draw any textures
 	}
@@ -148,7 +148,7 @@ namespace Engine
 		m_NextButtonPos.y -= m_ButtonOff->GetHeight() + 20.0f;
 	}
 
-	void UIScreen::DrawTexture(class Shader* shader, class Texture* texture,
+	void UIScreen::DrawTexture(class RenderQueue* queue, class Texture* texture,
 		const Vector2& offset, float scale)
 	{
 		// Scale the quad by the width/height of texture
@@ -159,13 +159,9 @@ namespace Engine
 		// Translate to position on screen
 		Matrix4 transMat = Matrix4::CreateTranslation(
 			Vector3(offset.x, offset.y, 0.0f));
-		// Set world transform
+		// Queue the quad
 		Matrix4 world = scaleMat * transMat;
-		shader->SetMatrixUniform("uWorldTransform", world);
-		// Set current texture
-		texture->SetActive();
-		// Draw quad
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+		queue->AddQuad(RenderQueue::EUI, texture, world);
 	}
 
 	void UIScreen::SetRelativeMouseMode(bool relative)
@@ -45,7 +45,7 @@ namespace Engine
 		virtual ~UIScreen();
 		// UIScreen subclasses can override these
 		virtual void Update(float deltaTime);
-		virtual void Draw(class Shader* shader);
+		virtual void Draw(class RenderQueue* queue);
 		virtual void ProcessInput(const uint8_t* keys);
 		virtual void HandleKeyPress(int key);
 		// Tracks if the UI is active or closing
@@ -66,7 +66,7 @@ namespace Engine
 		void AddButton(const std::string& name, std::function<void()> onClick);
 	protected:
 		// Helper to draw a texture
-		void DrawTexture(class Shader* shader, class Texture* texture,
+		void DrawTexture(class RenderQueue* queue, class Texture* texture,
 			const Vector2& offset = Vector2::Zero,
 			float scale = 1.0f);
 		// Sets the mouse mode to relative or not